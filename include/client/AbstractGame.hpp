@@ -48,6 +48,10 @@ class AbstractGame
 		unsigned _selfHealth, _oppoHealth;
 		unsigned _selfEnergy;
 
+		/// Given to the server with GAME_RECONNECT to play the game again
+		/// after a network failure
+		SessionToken _sessionToken{0};
+
 		// allow to update these values without interfering during a turn
 		std::mutex _accessHealth;
 		std::mutex _accessEnergy;
@@ -105,22 +109,32 @@ class AbstractGame
 		//virtual int askSelfGraveyardIndex() = 0;
 		//virtual int askOppoHandIndex() = 0;
 
+		/// Receives the turn informations that start the game, and its
+		/// resumption after a reconnection
+		void receiveGameStarting();
+
 		/// Start the new thread waiting for special data
 		void initListening();
 		/// Called by the game listening thread: waits for server game thread special data
 		void inputListening();
 
+		/// Called by the game listening thread when the connection to the
+		/// game is lost: asks the server to play the game again, and receives
+		/// its whole state
+		/// \return False if the game can not be played again
+		bool reconnect();
+
 		/// Handles the whole transmission until transmission.endOfPacket()
 		void handlePacket(sf::Packet& transmission);
 
 		virtual void receiveCard(CardId id) = 0;
 
 		/// The function used to receive from the server the informations
-		/// about the required additional inputs
-		/// \param actionPacket The packet containing the informations to ask
-		/// \return True if card is playable (after having sent the
-		/// asked inputs) and false otherwise
-		bool treatAdditionnalInputs(sf::Packet& actionPacket);
+		/// about the required additional inputs, and to send them all at
+		/// once, after a GAME_SELECT_CARDS header
+		/// \param actionPacket The packet containing the informations to ask,
+		/// after its GAME_SELECT_CARDS header
+		void treatAdditionnalInputs(sf::Packet& actionPacket);
 
 		///
 		bool handleHeader(TransferType header);
@@ -8,8 +8,10 @@
 // std-C++ headers
 #include <string>
 #include <vector>
+#include <unordered_set>
 #include <thread>
 #include <atomic>
+#include <mutex>
 // WizardPoker headers
 #include "common/Terminal.hpp"
 #include "common/Database.hpp"  // FriendsList typedef
@@ -17,6 +19,7 @@
 #include "client/ClientAchievement.hpp"
 #include "common/CardsCollection.hpp"
 #include "common/Deck.hpp"
+#include "common/Identifiers.hpp"  // SessionToken
 #include "client/ClientDatabase.hpp"
 
 /// Client is a class representing the state of the client program (not the user!)
@@ -71,7 +74,9 @@ public:
 	/// \throw NotConnectedException if connectToServer has not been called before
 	const FriendsList& getFriends();
 
-	/// The function used to get a list of the user's friends who are connected
+	/// The function used to get a list of the user's friends who are connected.
+	/// The presence of the friends is pushed by the server, so this does not
+	/// need to ask the server for each friend.
 	/// \return A vector of names representing all of the connected friends
 	/// \throw NotConnectedException if connectedToServer has not been called before
 	FriendsList getConnectedFriends();
@@ -124,6 +129,16 @@ public:
 	/// internal status
 	void endGame();
 
+	/// Asks the server to play the game again after its connection was lost
+	/// (see TransferType::GAME_RECONNECT). The game connects to the client
+	/// again as when it started, the game sockets are then replaced.
+	/// The server is asked again while it can not be reached, for a while.
+	/// \param token The session token of the player, given by the game
+	/// \return True if the game sockets are connected again, false if the
+	/// game refused or did not connect in time
+	/// \throw std::runtime_error if the method is called and no game has started
+	bool reconnectToGame(SessionToken token);
+
 	/// The function used to rest assured all conections are stopped and the client is
 	/// not waiting for entering chat connections anymore
 	void quit();
@@ -191,6 +206,17 @@ private:
 	sf::Uint16 _serverPort;
 	/// Used to communicate with the listening thread to tell it to stop
 	std::atomic_bool _threadLoop;
+	/// Sends the heartbeats to the server
+	std::thread _heartbeatThread;
+	/// Used to tell the heartbeat thread to stop
+	std::atomic_bool _heartbeatLoop;
+	/// Period of the heartbeats, given by the server at connection
+	sf::Time _heartbeatInterval;
+	/// Given by the server at connection, identifies the other connections
+	/// of the client (see TransferType::GAME_SPECTATE)
+	SessionToken _sessionToken;
+	/// Avoids that the heartbeat thread and the main thread send at the same time
+	std::mutex _sendAccess;
 
 	///////// General management attributes
 
@@ -207,6 +233,8 @@ private:
 	FriendsList _friends;
 	/// List containing the names of the users that sent a friendship request to the client
 	FriendsList _friendshipRequests;
+	/// Names of the friends that are connected, kept up to date by the server notifications
+	std::unordered_set<std::string> _presentFriends;
 
 	//////// Game related attributes
 
@@ -234,6 +262,26 @@ private:
 	/// \param transmission A packet containing the informations about the port/address of friend
 	void initInGameConnection(sf::Packet& transmission);
 
+	/// Sends a packet to the server on the main socket
+	/// \return The status of the socket
+	sf::Socket::Status sendToServer(sf::Packet& packet);
+
+	/// Function used by the heartbeat thread: tells periodically the server
+	/// that the client is still alive, even if the user does nothing
+	void sendHeartbeats();
+
+	/// Receives the next answer of the server on the main socket. The
+	/// notifications pushed by the server (which are not answers to a request)
+	/// are handled on the fly and skipped.
+	/// \param packet The packet where the answer is stored
+	/// \return The status of the socket
+	sf::Socket::Status receiveFromServer(sf::Packet& packet);
+
+	/// Handles a notification pushed by the server if \a packet is one
+	/// \return True if the packet was a notification (so it is not an answer
+	/// to a request), false otherwise
+	bool handleServerNotification(const sf::Packet& packet);
+
 	/// Used to know if a particular player is a friend or not
 	/// \return True if the player is a friend of the client and false otherwise
 	/// \param name The name of the player whose friendship is tested
@@ -9,10 +9,16 @@
 
 /// Hold the state an actual card
 /// Should be pure abstract but destructor is needed so I havent method where put =0
+/// The id and the type of the card are copied from its prototype when it is
+/// created, so that reading them does not go through the prototype (and its
+/// virtual methods): the type of a card tells what the card is, rather than
+/// a dynamic_cast.
 class Card
 {
 protected:
 	const CommonCardData& _prototype;
+	const CardId _id;
+	const bool _isCreature;
 	int _cost;
 
 public:
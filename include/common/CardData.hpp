@@ -4,6 +4,8 @@
 #include <vector>
 #include <sstream>
 #include <memory>
+#include <initializer_list>
+#include <array>
 #include "common/Identifiers.hpp" // CardId, DeckId...
 #include "common/CardData.inc"
 
@@ -23,27 +25,46 @@ typedef std::vector<int> EffectParamsCollection;
 /// 	followed by VALUE, TURNS (or UNLIMITED_TURNS), CONSTRAINT CONDITIONS
 /// if effect is something else:
 /// 	ALL ARGUMENTS (no more than 4)
+/// The parameters of a collection are not copied: the arguments are a view
+/// of the collection, which must outlive them. The few values of an explicit
+/// list are stored in the arguments. The arguments are thus cheap to copy,
+/// and a copy reads the parameters from where the original was.
 class EffectArgs
 {
 private:
-	const EffectParamsCollection _args;  ///< collection that defines the effect
-	std::size_t _index;                  ///< index indicating where values should be read
+	static constexpr std::size_t _maxListSize{4};
+	std::array<int, _maxListSize> _list;  ///< values of an explicit list
+	const int* _args;    ///< collection that defines the effect, null for an explicit list
+	std::size_t _size;   ///< number of values of the collection
+	std::size_t _index;  ///< index indicating where values should be read
 public:
 	/// Constructor
-	/// \param effect a collection of effect parameters to copy
-	EffectArgs(const EffectParamsCollection& effect);
+	/// \param effect a collection of effect parameters to read, it must
+	/// outlive the EffectArgs since its values are not copied
+	explicit EffectArgs(const EffectParamsCollection& effect);
+
+	/// A temporary collection would be destroyed before its values are read
+	EffectArgs(EffectParamsCollection&&) = delete;
+
+	/// Constructor
+	/// \param effect The first parameter of the effect
+	/// \param size The number of parameters of the effect
+	EffectArgs(const int* effect, std::size_t size);
 
 	/// Constructor
-	/// \param effect An explicit list of values describing the effect
-	EffectArgs(const std::initializer_list<int>& effect);
+	/// \param effect An explicit list of values describing the effect, no
+	/// more than 4 values
+	EffectArgs(std::initializer_list<int> effect);
 
 	/// This function is used to get the first not used argument
 	/// \return The current parameter
+	/// \throw std::out_of_range if all the parameters have been used
 	int getArg();
 
 	/// This function is used to check the first not used argument but
 	/// to not signal to pass to the next one
 	/// \return The current parameter
+	/// \throw std::out_of_range if all the parameters have been used
 	int peekArg() const;
 
 	/// This function is used to know how many parameters haven't been used yet
@@ -9,6 +9,7 @@
 #include <array>
 #include <utility> // std::pair
 #include <mutex>
+#include <chrono>
 
 // SQLite headers
 #include <sqlite3.h>
@@ -54,10 +55,18 @@ public:
 	/// Destructor
 	virtual ~Database();
 
+	/// \return The time the calling thread has spent executing statements
+	/// with step, since its start
+	static std::chrono::nanoseconds getStepTime();
+
 protected:
 	/// To get valid sqlite3_stmt
 	void prepareStmt(Statement&);
 
+	/// sqlite3_step, whose duration is added to the time of the calling thread
+	/// (see getStepTime)
+	static int step(sqlite3_stmt* statement);
+
 	/// Throw exception if errcode is actually an error code
 	static int sqliteThrowExcept(int errcode);
 
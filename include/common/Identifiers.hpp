@@ -19,4 +19,10 @@ typedef sf::Int64 UserId;
 /// database, and is used by the class Client to identify an achievement.
 typedef sf::Int64 AchievementId;
 
+/// The secret given to a player at the beginning of a game, so that its
+/// client can connect to the game again after a network failure, and to a
+/// user when he connects to the server, so that his other connections can
+/// be told from the ones of someone using his name.
+typedef sf::Uint64 SessionToken;
+
 #endif  // _IDENTIFIERS_COMMON_HPP
@@ -1,27 +1,49 @@
 #ifndef _RANDOM_INTEGER_HPP_
 #define _RANDOM_INTEGER_HPP_
 
-#include <random>
+#include <array>
+#include <cstdint>
 
 /// RandomInteger is a class used to generate integers in a certain
-/// range. It uses C++-11 <random> header. The reason it is here is to factorize the
-/// random integer generation code
+/// range. The reason it is here is to factorize the random integer
+/// generation code.
+/// It uses xoshiro128** (Blackman and Vigna) rather than std::mt19937: its
+/// state holds in 16 bytes, so a generator is cheap to create and to copy
+/// (e.g. in each GameSnapshot). The integers are drawn without the
+/// distributions of <random>, whose results depend on the standard library:
+/// the sequence given by a seed is the same on every platform.
 class RandomInteger
 {
 public:
-	/// Constructor
+	/// Type of the values the generator can be initialized with
+	typedef std::uint32_t Seed;
+
+	/// Constructor, the generator is initialized with a random seed
 	RandomInteger();
 
+	/// Constructor, two generators constructed with the same seed give the
+	/// same sequence of integers (used to replay a game)
+	explicit RandomInteger(Seed seed);
+
 	/// generates an integer in [lowerBound, upperBound)
 	/// \param upperBound The first integer that can not be generated
 	/// \param lowerBound The first integer that can be generated
 	/// \return A value in {lowerBound, lowerBound+1, ..., uppBound-2, upperBound-1}
+	/// \pre lowerBound < upperBound
 	int next(int upperBound, int lowerBound=0);
 
+	/// \return The seed the generator was initialized with
+	Seed getSeed() const;
+
+	/// Initializes again the generator, the sequence restarts from the beginning
+	void setSeed(Seed seed);
+
 private:
+	Seed _seed;                            ///< Kept to be able to reproduce the sequence
+	std::array<std::uint32_t, 4> _state;   ///< State of xoshiro128**
 
-	std::random_device _device;   ///< Used to init the generator
-	std::mt19937 _generator;   ///< used as seed in the generation
+	/// \return The next 32 random bits of the sequence
+	std::uint32_t nextBits();
 };
 
 #endif  // _RANDOM_INTEGER_HPP_
@@ -18,7 +18,9 @@ enum class TransferType : sf::Uint32
 
 	/////////////// Connection && registration to server
 
-	/// Used when the user authenticates to the server
+	/// Used when the user authenticates to the server, the server answers
+	/// ACKNOWLEDGE with the interval of the heartbeats and the session token
+	/// of the connection
 	CONNECTION,
 
 	/// Used when the user tried to authenticates but gives wrong identifiers
@@ -39,6 +41,9 @@ enum class TransferType : sf::Uint32
 	/// Used when the client quits to tell the server it disconnects
 	DISCONNECTION,
 
+	/// Sent periodically by the client to tell the server that it is still alive
+	HEARTBEAT,
+
 	/////////////// Game
 
 	/// Used when a player asks to find an opponent
@@ -98,13 +103,39 @@ enum class TransferType : sf::Uint32
 	/// Used when sending to the client its deck size
 	GAME_DECK_UPDATED,
 
+	// The values below were added later, at the end of the section so that
+	// the previous ones keep their values on the network
+
+	/// Used when a client asks to watch the game of a player, as the first
+	/// packet of a new connection on which the states of the game are sent.
+	/// The name of the spectator, the session token of its connection to
+	/// the lobby (see CONNECTION) and the name of the player follow.
+	GAME_SPECTATE,
+
+	/// Used when a client whose connection to its game failed asks to play
+	/// the game again, as the first packet of a new connection. The session
+	/// token of the player and the listening port of the client follow, the
+	/// game connects to the client as NEW_GAME_SERVER_CONNECTION does.
+	GAME_RECONNECT,
+
+	/// Used when the server gives to the client the session token of the
+	/// player (see GAME_RECONNECT)
+	GAME_SESSION_TOKEN,
+
+	/// Used when sending to a spectator the public state of the game, which
+	/// replaces the previous ones
+	GAME_STATE,
+
 	/////////////// In-game player actions (client->server)
 
 	/// Used when the user want to use a card in a game
 	GAME_USE_CARD,
 
-	/// Used when the server wants to send to the player how many inputs requests he'll receive
-	GAME_SEND_NB_OF_EFFECTS,
+	/// Used when the server asks the player to choose the targets of all the
+	/// effects of the card he uses, at once (not sent if there is nothing to choose),
+	/// and when the client answers, so that an answer that arrives after the
+	/// end of the turn is not taken for an action
+	GAME_SELECT_CARDS,
 
 	/// Used when the user wants to attack with one of its creatures
 	GAME_ATTACK_WITH_CREATURE,
@@ -117,6 +148,9 @@ enum class TransferType : sf::Uint32
 	/// Used when a client checks if another client is connected
 	CHECK_PRESENCE,
 
+	/// Used when the server pushes to a client that one of its friends connected or disconnected
+	FRIEND_PRESENCE_UPDATE,
+
 	/// Used when a client asks the list of his friends
 	ASK_FRIENDS,
 
@@ -0,0 +1,78 @@
+#ifndef _BALANCE_SIMULATOR_SERVER_HPP_
+#define _BALANCE_SIMULATOR_SERVER_HPP_
+
+// std-C++ headers
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+// WizardPoker headers
+#include "server/ServerDatabase.hpp"
+#include "common/random/RandomInteger.hpp"
+#include "common/Identifiers.hpp"  // CardId
+#include "common/Deck.hpp"
+
+/// Results of a card over a batch of games
+struct CardBalance
+{
+	CardId card;
+	std::uint64_t decks;  ///< Number of decks that contained the card (once or twice)
+	std::uint64_t wins;   ///< Number of these decks that won their game
+};
+
+/// Results of a batch of simulated games
+struct BalanceReport
+{
+	std::uint64_t gamesCount;
+	std::uint64_t draws;                     ///< Games without winner (see GameSimulation::maxTurns)
+	std::uint64_t errors;                    ///< Games interrupted by an error of the rules, not counted elsewhere
+	std::vector<std::uint64_t> gameLengths;  ///< Number of games by number of turns (of both players)
+	std::vector<CardBalance> cards;          ///< Sorted by card id
+
+	/// Adds the results of \a other, which has the same cards
+	void merge(const BalanceReport& other);
+};
+
+/// Plays batches of games between random decks and random policies (see
+/// GameSimulation), to evaluate the balance of the cards.
+/// The game i of a batch depends only on the seed of the simulator and on
+/// i: a batch gives the same report whatever the number of threads.
+class BalanceSimulator
+{
+public:
+	/// Constructor
+	/// \param database The cards are read from it, it is not modified
+	/// \param seed Seed of the batches
+	/// \throw std::runtime_error if there are not enough cards to build a deck
+	BalanceSimulator(ServerDatabase& database, std::uint64_t seed);
+
+	/// Plays the games [0, gamesCount) of the batch. The games are split
+	/// between the threads, an idle thread steals the half of the remaining
+	/// games of another one.
+	/// \param gamesCount Number of games to play
+	/// \param threadsCount Number of threads, at least 1
+	/// \return The results of all the games
+	BalanceReport run(std::size_t gamesCount, unsigned threadsCount);
+
+	/// Plays the game \a gameIndex of the batch and adds its results to \a report.
+	/// An error of the rules is printed and counted in \a report.
+	void playGame(std::size_t gameIndex, BalanceReport& report);
+
+	/// \return A report without any game, with the cards of the database
+	BalanceReport makeEmptyReport() const;
+
+private:
+	/// Maximum number of copies of a card in a deck
+	static constexpr std::size_t _maxCopies{2};
+
+	ServerDatabase& _database;
+	const std::uint64_t _seed;
+	std::vector<CardId> _cardIds;  ///< Sorted
+
+	/// \return A deck of random cards, at most _maxCopies times each
+	Deck sampleDeck(RandomInteger& generator) const;
+
+	/// Adds the result of \a deck to \a report
+	void addDeck(const Deck& deck, bool hasWon, BalanceReport& report) const;
+};
+
+#endif  // _BALANCE_SIMULATOR_SERVER_HPP_
@@ -0,0 +1,77 @@
+#ifndef _BOT_CONTROLLER_SERVER_HPP_
+#define _BOT_CONTROLLER_SERVER_HPP_
+
+// std-C++ headers
+#include <string>
+#include <memory>
+#include <chrono>
+// WizardPoker headers
+#include "server/PlayerController.hpp"
+#include "server/GamePolicy.hpp"
+#include "server/GameJournal.hpp"
+#include "server/GameSnapshot.hpp"
+#include "server/BotPool.hpp"
+#include "server/ServerDatabase.hpp"
+#include "common/random/RandomInteger.hpp"
+#include "common/Identifiers.hpp"  // UserId
+
+class Player;
+
+/// Controller of a player of a GameThread that is played by the server
+/// itself, in place of a client. The actions are chosen by searches (see
+/// BotSearch) run on the threads of a BotPool: the game thread starts a
+/// search and polls its result at each tick, so it never waits for the bot.
+/// The searches start from the records of the game (see
+/// GameJournal::keepRecords).
+class BotController final : public PlayerController
+{
+public:
+	/// Id of the bots in the games, no user of the database has a negative id
+	static constexpr UserId botId{-1};
+
+	/// Name of the bots, given to their opponents
+	static const std::string botName;
+
+	/// Constructor
+	/// \param pool The threads that run the searches
+	/// \param database The cards of the game are read from it
+	/// \param moveBudget The time given to the search of each action
+	/// \param self The player played by the bot
+	/// \param opponent The other player
+	BotController(BotPool& pool, ServerDatabase& database, std::chrono::milliseconds moveBudget,
+			const Player& self, const Player& opponent);
+
+	/// Tells that the game has been resumed from \a snapshot, the records of
+	/// its journal follow this state (see GameThread::resume)
+	void setStartingState(const GameSnapshot& snapshot);
+
+	/// Nobody reads the results of the actions
+	void send(sf::Packet& packet) override;
+
+	/// Chooses the targets at random, immediately
+	bool selectCards(const std::vector<CardToSelect>& selection, std::vector<int>& indices) override;
+
+	/// Called at each tick of the game while the bot is the active player:
+	/// starts the search of the next action if none is running, or gives
+	/// the result of the running one.
+	/// \param journal The journal of the game, which keeps its records
+	/// \param action Set to the next action of the bot if the search is over
+	/// \return True if \a action has been set
+	bool pollAction(const GameJournal& journal, PlayerAction& action);
+
+	/// Destructor, cancels the running search
+	~BotController();
+
+private:
+	BotPool& _pool;
+	ServerDatabase& _database;
+	const std::chrono::milliseconds _moveBudget;
+	const Player& _self;
+	const Player& _opponent;
+	RandomInteger _generator;      ///< Seeds of the searches, and of the selections
+	RandomPolicy _selectionPolicy;
+	std::shared_ptr<BotSearch> _search;  ///< Null if no search is running
+	std::shared_ptr<const GameSnapshot> _start;  ///< Null if the game has not been resumed
+};
+
+#endif  // _BOT_CONTROLLER_SERVER_HPP_
@@ -0,0 +1,54 @@
+#ifndef _BOT_POOL_SERVER_HPP_
+#define _BOT_POOL_SERVER_HPP_
+
+// std-C++ headers
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+// WizardPoker headers
+#include "server/BotSearch.hpp"
+
+/// Threads shared by all the bots of the server to run their searches (see
+/// BotSearch): the number of threads bounds the CPU used by the bots,
+/// whatever the number of bot games. The searches are run in the order they
+/// are submitted, and the game threads never wait for them (see BotController).
+/// The number of waiting searches is bounded: when the pool can not keep up
+/// with the bots, the new searches are shed and their bots end their turn.
+/// On Linux, the threads have a lower priority than the game threads, so that
+/// the bots do not slow down the games between clients.
+class BotPool
+{
+public:
+	/// Niceness of the threads of the pool (see setpriority)
+	static constexpr int niceness{10};
+
+	/// Number of searches that can wait for each thread of the pool
+	static constexpr std::size_t waitingSearchesPerThread{4};
+
+	/// Constructor, starts the threads
+	/// \param threadsCount The number of threads, at least 1
+	explicit BotPool(unsigned threadsCount);
+
+	/// Queues a search, to be run by the first free thread. If too many
+	/// searches are waiting, \a search is shed instead (see BotSearch::shed).
+	void submit(std::shared_ptr<BotSearch> search);
+
+	/// Destructor, the waiting searches are dropped and the threads are joined
+	~BotPool();
+
+private:
+	std::vector<std::thread> _threads;
+	std::deque<std::shared_ptr<BotSearch>> _waitingSearches;
+	std::mutex _waitingSearchesMutex;
+	std::condition_variable _searchSubmitted;
+	bool _stopping;
+
+	/// Main loop of the threads
+	void work();
+};
+
+#endif  // _BOT_POOL_SERVER_HPP_
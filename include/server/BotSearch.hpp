@@ -0,0 +1,126 @@
+#ifndef _BOT_SEARCH_SERVER_HPP_
+#define _BOT_SEARCH_SERVER_HPP_
+
+// std-C++ headers
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+// WizardPoker headers
+#include "server/PlayerController.hpp"
+#include "server/GameJournal.hpp"
+#include "server/GameSnapshot.hpp"
+#include "server/ServerDatabase.hpp"
+#include "common/random/RandomInteger.hpp"
+#include "common/Identifiers.hpp"  // UserId
+
+// Forward declarations
+class GameSimulation;
+
+/// Search of the next action of a bot, run by a BotPool.
+/// The game is set up again in a GameSimulation from its records and saved
+/// in a snapshot, then each action the bot can play is evaluated by playouts
+/// from copies of the snapshot: the action is played, then the game is played
+/// to its end by random policies, with new random draws. The bot does not
+/// know the hand of its opponent nor the order of the decks, each playout
+/// deals them again at random from the cards of their players (see
+/// determinize). The actions to
+/// evaluate are chosen with UCB1, and the most evaluated one is chosen when
+/// the time budget is spent.
+/// The time budget counts from the creation of the search, the time spent
+/// waiting for a thread of the pool included: a search that waited for its
+/// whole budget ends the turn of the bot without being run, so that the
+/// searches of a busy pool do not pile up.
+/// The search is given its own copy of the game, it does not share any data
+/// with the game thread but the cancellation flag and the result.
+class BotSearch
+{
+public:
+	/// Exploration constant of UCB1
+	static constexpr double exploration{1.4};
+
+	/// Maximum number of playouts of a search, reached only by the searches
+	/// whose game is almost over
+	static constexpr std::size_t maxPlayouts{100000};
+
+	/// Constructor
+	/// \param database The cards of the game are read from it
+	/// \param header The header of the game
+	/// \param records The records of the game so far
+	/// \param botId The id of the bot in the game, the active player
+	/// \param budget The time given to the search from now on
+	/// \param seed Seed of the playouts
+	/// \param start The state \a records follow if the game has been resumed
+	/// (see GameCheckpoints), null if they start from the beginning of the game
+	BotSearch(ServerDatabase& database, const JournalHeader& header, const std::vector<JournalRecord>& records,
+			UserId botId, std::chrono::milliseconds budget, RandomInteger::Seed seed,
+			std::shared_ptr<const GameSnapshot> start=nullptr);
+
+	/// Runs the search until the budget is spent or the search is cancelled.
+	/// The action ending the turn is chosen if the game can not be set up or
+	/// if the budget was spent before the search started.
+	void run();
+
+	/// Ends the search without running it, the action ending the turn is
+	/// chosen (see BotPool::submit)
+	void shed();
+
+	/// Asks the search to stop as soon as possible, its result will be ignored
+	void cancel();
+
+	/// \return True if cancel has been called
+	bool isCancelled() const;
+
+	/// \return True if the search is over, the result can be read
+	bool isDone() const;
+
+	/// \return The chosen action
+	/// \pre isDone()
+	const PlayerAction& getAction() const;
+
+	/// \return The number of records the search started from
+	std::size_t getRecordsCount() const;
+
+private:
+	/// Statistics of one of the actions of the bot
+	struct Candidate
+	{
+		PlayerAction action;
+		std::size_t playouts;
+		double score;  ///< Sum of the results of the playouts: 1 for a win, 0.5 for a draw
+	};
+
+	ServerDatabase& _database;
+	const JournalHeader _header;
+	const std::vector<JournalRecord> _records;
+	const std::shared_ptr<const GameSnapshot> _start;  ///< Shared by the searches of a resumed game
+	const UserId _botId;
+	const std::chrono::steady_clock::time_point _deadline;
+	RandomInteger _generator;
+	std::vector<Candidate> _candidates;
+	GameSnapshot _snapshot;  ///< The game when the search started
+	PlayerAction _action;
+	std::atomic_bool _cancelled;
+	std::atomic_bool _done;
+
+	/// Sets the game up in _snapshot, and lists the actions of the bot in _candidates
+	void listCandidates();
+
+	/// \return The index of the candidate to evaluate, with UCB1
+	std::size_t chooseCandidate(std::size_t playoutsCount) const;
+
+	/// Shuffles the cards hidden from the bot in \a snapshot: the deck of the
+	/// bot, and the deck and the hand of its opponent together. The cards
+	/// referenced by an index (as a caster or the last used card) keep their
+	/// place, so that the indices stay valid.
+	void determinize(GameSnapshot& snapshot);
+
+	/// Plays the candidate \a index then the rest of the game
+	/// \param game Loaded again from _snapshot, the same game is given to all
+	/// the playouts so that its cards are restored in place
+	/// \return The result for the bot: 1 for a win, 0.5 for a draw, 0 for a defeat
+	double playout(std::size_t index, GameSimulation& game);
+};
+
+#endif  // _BOT_SEARCH_SERVER_HPP_
@@ -0,0 +1,120 @@
+#ifndef _CARD_ARENA_SERVER_HPP_
+#define _CARD_ARENA_SERVER_HPP_
+
+// std-C++ headers
+#include <vector>
+#include <array>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+// WizardPoker headers
+#include "common/Card.hpp"
+
+// Forward declarations
+class Creature;
+class Spell;
+class ServerCreatureData;
+class ServerSpellData;
+class Player;
+
+/// What the game reads the most of a card, copied from its template
+struct CardTag
+{
+	CardId id;        ///< The template of the card in the database
+	int cost;         ///< The energy cost of the card
+	bool isCreature;  ///< The type of the card, a spell if false
+};
+
+/// The statistics of a creature, which change during the game
+struct CreatureStats
+{
+	int attack;
+	int health;
+	int shield;
+	int shieldType;
+};
+
+/// Storage of the cards of a game, shared by both players. The cards are
+/// created in blocks of slots allocated at once, rather than one by one, and
+/// are all destroyed with the arena (or by clear). A card is designated by
+/// its index in the arena, which is the order of its creation: the zones of
+/// the players store these indices (see CardZone). A slot is large enough
+/// for any card, with its constraints stored inline (see Constraints).
+///
+/// The tag of each card and the statistics of each creature are also
+/// stored in arrays indexed by the cards indices, contiguous, so that the
+/// zones can be scanned (to list the playable cards or to log a board)
+/// without reading the cards. A creature reads and writes its statistics
+/// in the array.
+class CardArena
+{
+public:
+	/// Index of a card in the arena
+	typedef std::uint8_t Index;
+
+	/// The maximum number of cards of an arena, one per Index
+	static constexpr std::size_t capacity{std::numeric_limits<Index>::max() + std::size_t{1}};
+
+	/// Constructor, allocates the first block
+	/// \param cardsCount The number of slots of each block
+	explicit CardArena(std::size_t cardsCount);
+
+	CardArena(const CardArena&) = delete;
+	CardArena& operator=(const CardArena&) = delete;
+
+	/// Creates a creature in the next free slot
+	/// \param data The template of the creature
+	/// \param owner The player whose card it is
+	/// \return The created creature, owned by the arena
+	/// \throw std::length_error if the arena is full (see capacity)
+	Creature* createCreature(const ServerCreatureData& data, Player& owner);
+
+	/// Creates a spell in the next free slot
+	/// \param data The template of the spell
+	/// \return The created spell, owned by the arena
+	/// \throw std::length_error if the arena is full (see capacity)
+	Spell* createSpell(const ServerSpellData& data);
+
+	/// Destroys all the cards, the blocks are kept for the next ones
+	void clear();
+
+	/// \return The number of cards created since the last clear
+	std::size_t getCardsCount() const;
+
+	/// \return The cards created since the last clear, in their creation order
+	const std::vector<Card*>& getCards() const;
+
+	/// \return The card of index \a index
+	Card* getCard(Index index) const;
+
+	/// \return The index of \a card
+	/// \throw std::invalid_argument if \a card is not a card of the arena
+	Index getIndex(const Card* card) const;
+
+	/// \return The tag of the card of index \a index
+	const CardTag& getTag(Index index) const;
+
+	/// \return The statistics of the creature of index \a index
+	/// \pre The card \a index is a creature
+	const CreatureStats& getStats(Index index) const;
+
+	/// Destructor, destroys all the cards
+	~CardArena();
+
+private:
+	typedef std::unique_ptr<unsigned char[]> Block;
+
+	const std::size_t _blockSize;  ///< Number of slots of a block
+	std::vector<Block> _blocks;
+	std::vector<Card*> _cards;     ///< The created cards, in their creation order (their indices)
+	std::array<CardTag, capacity> _tags;         ///< The tags of the created cards
+	std::array<CreatureStats, capacity> _stats;  ///< The statistics of the created creatures
+
+	/// \return A free slot of \a size bytes, a new block is allocated if all
+	/// the slots are used
+	/// \throw std::length_error if the arena is full
+	void* allocate(std::size_t size);
+};
+
+#endif  // _CARD_ARENA_SERVER_HPP_
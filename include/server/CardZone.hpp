@@ -0,0 +1,348 @@
+#ifndef _CARD_ZONE_SERVER_HPP_
+#define _CARD_ZONE_SERVER_HPP_
+
+// std-C++ headers
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <cassert>
+// WizardPoker headers
+#include "server/CardArena.hpp"
+
+/// Zone of the cards of a player (deck, hand, board or graveyard), with the
+/// interface of the std::vector it replaces. A zone stores the indices of
+/// its cards in the arena of the game (one byte per card), inline: the cards
+/// of a game are known, so a zone can be given the capacity of all the cards
+/// it may ever hold and never allocates. The cards are read by value (the
+/// zone holds no pointer to them), and replaced by set. The tags and the
+/// statistics of the cards can be read without reading the cards (see
+/// CardArena).
+/// \tparam CardType The type of the cards, the zone only refers to them
+/// (they are owned by the CardArena)
+/// \tparam Capacity The maximum number of cards in the zone
+template <typename CardType, std::size_t Capacity>
+class CardZone
+{
+public:
+	typedef std::size_t size_type;
+
+	/// Iterator on the cards of a zone, in their order
+	class const_iterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef CardType* value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef CardType* const* pointer;
+		typedef CardType* reference;
+
+		const_iterator(const CardZone& zone, size_type position);
+
+		CardType* operator*() const;
+		CardType* operator[](difference_type offset) const;
+		const_iterator& operator++();
+		const_iterator operator++(int);
+		const_iterator& operator--();
+		const_iterator operator--(int);
+		const_iterator& operator+=(difference_type offset);
+		const_iterator& operator-=(difference_type offset);
+		const_iterator operator+(difference_type offset) const;
+		const_iterator operator-(difference_type offset) const;
+		difference_type operator-(const const_iterator& other) const;
+		bool operator==(const const_iterator& other) const;
+		bool operator!=(const const_iterator& other) const;
+		bool operator<(const const_iterator& other) const;
+
+		/// \return The index of the card in its zone
+		size_type getPosition() const;
+
+	private:
+		const CardZone* _zone;
+		size_type _position;
+	};
+
+	typedef const_iterator iterator;
+
+	/// Constructor, the zone is empty
+	/// \param arena The arena of the game, in which the cards are indexed
+	explicit CardZone(const CardArena& arena);
+
+	// Capacity
+	size_type size() const;
+	bool empty() const;
+	static constexpr size_type capacity();
+
+	// Access
+	/// \throw std::out_of_range if \a index is not the index of a card
+	CardType* at(size_type index) const;
+	CardType* operator[](size_type index) const;
+	CardType* back() const;
+	/// \return The tag of the card \a index (see CardArena::getTag)
+	const CardTag& getTag(size_type index) const;
+	/// \return The statistics of the creature \a index (see CardArena::getStats)
+	const CreatureStats& getStats(size_type index) const;
+	const_iterator begin() const;
+	const_iterator end() const;
+
+	// Modifiers
+	/// Replaces the card \a index by \a card
+	void set(size_type index, CardType* card);
+	/// \throw std::length_error if the zone is full
+	void push_back(CardType* card);
+	void pop_back();
+	/// Removes the card \a position, the next ones are moved back
+	/// \return The iterator to the card following the removed one
+	const_iterator erase(const_iterator position);
+	/// Replaces the cards of the zone by the ones of [first, last[
+	/// \throw std::length_error if there are more cards than the capacity,
+	/// the zone is then left empty
+	template <typename InputIterator>
+	void assign(InputIterator first, InputIterator last);
+	void clear();
+
+private:
+	const CardArena* _arena;
+	size_type _size;
+	/// The indices of the cards in _arena, only the first _size are set
+	std::array<CardArena::Index, Capacity> _cards;
+};
+
+template <typename CardType, std::size_t Capacity>
+CardZone<CardType, Capacity>::const_iterator::const_iterator(const CardZone& zone, size_type position):
+	_zone(&zone),
+	_position(position)
+{
+}
+
+template <typename CardType, std::size_t Capacity>
+CardType* CardZone<CardType, Capacity>::const_iterator::operator*() const
+{
+	return (*_zone)[_position];
+}
+
+template <typename CardType, std::size_t Capacity>
+CardType* CardZone<CardType, Capacity>::const_iterator::operator[](difference_type offset) const
+{
+	return *(*this + offset);
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator& CardZone<CardType, Capacity>::const_iterator::operator++()
+{
+	++_position;
+	return *this;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator CardZone<CardType, Capacity>::const_iterator::operator++(int)
+{
+	const const_iterator previous{*this};
+	++_position;
+	return previous;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator& CardZone<CardType, Capacity>::const_iterator::operator--()
+{
+	--_position;
+	return *this;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator CardZone<CardType, Capacity>::const_iterator::operator--(int)
+{
+	const const_iterator previous{*this};
+	--_position;
+	return previous;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator& CardZone<CardType, Capacity>::const_iterator::operator+=(difference_type offset)
+{
+	_position = static_cast<size_type>(static_cast<difference_type>(_position) + offset);
+	return *this;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator& CardZone<CardType, Capacity>::const_iterator::operator-=(difference_type offset)
+{
+	return *this += -offset;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator CardZone<CardType, Capacity>::const_iterator::operator+(difference_type offset) const
+{
+	const_iterator moved{*this};
+	return moved += offset;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator CardZone<CardType, Capacity>::const_iterator::operator-(difference_type offset) const
+{
+	const_iterator moved{*this};
+	return moved -= offset;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator::difference_type
+CardZone<CardType, Capacity>::const_iterator::operator-(const const_iterator& other) const
+{
+	return static_cast<difference_type>(_position) - static_cast<difference_type>(other._position);
+}
+
+template <typename CardType, std::size_t Capacity>
+bool CardZone<CardType, Capacity>::const_iterator::operator==(const const_iterator& other) const
+{
+	return _zone == other._zone and _position == other._position;
+}
+
+template <typename CardType, std::size_t Capacity>
+bool CardZone<CardType, Capacity>::const_iterator::operator!=(const const_iterator& other) const
+{
+	return not (*this == other);
+}
+
+template <typename CardType, std::size_t Capacity>
+bool CardZone<CardType, Capacity>::const_iterator::operator<(const const_iterator& other) const
+{
+	return _position < other._position;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::size_type CardZone<CardType, Capacity>::const_iterator::getPosition() const
+{
+	return _position;
+}
+
+template <typename CardType, std::size_t Capacity>
+CardZone<CardType, Capacity>::CardZone(const CardArena& arena):
+	_arena(&arena),
+	_size(0)
+{
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::size_type CardZone<CardType, Capacity>::size() const
+{
+	return _size;
+}
+
+template <typename CardType, std::size_t Capacity>
+bool CardZone<CardType, Capacity>::empty() const
+{
+	return _size == 0;
+}
+
+template <typename CardType, std::size_t Capacity>
+constexpr typename CardZone<CardType, Capacity>::size_type CardZone<CardType, Capacity>::capacity()
+{
+	return Capacity;
+}
+
+template <typename CardType, std::size_t Capacity>
+CardType* CardZone<CardType, Capacity>::at(size_type index) const
+{
+	if(index >= _size)
+		throw std::out_of_range("CardZone::at: " + std::to_string(index) + " >= " + std::to_string(_size));
+	return (*this)[index];
+}
+
+template <typename CardType, std::size_t Capacity>
+CardType* CardZone<CardType, Capacity>::operator[](size_type index) const
+{
+	assert(index < _size);
+	return static_cast<CardType*>(_arena->getCard(_cards[index]));
+}
+
+template <typename CardType, std::size_t Capacity>
+CardType* CardZone<CardType, Capacity>::back() const
+{
+	assert(_size > 0);
+	return (*this)[_size - 1];
+}
+
+template <typename CardType, std::size_t Capacity>
+const CardTag& CardZone<CardType, Capacity>::getTag(size_type index) const
+{
+	assert(index < _size);
+	return _arena->getTag(_cards[index]);
+}
+
+template <typename CardType, std::size_t Capacity>
+const CreatureStats& CardZone<CardType, Capacity>::getStats(size_type index) const
+{
+	assert(index < _size);
+	return _arena->getStats(_cards[index]);
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator CardZone<CardType, Capacity>::begin() const
+{
+	return const_iterator(*this, 0);
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator CardZone<CardType, Capacity>::end() const
+{
+	return const_iterator(*this, _size);
+}
+
+template <typename CardType, std::size_t Capacity>
+void CardZone<CardType, Capacity>::set(size_type index, CardType* card)
+{
+	assert(index < _size);
+	_cards[index] = _arena->getIndex(card);
+}
+
+template <typename CardType, std::size_t Capacity>
+void CardZone<CardType, Capacity>::push_back(CardType* card)
+{
+	if(_size == Capacity)
+		throw std::length_error("CardZone::push_back: the zone is full (" + std::to_string(Capacity) + " cards)");
+	_cards[_size++] = _arena->getIndex(card);
+}
+
+template <typename CardType, std::size_t Capacity>
+void CardZone<CardType, Capacity>::pop_back()
+{
+	assert(_size > 0);
+	--_size;
+}
+
+template <typename CardType, std::size_t Capacity>
+typename CardZone<CardType, Capacity>::const_iterator CardZone<CardType, Capacity>::erase(const_iterator position)
+{
+	const size_type index{position.getPosition()};
+	assert(index < _size);
+	for(size_type i{index + 1}; i < _size; ++i)
+		_cards[i - 1] = _cards[i];
+	--_size;
+	return const_iterator(*this, index);
+}
+
+template <typename CardType, std::size_t Capacity>
+template <typename InputIterator>
+void CardZone<CardType, Capacity>::assign(InputIterator first, InputIterator last)
+{
+	_size = 0;
+	try
+	{
+		for(; first != last; ++first)
+			push_back(*first);
+	}
+	catch(const std::length_error&)
+	{
+		_size = 0;
+		throw;
+	}
+}
+
+template <typename CardType, std::size_t Capacity>
+void CardZone<CardType, Capacity>::clear()
+{
+	_size = 0;
+}
+
+#endif  // _CARD_ZONE_SERVER_HPP_
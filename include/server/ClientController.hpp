@@ -0,0 +1,37 @@
+#ifndef _CLIENT_CONTROLLER_SERVER_HPP_
+#define _CLIENT_CONTROLLER_SERVER_HPP_
+
+// WizardPoker headers
+#include "server/PlayerController.hpp"
+#include "server/TcpConnection.hpp"
+
+/// Controller of a player that plays with a client connected to the
+/// GameThread: the results are queued in the in-game socket (flushed by the
+/// GameThread at each tick), and the selections are asked to the client without waiting for them.
+class ClientController final : public PlayerController
+{
+public:
+	/// Constructor
+	ClientController();
+
+	/// Queues \a packet in the in-game socket
+	void send(sf::Packet& packet) override;
+
+	/// Queues the request to the client, the answer is read by the
+	/// GameThread with the other inputs of the client
+	/// \return False, the answer always comes later
+	bool selectCards(const std::vector<CardToSelect>& selection, std::vector<int>& indices) override;
+
+	/// Receives a packet that the client must send before the game goes on
+	/// (e.g. its deck), blocking
+	/// \return The status of the socket after the receiving
+	sf::Socket::Status receiveBlocking(sf::Packet& packet);
+
+	/// \return The in-game socket to the client
+	TcpConnection& getSocket();
+
+private:
+	TcpConnection _socketToClient;  ///< Flushed by the GameThread at each tick
+};
+
+#endif  // _CLIENT_CONTROLLER_SERVER_HPP_
@@ -1,13 +1,14 @@
 #ifndef _CLIENT_INFORMATIONS_HPP_
 #define _CLIENT_INFORMATIONS_HPP_
 
-// SFML headers
-#include <SFML/Network/TcpSocket.hpp>
 // std-C++ headers
 #include <vector>
 #include <string>
+#include <memory>
+#include <chrono>
 // WP headers
-#include "common/Identifiers.hpp"  // UserId
+#include "common/Identifiers.hpp"  // UserId, SessionToken
+#include "server/TcpConnection.hpp"
 
 /// structure used inside of the server program to keep informations
 /// on a single client
@@ -17,9 +18,11 @@ struct ClientInformations
 	/// the connection when needed, so that when the ClientInformations instance
 	/// gets deleted, the connection is closed (but a simple instance of socket
 	/// is not sufficient, because we need a dynamic allocation).
-	std::unique_ptr<sf::TcpSocket> socket;
+	std::unique_ptr<TcpConnection> socket;
 	sf::Uint16 listeningPort;  ///< used to send connection for the chat
 	UserId id;
+	SessionToken sessionToken;  ///< asked on the other connections of the client
+	std::chrono::steady_clock::time_point lastActivity;  ///< last time something was received
 };
 
 #endif  // _CLIENT_INFORMATIONS_HPP_
@@ -1,7 +1,13 @@
 #ifndef _CONSTRAINTS_HPP_
 #define _CONSTRAINTS_HPP_
 
+// std-C++ headers
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+// WizardPoker headers
 #include "server/ServerCardData.hpp"
 
 class Creature;
@@ -30,65 +36,213 @@ struct ConstraintDefaultValue
 	ConstraintOrderOption orderOption;
 };
 
-struct ConstraintTimedValue
-{
-	int value;
-	int turns;
-	const Creature* caster;
-};
-
-const std::vector<ConstraintDefaultValue> playerDefaultConstraints =
-{
-	//turn-based constraints
-	{1, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //PC_TURN_CARDS_PICKED
-	{1, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //PC_TURN_ENERGY_INIT_CHANGE
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //PC_TURN_ENERGY_CHANGE
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //PC_TURN_HEALTH_CHANGE
-	{-5, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},          //PC_TURN_HEALTH_CHANGE_DECK_EMPTY
-	//passive constraints
-	{100, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},        //PC_TEMP_CARD_USE_LIMIT
-	{100, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},        //PC_TEMP_SPELL_CALL_LIMIT
-	{100, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},        //PC_TEMP_CREATURE_ATTACK_LIMIT
-	{6, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //PC_TEMP_CREATURE_PLACING_LIMIT
-	{6, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST}           //PC_TEMP_CREATURE_BOARD_LIMIT
-};
+/// Default values of the constraints of a player, indexed by constraint id
+extern const std::vector<ConstraintDefaultValue> playerDefaultConstraints;
 
-const std::vector<ConstraintDefaultValue> creatureDefaultConstraints =
-{
-	//turn-based constraints: all default to 0
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_TURN_ATTACK_CHANGE
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_TURN_HEALTH_CHANGE
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_TURN_SHIELD_CHANGE
-	//passive
-	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_FORCE_ATTACKS
-	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_BLOCK_ATTACKS
-	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_MIRROR_ATTACKS
-	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_BACKFIRE_ATTACKS
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //CC_TEMP_DISABLE_ATTACKS
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //CC_TEMP_IS_PARALYZED
-	//on creature death
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_DEATH_TEAM_HEALTH_GAIN
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_DEATH_TEAM_ATTACK_LOSS
-	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM}            //CC_DEATH_TEAM_SHIELD_LOSS
-};
+/// Default values of the constraints of a creature or of a team, indexed by
+/// constraint id. Defined once, so that Constraints recognizes it by address.
+extern const std::vector<ConstraintDefaultValue> creatureDefaultConstraints;
 
+/// Timed values of the constraints of a player, a creature or a team.
+/// The timed values are stored as a struct of arrays, sorted by constraint
+/// id, so that a lookup reads a few contiguous values. The arrays are inline
+/// (no allocation) up to capacity values, and move to the heap beyond: a
+/// timed value is never dropped.
+/// A timed value is active while its caster is on the board (or if it has no
+/// caster): the flag is the one of the caster, updated by the board changes,
+/// so that it does not have to be computed at each lookup.
+///
+/// The result of a lookup is memoized until its inputs change: each constraint
+/// id has a version, increased when one of its timed values is added, removed
+/// or modified, and the results that depend on casters also keep the version
+/// of the casters of the game (see casterChanged). The constraints with a
+/// VALUE_GET_* option are not memoized, since a lookup modifies them.
 class Constraints
 {
+	/// The greatest amount of constraint ids (players and creatures)
+	static constexpr std::size_t _maxConstraintsCount{std::max<std::size_t>(P_CONSTRAINTS_COUNT, C_CONSTRAINTS_COUNT)};
+
+public:
+	/// Amount of timed values stored inline, and in a Snapshot
+	static constexpr std::size_t capacity{32};
+
+	/// Index of a caster in the table given to save and load
+	typedef std::uint8_t CasterIndex;
+
+	/// Version of the states of the casters of a game (see casterChanged)
+	typedef std::uint64_t CasterVersion;
+
+	/// Index of the timed values without caster
+	static constexpr CasterIndex noCaster{0xFF};
+
+	/// Timed values of a Constraints, without any pointer (see GameSnapshot):
+	/// the casters are given by their index in a table of creatures
+	struct Snapshot
+	{
+		std::array<std::uint8_t, _maxConstraintsCount + 1> offsets;
+		std::array<int, capacity> values;
+		std::array<int, capacity> turns;
+		std::array<CasterIndex, capacity> casters;
+	};
+
+	/// Constructor
+	/// \param casterVersion The version of the casters of the game, shared by
+	/// all the Constraints of the game (see GameContext::getCasterVersion)
+	Constraints(const std::vector<ConstraintDefaultValue>& defaultValues, CasterVersion& casterVersion);
+
+	/// Adds a timed value to the constraint \a constraintId
+	/// \param turns Number of turns the value lasts, 0 for a permanent value
+	/// \throw std::length_error if the constraints hold more values than
+	/// their offsets can index (a game is far from it)
+	void setConstraint(int constraintId, int value, int turns, const Creature* caster=nullptr);
+	int getConstraint(int constraintId) const;
+	int getOverallConstraint(int constraintId, int otherValue) const;
+	void timeOutConstraints();
+
+	/// Invalidates the memoized results of the game that depend on a caster.
+	/// Must be called when a creature enters or leaves the board, since a timed
+	/// value is active according to the state of its caster. The changes of
+	/// CC_TEMP_IS_PARALYZED call it by themselves.
+	void casterChanged();
+
+	/// \return True if \a snapshot can be loaded in a Constraints of
+	/// \a defaultValues: its offsets are sorted and within the capacity, and
+	/// its casters are noCaster or lower than \a castersCount
+	static bool isValid(const Snapshot& snapshot, const std::vector<ConstraintDefaultValue>& defaultValues,
+			std::size_t castersCount);
+
+	/// Saves the timed values in \a snapshot
+	/// \param casters The creatures that can be casters, indexed by CasterIndex
+	/// \pre The casters of the timed values are in \a casters
+	/// \throw std::runtime_error if there are more timed values than the
+	/// capacity of a snapshot
+	void save(Snapshot& snapshot, const std::vector<const Creature*>& casters) const;
+
+	/// Replaces the timed values by the ones of \a snapshot
+	/// \param casters \see save, the same creatures as the ones given to save,
+	/// or their copies
+	void load(const Snapshot& snapshot, const std::vector<const Creature*>& casters);
+
 private:
+	/// Array of timed values, inline up to capacity values, on the heap beyond
+	template <typename Type>
+	class Storage
+	{
+	public:
+		Type* begin();
+		const Type* begin() const;
+		Type& operator[](std::size_t index);
+		const Type& operator[](std::size_t index) const;
+
+		/// \return The number of values that can be stored
+		std::size_t size() const;
+
+		/// Moves the values to the heap, with room for \a size values
+		/// \param used The number of values to keep
+		void grow(std::size_t size, std::size_t used);
+
+		/// Frees the heap, the values are inline again (and must be set again)
+		void shrink();
+
+	private:
+		std::array<Type, capacity> _inline;
+		std::vector<Type> _heap;  ///< Empty while the values are inline
+	};
+
+	/// Flag of the timed values without caster, always true
+	static const bool _noCasterNeeded;
+
 	const std::vector<ConstraintDefaultValue>& _defaultValues;
-	mutable std::vector<std::vector<ConstraintTimedValue>> _timedValues;
 
-	int getValue(int constraintId, unsigned valueIndex) const;
+	/// True for the constraints of a creature or of a team, whose
+	/// CC_TEMP_IS_PARALYZED is the paralysis of casters
+	const bool _isCreatureConstraints;
+
+	/// The timed values of the constraint id are in [_offsets[id], _offsets[id+1]),
+	/// in insertion order
+	std::array<std::uint16_t, _maxConstraintsCount + 1> _offsets;
+
+	// Timed values (struct of arrays)
+	mutable Storage<int> _values;   ///< mutable for VALUE_GET_* options
+	Storage<int> _turns;             ///< Remaining turns
+	Storage<const Creature*> _casters;
+	Storage<const bool*> _casterOnBoard;  ///< Points to the board flag of the caster
+
+	// Memoized results (see getTimedValue)
+	typedef std::uint32_t Version;
+	std::array<Version, _maxConstraintsCount> _versions;          ///< Version of the timed values of each id
+	mutable std::array<Version, _maxConstraintsCount> _memoVersions;
+	mutable std::array<CasterVersion, _maxConstraintsCount> _memoCasterVersions;
+	mutable std::array<bool, _maxConstraintsCount> _memoUsesCasters;
+	mutable std::array<int, _maxConstraintsCount> _memoValues;
+
+	/// Version of the states of the casters, shared by all the Constraints of the game
+	CasterVersion* _casterVersion;
+
+	/// Gives the value of the constraint according to its order option,
+	/// memoized if possible
+	int getTimedValue(int constraintId) const;
+
+	/// Marks the timed values of \a constraintId as modified
+	void touch(int constraintId);
+
+	int getValue(int constraintId, std::size_t valueIndex) const;
 	int getFirstTimedValue(int constraintId) const;
 	int getLastTimedValue(int constraintId) const;
 	int getSumTimedValues(int constraintId) const;
 
-public:
-	Constraints(const std::vector<ConstraintDefaultValue>& defaultValues);
-	void setConstraint(int constraintId, int value, int turns, const Creature* caster=nullptr);
-	int getConstraint(int constraintId) const;
-	int getOverallConstraint(int constraintId, int otherValue) const;
-	void timeOutConstraints();
+	/// \return True if the timed value at \a valueIndex must be taken into account
+	bool isActive(std::size_t valueIndex) const;
+
+	/// Inserts a timed value at \a valueIndex, for the constraint \a constraintId
+	void insertValue(int constraintId, std::size_t valueIndex, int value, int turns, const Creature* caster);
+
+	/// Removes the timed value at \a valueIndex, of the constraint \a constraintId
+	void eraseValue(int constraintId, std::size_t valueIndex);
 };
 
+template <typename Type>
+Type* Constraints::Storage<Type>::begin()
+{
+	return _heap.empty() ? _inline.data() : _heap.data();
+}
+
+template <typename Type>
+const Type* Constraints::Storage<Type>::begin() const
+{
+	return _heap.empty() ? _inline.data() : _heap.data();
+}
+
+template <typename Type>
+Type& Constraints::Storage<Type>::operator[](std::size_t index)
+{
+	return begin()[index];
+}
+
+template <typename Type>
+const Type& Constraints::Storage<Type>::operator[](std::size_t index) const
+{
+	return begin()[index];
+}
+
+template <typename Type>
+std::size_t Constraints::Storage<Type>::size() const
+{
+	return _heap.empty() ? capacity : _heap.size();
+}
+
+template <typename Type>
+void Constraints::Storage<Type>::grow(std::size_t size, std::size_t used)
+{
+	std::vector<Type> heap(size);
+	std::copy(begin(), begin() + used, heap.begin());
+	_heap.swap(heap);
+}
+
+template <typename Type>
+void Constraints::Storage<Type>::shrink()
+{
+	std::vector<Type>().swap(_heap);
+}
+
 #endif  // _CONSTRAINTS_HPP_
@@ -3,12 +3,13 @@
 
 // Standard header
 #include <vector>
-#include <functional>
 // WizardPoker headers
 #include "common/Card.hpp"
 #include "server/ServerCardData.hpp"
 #include "server/Player.hpp"
 #include "server/Constraints.hpp"
+#include "server/GameSnapshot.hpp"
+#include "server/CardArena.hpp"
 #include "common/CardData.hpp" // Why?
 #include "common/GameData.hpp" // Why?
 
@@ -19,20 +20,15 @@ class Player;
 class Creature : public Card
 {
 private:
-	int _attack;
-	int _health;
-	int _shield;
-	int _shieldType;
+	CreatureStats& _stats;  ///< Stored by the arena of the game, with the stats of the other creatures
 
-	Player& _owner;
+	Player* _owner;  ///< The player whose board the creature is on (the cards can be stolen)
 	bool _isOnBoard;
 
 	//Constraints
-	Constraints _constraints = Constraints(creatureDefaultConstraints);
+	Constraints _constraints;
 
 	//Effects
-	static std::array<std::function<void(Creature&, EffectArgs)>, P_EFFECTS_COUNT> _effectMethods;
-
 	void setConstraint(EffectArgs effect);
 	void resetAttack(EffectArgs effect);
 	void resetHealth(EffectArgs effect);
@@ -47,13 +43,20 @@ private:
 
 public:
 	/// Constructors
-	Creature(const ServerCreatureData&, Player& owner);
+	/// \param stats The statistics of the creature, set from its template
+	/// (see CardArena::createCreature)
+	Creature(const ServerCreatureData&, Player& owner, CreatureStats& stats);
 
 	/// Player interface
-	void moveToBoard();
+	/// \param owner The player whose board the creature is moved to
+	void moveToBoard(Player& owner);
 	void removeFromBoard();
 	bool isOnBoard() const;
 
+	/// Gives the flag returned by isOnBoard, the constraints casted by the
+	/// creature keep a pointer to it to know whether they are active
+	const bool& getOnBoardFlag() const;
+
 	void enterTurn();
 	void leaveTurn();
 
@@ -61,9 +64,9 @@ public:
 	void receiveAttack(Creature& attacker, int attack, int forced, int loopCount = 0);
 
 	/// Effects interface
-	void applyEffectToSelf(EffectArgs effect);
+	void applyEffectToSelf(const CardEffect& effect);
 
-	const std::vector<EffectParamsCollection>& getEffects() const;
+	const CardEffects& getEffects() const;
 	int getAttack() const;
 	int getHealth() const;
 	int getShield() const;
@@ -72,6 +75,18 @@ public:
 	int getConstraint(int constraintId) const;
 	bool getConstraintBool(int constraintId) const;
 
+	/// \return The player whose board the creature is (or was last) on
+	const Player& getOwner() const;
+
+	/// Saves the state of the creature (but its owner) in \a snapshot
+	/// \param casters The creatures of the game, null for the spells (see GameSnapshot)
+	void save(CardSnapshot& snapshot, const std::vector<const Creature*>& casters) const;
+
+	/// Gives to the creature the state saved in \a snapshot
+	/// \param owner The player of the index snapshot.owner
+	/// \param casters \see save
+	void load(const CardSnapshot& snapshot, Player& owner, const std::vector<const Creature*>& casters);
+
 	explicit operator BoardCreatureData() const;
 };
 
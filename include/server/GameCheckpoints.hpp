@@ -0,0 +1,117 @@
+#ifndef _GAME_CHECKPOINTS_SERVER_HPP_
+#define _GAME_CHECKPOINTS_SERVER_HPP_
+
+// std-C++ headers
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+// WizardPoker headers
+#include "server/GameSnapshot.hpp"
+#include "common/Identifiers.hpp"  // UserId
+
+/// Append-only store of the states of the running games, so that they can be
+/// resumed after a restart (or a crash) of the server.
+/// The games save a checkpoint at the beginning of each turn, and tell the
+/// store when they are over. The checkpoints are compressed and written by a
+/// thread of the store, the game threads only copy their snapshot.
+/// The file starts with a header, then each record is written at once and
+/// flushed: the type, the ids of the players, the size and the checksum of
+/// the data, and the data (the snapshot whose zero bytes are run-length
+/// encoded). An incomplete or corrupted last record is ignored.
+/// When the store is opened, the last checkpoint of each game that is not
+/// over is kept (see findGame), and the file is rewritten with them only.
+/// The snapshots are written as they are in memory, a store is only valid
+/// for the server binary and the database it has been written with.
+class GameCheckpoints
+{
+public:
+	/// Version of the format, increased at each incompatible change
+	static constexpr std::uint16_t version{1};
+
+	/// Magic number at the beginning of the files
+	static const char magic[4];
+
+	/// Constructor, reads the games that are not over and starts the writing thread
+	/// \param filename The store, created if it does not exist
+	/// \throw std::runtime_error if the file can't be written
+	explicit GameCheckpoints(const std::string& filename);
+
+	GameCheckpoints(const GameCheckpoints&) = delete;
+	GameCheckpoints& operator=(const GameCheckpoints&) = delete;
+
+	/// Saves a checkpoint of a game, can be called by any thread
+	/// \param snapshot The state of the game, players[0] is its first player
+	void save(const GameSnapshot& snapshot);
+
+	/// Tells that a game is over, it will not be resumed. Can be called by any thread.
+	void finish(UserId player1Id, UserId player2Id);
+
+	/// Gives the last checkpoint of the game of a player that was running
+	/// when the store was opened
+	/// \return False if there is no such game
+	/// \note findGame, takeGame and abandonGame must be called by the same thread
+	bool findGame(UserId playerId, GameSnapshot& snapshot) const;
+
+	/// Same as findGame, but the game is removed from the games to resume:
+	/// it is resumed and will save its own checkpoints
+	bool takeGame(UserId playerId, GameSnapshot& snapshot);
+
+	/// Removes the game of a player from the games to resume, and tells that
+	/// it is over
+	void abandonGame(UserId playerId);
+
+	/// Destructor, writes the waiting records and stops the writing thread
+	~GameCheckpoints();
+
+private:
+	/// Kind of the records, the values are written in the file
+	enum class RecordType : std::uint8_t
+	{
+		CHECKPOINT,  ///< Data: the snapshot
+		GAME_OVER,   ///< No data
+	};
+
+	/// A record waiting to be written
+	struct Entry
+	{
+		RecordType type;
+		UserId player1Id;
+		UserId player2Id;
+		GameSnapshot snapshot;  ///< Only meaningful for the checkpoints
+	};
+
+	std::ofstream _file;
+	std::vector<GameSnapshot> _pendingGames;  ///< Games to resume, read when the store is opened
+
+	std::mutex _entriesMutex;
+	std::condition_variable _entriesAdded;
+	std::vector<Entry> _entries;  ///< Records waiting to be written
+	bool _stopping;
+	std::thread _writer;
+
+	/// Reads the last checkpoint of each running game of the file
+	void readGames(const std::string& filename);
+
+	/// Rewrites the file with the checkpoints of _pendingGames, and opens it for the next records
+	void rewrite(const std::string& filename);
+
+	/// Queues a record for the writing thread
+	void push(RecordType type, UserId player1Id, UserId player2Id, const GameSnapshot* snapshot);
+
+	/// Main loop of the writing thread
+	void write();
+
+	/// Writes a record in the file
+	/// \param buffer Encoding buffer, kept to avoid allocations
+	void writeEntry(const Entry& entry, std::string& buffer);
+
+	/// \return The index of the game of \a playerId in _pendingGames, or
+	/// _pendingGames.size() if there is none
+	std::size_t findPendingGame(UserId playerId) const;
+};
+
+#endif  // _GAME_CHECKPOINTS_SERVER_HPP_
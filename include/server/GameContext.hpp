@@ -0,0 +1,54 @@
+#ifndef _GAME_CONTEXT_SERVER_HPP_
+#define _GAME_CONTEXT_SERVER_HPP_
+
+// std-C++ headers
+#include <string>
+// WizardPoker headers
+#include "common/Identifiers.hpp"  // UserId
+#include "common/sockets/EndGame.hpp"
+#include "common/random/RandomInteger.hpp"
+#include "server/GameJournal.hpp"
+#include "server/GameStats.hpp"
+#include "server/Constraints.hpp"
+
+/// What the rules of the game (Player, Creature, Spell) need from the game
+/// they are played in. GameThread plays a game between two clients,
+/// GameSimulation plays it without any I/O (bots, replays, balance tests).
+class GameContext
+{
+public:
+	/// Signals the game is over and register the winner and the reason of the win
+	/// \param winnerId The id of the winner
+	/// \param cause The reason of the end of the game
+	virtual void endGame(UserId winnerId, EndGame::Cause cause) = 0;
+
+	/// Method to call to force the end of the current turn and the start of the other player's turn
+	virtual void swapTurns() = 0;
+
+	/// Gives the random generator, every random choice of the rules must use
+	/// it so that the game is given by its seed
+	virtual RandomInteger& getGenerator() = 0;
+
+	/// Gives the journal of the game (closed if the game is not recorded)
+	virtual GameJournal& getJournal() = 0;
+
+	/// Gives the version of the casters of the game, shared by the
+	/// constraints of its players and creatures (see Constraints::casterChanged)
+	virtual Constraints::CasterVersion& getCasterVersion() = 0;
+
+	/// Gives the measures of the game
+	/// \return Null if the game is not measured
+	virtual GameStats* getStats() = 0;
+
+	/// Debug method printing \a message
+	virtual void printVerbose(const std::string& message) = 0;
+
+	/// \return True if printVerbose prints the messages, so that they are
+	/// only built when they are printed
+	virtual bool isVerbose() const = 0;
+
+	/// Destructor
+	virtual ~GameContext() = default;
+};
+
+#endif  // _GAME_CONTEXT_SERVER_HPP_
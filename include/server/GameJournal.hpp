@@ -0,0 +1,143 @@
+#ifndef _GAME_JOURNAL_SERVER_HPP_
+#define _GAME_JOURNAL_SERVER_HPP_
+
+// std-C++ headers
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+// WizardPoker headers
+#include "common/Identifiers.hpp"  // UserId
+
+// Forward declarations
+struct GameSnapshot;
+
+/// Kind of the events written in a game journal.
+/// The values are written in the files, do not reorder them.
+enum class JournalRecordType : std::uint8_t
+{
+	DECK,                   ///< Values: the cards of the deck, before being shuffled
+	USE_CARD,               ///< Values: hand index
+	ATTACK_WITH_CREATURE,   ///< Values: attacker board index, victim index
+	SELECTION,              ///< Values: the indices selected by the player
+	QUIT_GAME,              ///< No value
+	TURN_SWAP,              ///< No value, the player is the one that leaves its turn
+	LOST_CONNECTION,        ///< No value
+	GAME_OVER,              ///< Values: winner id (0 if none), cause, health of player 1, health of player 2
+	CHECKPOINT,             ///< Values: the state the game is resumed from (see GameJournal::encodeSnapshot), only as first record
+};
+
+/// First data of a game journal, enough to set up the game again
+struct JournalHeader
+{
+	std::uint32_t seed;           ///< Seed of the random generator of the game
+	UserId player1Id;
+	UserId player2Id;
+	UserId firstPlayerId;         ///< The player that plays the first turn
+	std::int64_t startTime;       ///< Seconds since epoch, informative only
+};
+
+/// One event of a game
+struct JournalRecord
+{
+	JournalRecordType type;
+	std::uint32_t timestamp;      ///< Milliseconds since the beginning of the game
+	UserId player;                ///< The player concerned by the event
+	std::vector<std::int64_t> values;
+};
+
+/// Append-only binary journal of a game: the seed, the decks and every action
+/// of the players, so that the game can be played again offline (see
+/// GameSimulation::replay).
+/// The file starts with a fixed-size header, then each record is written as
+/// soon as it happens (so that the journal of a crashed server can still be
+/// read): the type, the milliseconds since the previous record, the index of
+/// the player (1 or 2) and the values, all the integers but the type and the
+/// player being variable-length encoded (LEB128, zigzag for the signed ones).
+/// A closed journal ignores the records, so that journaling can be disabled.
+/// The records can also be kept in memory, for the players that need the
+/// history of the game (see BotController).
+class GameJournal
+{
+public:
+	/// Version of the format, increased at each incompatible change (also
+	/// when the sequences of RandomInteger change, as the replays draw again)
+	static constexpr std::uint16_t version{3};
+
+	/// Magic number at the beginning of the files
+	static const char magic[4];
+
+	/// Constructor, the journal is closed
+	GameJournal();
+
+	/// Creates the file and writes the header
+	/// \return True if the file could have been created
+	bool open(const std::string& filename, const JournalHeader& header);
+
+	/// \return True if the records are written in a file
+	bool isOpen() const;
+
+	/// Keeps the following records in memory too (see getRecords)
+	/// \param header The header of the game, the same as the one given to open
+	void keepRecords(const JournalHeader& header);
+
+	/// \return The header given to open or keepRecords
+	const JournalHeader& getHeader() const;
+
+	/// \return The records kept since keepRecords was called
+	const std::vector<JournalRecord>& getRecords() const;
+
+	/// Appends an event to the file, and to the kept records
+	/// \pre \a player is one of the players given in the header
+	void record(JournalRecordType type, UserId player, const std::vector<std::int64_t>& values={});
+
+	/// Closes the file, the following records are ignored (but the kept ones)
+	void close();
+
+	/// \return The values of the CHECKPOINT record of \a snapshot: its bytes,
+	/// by blocks of 8. As in the checkpoints (see GameCheckpoints), they are
+	/// only valid for the server binary and the database of the game.
+	static std::vector<std::int64_t> encodeSnapshot(const GameSnapshot& snapshot);
+
+	/// Reads the values of a CHECKPOINT record
+	/// \return False if \a values are not a snapshot
+	static bool decodeSnapshot(const std::vector<std::int64_t>& values, GameSnapshot& snapshot);
+
+private:
+	std::ofstream _file;
+	JournalHeader _header;
+	std::chrono::steady_clock::time_point _lastRecordTime;
+	bool _keepsRecords;
+	std::vector<JournalRecord> _records;  ///< Empty unless keepRecords was called
+	std::uint32_t _timestamp;             ///< Timestamp of the last kept record
+	std::string _buffer;  ///< Encoding buffer, kept to avoid allocations
+};
+
+/// Reads a journal written by GameJournal
+class GameJournalReader
+{
+public:
+	/// Constructor, opens the file and reads the header
+	/// \throw std::runtime_error if the file can't be opened or is not a journal
+	explicit GameJournalReader(const std::string& filename);
+
+	/// \return The header of the journal
+	const JournalHeader& getHeader() const;
+
+	/// Reads the next record
+	/// \return False if there are no more records. An incomplete last record
+	/// (the server crashed while writing it) is ignored.
+	bool next(JournalRecord& record);
+
+	/// \return The number of records read so far
+	std::size_t getRecordsCount() const;
+
+private:
+	std::ifstream _file;
+	JournalHeader _header;
+	std::uint32_t _timestamp;
+	std::size_t _recordsCount;
+};
+
+#endif  // _GAME_JOURNAL_SERVER_HPP_
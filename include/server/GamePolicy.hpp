@@ -0,0 +1,75 @@
+#ifndef _GAME_POLICY_SERVER_HPP_
+#define _GAME_POLICY_SERVER_HPP_
+
+// std-C++ headers
+#include <vector>
+#include <cstddef>
+// WizardPoker headers
+#include "server/PlayerController.hpp"
+#include "common/random/RandomInteger.hpp"
+
+class Player;
+
+/// Takes the decisions of a player in a GameSimulation
+class GamePolicy
+{
+public:
+	/// \param self The player that plays the action, the active one
+	/// \param opponent The other player
+	/// \return The next action of \a self
+	virtual PlayerAction nextAction(const Player& self, const Player& opponent) = 0;
+
+	/// Chooses the targets of an effect (see PlayerController::selectCards)
+	/// \pre The zones given in \a selection are not empty
+	virtual std::vector<int> selectCards(const Player& self, const Player& opponent, const std::vector<CardToSelect>& selection) = 0;
+
+	/// Destructor
+	virtual ~GamePolicy() = default;
+
+	/// Lists the actions that \a self can play: ending its turn, and the
+	/// cards and the attacks it has enough energy for
+	/// \param self The active player
+	/// \param opponent The other player
+	/// \param actions Filled with the actions, ending the turn first
+	static void listActions(const Player& self, const Player& opponent, std::vector<PlayerAction>& actions);
+};
+
+/// Policy that plays at random one of the cards or one of the attacks that
+/// it has enough energy for, or ends its turn
+class RandomPolicy final : public GamePolicy
+{
+public:
+	/// Constructor
+	/// \param seed Seed of the choices, independent of the seed of the game
+	explicit RandomPolicy(RandomInteger::Seed seed);
+
+	PlayerAction nextAction(const Player& self, const Player& opponent) override;
+	std::vector<int> selectCards(const Player& self, const Player& opponent, const std::vector<CardToSelect>& selection) override;
+
+private:
+	RandomInteger _generator;
+	std::vector<PlayerAction> _candidates;  ///< Kept to avoid allocations
+};
+
+/// Policy that plays a given sequence of actions, then ends its turns
+class ScriptedPolicy final : public GamePolicy
+{
+public:
+	/// Constructor
+	/// \param actions The actions, in the order they are played (ending
+	/// the turns with GAME_PLAYER_LEAVE_TURN)
+	/// \param selections The answers to the selections, in the order they are
+	/// asked. The first cards are selected when there are no more answers.
+	ScriptedPolicy(const std::vector<PlayerAction>& actions, const std::vector<std::vector<int>>& selections={});
+
+	PlayerAction nextAction(const Player& self, const Player& opponent) override;
+	std::vector<int> selectCards(const Player& self, const Player& opponent, const std::vector<CardToSelect>& selection) override;
+
+private:
+	std::vector<PlayerAction> _actions;
+	std::vector<std::vector<int>> _selections;
+	std::size_t _nextAction;
+	std::size_t _nextSelection;
+};
+
+#endif  // _GAME_POLICY_SERVER_HPP_
@@ -0,0 +1,209 @@
+#ifndef _GAME_SIMULATION_SERVER_HPP_
+#define _GAME_SIMULATION_SERVER_HPP_
+
+// std-C++ headers
+#include <string>
+#include <vector>
+// WizardPoker headers
+#include "server/Player.hpp"
+#include "server/CardArena.hpp"
+#include "server/GameContext.hpp"
+#include "server/GamePolicy.hpp"
+#include "server/ServerDatabase.hpp"
+#include "server/PostGameData.hpp"
+#include "server/GameJournal.hpp"
+#include "server/GameSnapshot.hpp"
+#include "common/Identifiers.hpp"  // UserId
+#include "common/sockets/EndGame.hpp"
+#include "common/random/RandomInteger.hpp"
+#include "common/Deck.hpp"
+
+/// Plays a game without any client, timer or I/O, as fast as possible: the
+/// decisions are taken by policies (bots, balance tests, benchmarks of the
+/// rules) or read in a game journal (replays).
+/// The whole game is given by the seed, the decks and the policies.
+/// A simulation plays one game, several simulations can run in parallel as
+/// long as they do not share their policies.
+class GameSimulation final : public GameContext
+{
+public:
+	/// Maximum number of actions of a turn, the turn is ended when it is
+	/// reached (as the timer of GameThread does)
+	static constexpr int maxActionsPerTurn{64};
+
+	/// Maximum number of turns (of both players) of a game, the game ends
+	/// without winner when it is reached
+	static constexpr int maxTurns{500};
+
+	/// Constructor
+	/// \param database The cards of the game are read from it, no query is
+	/// made during the game
+	/// \param seed Seed of the random generator of the game
+	/// \param player1Id The id of the first player
+	/// \param player2Id The id of the second player, different from \a player1Id
+	GameSimulation(ServerDatabase& database, RandomInteger::Seed seed, UserId player1Id=1, UserId player2Id=2);
+
+	/// Plays a whole game
+	/// \param deck1 The deck of the first player
+	/// \param policy1 The policy of the first player
+	/// \param deck2 \see deck1
+	/// \param policy2 \see policy1
+	/// \return The id of the winner, 0 if there is none (see maxTurns)
+	/// \note The game is recorded if getJournal() is opened before, with
+	/// getFirstPlayerId() as first player
+	UserId play(const Deck& deck1, GamePolicy& policy1, const Deck& deck2, GamePolicy& policy2);
+
+	/// Plays the rest of a game set up by restore
+	/// \param policy1 The policy of the first player
+	/// \param policy2 The policy of the second player
+	/// \return The id of the winner, 0 if there is none (see maxTurns)
+	/// \pre isRunning()
+	UserId playOut(GamePolicy& policy1, GamePolicy& policy2);
+
+	/// Plays again a game recorded by a journal (see GameThread::openJournal),
+	/// from its checkpoint if the game was resumed.
+	/// The database must contain the cards of the game.
+	/// \param journal The recorded game, at its first record
+	/// \return The id of the winner
+	/// \throw std::runtime_error if the journal is not consistent with the
+	/// game (the rules changed since the recording, or the file is corrupted)
+	/// \pre The simulation has the ids given in the journal
+	UserId replay(GameJournalReader& journal);
+
+	/// Plays again the beginning of a game, so that the simulation is in the
+	/// state of the game after its last record. If the game is not over, it
+	/// can be continued with playOut (see BotSearch).
+	/// \param header The header of the recorded game
+	/// \param records The records of the game, from the first one
+	/// \return True if the records end with the end of the game (GAME_OVER)
+	/// \throw std::runtime_error \see replay
+	/// \pre The simulation has the ids given in \a header, and has not played yet
+	bool restore(const JournalHeader& header, const std::vector<JournalRecord>& records);
+
+	/// Same as restore, but the records follow the state saved in \a snapshot
+	/// (a game resumed from a checkpoint, see GameCheckpoints)
+	/// \throw std::runtime_error \see restore and load
+	bool restore(const GameSnapshot& snapshot, const std::vector<JournalRecord>& records);
+
+	/// \return True if the game is set up and not over
+	bool isRunning() const;
+
+	/// Saves the whole state of the game
+	/// \pre The game is set up (by play, restore or load)
+	/// \throw std::runtime_error \see Player::saveGame
+	void save(GameSnapshot& snapshot) const;
+
+	/// Puts the game in the state saved by \a snapshot, so that it can be
+	/// continued with playOut (from the same point as the saved game, with
+	/// the same random draws). Nothing is recorded in the journal.
+	/// \throw std::runtime_error if the snapshot is not a game between the
+	/// players of the simulation
+	void load(const GameSnapshot& snapshot);
+
+	/// \return The reason of the end of the game
+	EndGame::Cause getEndGameCause() const;
+
+	/// \return The number of turns played, of both players
+	int getTurnsCount() const;
+
+	/// \return The id of the player that played the first turn
+	UserId getFirstPlayerId() const;
+
+	/// \return The player that has the id \a playerId
+	/// \throw std::runtime_error if there is no such player
+	const Player& getPlayer(UserId playerId) const;
+
+	/// Enables or disables printVerbose (disabled by default)
+	void setVerbose(bool verbose);
+
+	/// Interface for Player (see GameContext)
+	void endGame(UserId winnerId, EndGame::Cause cause) override;
+	void swapTurns() override;
+	RandomInteger& getGenerator() override;
+	GameJournal& getJournal() override;
+	Constraints::CasterVersion& getCasterVersion() override;
+	GameStats* getStats() override;
+	void printVerbose(const std::string& message) override;
+	bool isVerbose() const override;
+
+private:
+	/// Controller of a player, forwards the decisions to its policy or reads
+	/// them in the replayed journal
+	class Seat final : public PlayerController
+	{
+	public:
+		Seat(GameSimulation& simulation, const Player& self, const Player& opponent);
+
+		/// Nobody reads the results of the actions
+		void send(sf::Packet& packet) override;
+		bool selectCards(const std::vector<CardToSelect>& selection, std::vector<int>& indices) override;
+
+		GamePolicy* policy;  ///< Null when the game is replayed
+
+	private:
+		GameSimulation& _simulation;
+		const Player& _self;
+		const Player& _opponent;
+	};
+
+	/*------------------------------ Attributes */
+	const UserId _player1Id;
+	const UserId _player2Id;
+
+	PostGameData _postGameDataPlayer1;
+	PostGameData _postGameDataPlayer2;
+
+	/// Version of the casters of the game, declared before the players whose
+	/// constraints refer to it
+	Constraints::CasterVersion _casterVersion;
+
+	/// The cards of the game, declared before the players that refer to them
+	CardArena _cards;
+	Player _player1;
+	Player _player2;
+	Player* _activePlayer;
+	Player* _passivePlayer;
+
+	Seat _seatPlayer1;
+	Seat _seatPlayer2;
+
+	bool _running;
+	bool _turnSwap;
+	bool _verbose;
+	int _turn;
+	UserId _winnerId;
+	EndGame::Cause _endGameCause;
+
+	RandomInteger _intGenerator;
+
+	GameJournal _journal;  ///< Closed unless opened with getJournal before play
+	const std::vector<JournalRecord>* _replayedRecords;  ///< Not null only during restore
+	std::size_t _nextRecord;  ///< Index of the next replayed record
+
+	/*------------------------------ Methods */
+	/// Gives the first cards and starts the first turn
+	void setUpGame();
+
+	void endTurn();
+
+	/// Plays the records from _nextRecord, \see restore
+	/// \pre _replayedRecords is set
+	bool replayRecords();
+
+	/// \return The player that a record of the replayed journal is about
+	/// \throw std::runtime_error if the player is not in this game
+	Player& getRecordedPlayer(UserId playerId);
+
+	/// \return The seat of \a player
+	Seat& getSeat(const Player& player);
+
+	/// Reads the next selection of cards in the replayed records, the empty
+	/// selections recorded by the previous versions of the server are skipped
+	/// \param player The player that makes the selection
+	/// \param indices Set to the recorded selection
+	/// \return False if the next record is not a selection of \a player: the
+	/// player did not answer before the end of its turn
+	bool nextReplayedSelection(UserId player, std::vector<int>& indices);
+};
+
+#endif  // _GAME_SIMULATION_SERVER_HPP_
@@ -0,0 +1,89 @@
+#ifndef _GAME_SNAPSHOT_SERVER_HPP_
+#define _GAME_SNAPSHOT_SERVER_HPP_
+
+// std-C++ headers
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+// WizardPoker headers
+#include "server/Constraints.hpp"
+#include "server/PostGameData.hpp"
+#include "common/Identifiers.hpp"  // UserId, CardId
+#include "common/sockets/EndGame.hpp"
+#include "common/random/RandomInteger.hpp"
+#include "common/Deck.hpp"
+
+/// Counters of the actions of a player during its turn
+struct PlayerTurnData
+{
+	int turnCount;
+	int cardsUsed;
+	int creaturesPlaced;
+	int creatureAttacks;
+	int spellCalls;
+};
+
+/// State of one of the cards of a game
+struct CardSnapshot
+{
+	CardId id;
+	// The following members are only meaningful for the creatures
+	std::uint8_t owner;  ///< Index of the player whose board the creature is (or was last) on
+	bool isOnBoard;
+	int attack;
+	int health;
+	int shield;
+	int shieldType;
+	Constraints::Snapshot constraints;
+};
+
+/// State of one of the players of a game. The cards of the player are
+/// contiguous in GameSnapshot::cards: the deck (from its bottom), the hand,
+/// the board and the graveyard.
+struct PlayerSnapshot
+{
+	UserId id;
+	bool isActive;
+	int energyInit;
+	int energy;
+	int healthInit;
+	int health;
+	unsigned turnsSinceEmptyDeck;
+	PlayerTurnData turnData;
+	PostGameData postGameData;
+	Constraints::Snapshot constraints;
+	Constraints::Snapshot teamConstraints;
+	Constraints::CasterIndex lastCaster;  ///< Index of the last used card, noCaster if none
+	std::uint8_t deckSize;
+	std::uint8_t handSize;
+	std::uint8_t boardSize;
+	std::uint8_t graveyardSize;
+};
+
+/// Complete state of a game, without any pointer: the cards are referenced
+/// by their index in the array of cards. A snapshot can thus be copied with
+/// memcpy, written as is in a file or sent to another thread, and loaded in
+/// another game (see GameSimulation::save and GameSimulation::load), to
+/// search the best move of a bot, to seek in a replay or to resume a game.
+/// A snapshot is only valid for the database it has been taken with.
+struct GameSnapshot
+{
+	/// The number of cards of a game
+	static constexpr std::size_t cardsCount{2 * Deck::size};
+
+	std::array<CardSnapshot, cardsCount> cards;
+	std::array<PlayerSnapshot, 2> players;
+	std::uint8_t activePlayer;  ///< Index of the active player in players
+	int turn;                   ///< Number of turns played, of both players
+	bool running;
+	bool turnSwap;              ///< The active player asked to end its turn
+	UserId winnerId;
+	EndGame::Cause endGameCause;
+	RandomInteger generator;
+};
+
+static_assert(std::is_trivially_copyable<GameSnapshot>::value, "A snapshot must be copyable with memcpy");
+static_assert(GameSnapshot::cardsCount < Constraints::noCaster, "The cards are indexed by CasterIndex");
+
+#endif  // _GAME_SNAPSHOT_SERVER_HPP_
@@ -0,0 +1,35 @@
+#ifndef _GAME_STATS_SERVER_HPP_
+#define _GAME_STATS_SERVER_HPP_
+
+// std-C++ headers
+#include <string>
+// WizardPoker headers
+#include "server/Histogram.hpp"
+
+/// Measures of a game, written by its thread as it runs (see Histogram) so
+/// that the slow games can be found without a profiler
+struct GameStats
+{
+	/// Nanoseconds from the reception of an input of a client to the sending
+	/// of what it changed
+	Histogram actionToUpdate;
+
+	/// Nanoseconds taken to use a card (to apply its effects)
+	Histogram effectResolution;
+
+	/// Bytes of the changes of the board sent to a client at a tick
+	Histogram boardChangeBytes;
+
+	/// Nanoseconds taken to send what a tick produced for a client
+	Histogram socketSendTime;
+
+	/// Nanoseconds between the end of a turn that timed out and the time it
+	/// should have ended at
+	Histogram turnTimerDrift;
+
+	/// \return A line per histogram: its count, median, 99th percentile and
+	/// maximum, each line starting with \a prefix
+	std::string display(const std::string& prefix) const;
+};
+
+#endif  // _GAME_STATS_SERVER_HPP_
@@ -4,18 +4,31 @@
 // std-C++ headers
 #include <thread>
 #include <atomic>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <mutex>
 // WizardPoker headers
 #include "server/Player.hpp"
+#include "server/CardArena.hpp"
 #include "server/ClientInformations.hpp"
-#include "common/Identifiers.hpp"  // UserId
+#include "common/Identifiers.hpp"  // UserId, SessionToken
 #include "server/ServerDatabase.hpp"
 #include "common/sockets/EndGame.hpp"
 #include "common/random/RandomInteger.hpp"
 #include "server/PostGameData.hpp"
-// SFML headers
-#include <SFML/Network/TcpSocket.hpp>
+#include "server/TcpConnection.hpp"
+#include "server/GameJournal.hpp"
+#include "server/GameContext.hpp"
+#include "server/ClientController.hpp"
+#include "server/BotController.hpp"
+#include "server/GameCheckpoints.hpp"
+#include "server/GameSnapshot.hpp"
 
-class GameThread final : public std::thread
+/// Plays a game between two clients, or between a client and a bot (see
+/// GameSimulation for the games without clients)
+class GameThread final : public std::thread, public GameContext
 {
 public:
 	/*------------------------------ Attributes */
@@ -42,23 +55,116 @@ public:
 	/// \param player2 \see player1
 	/// \return The id of the winner
 	UserId playGame(const ClientInformations& player1, const ClientInformations& player2);
+
+	/// Starts and plays a game against a bot, \see playGame
+	/// \param player1 The data (port/address) for the first player
+	/// \return The id of the winner
+	/// \pre setBotOpponent has been called
+	UserId playGameAgainstBot(const ClientInformations& player1);
+
 	void interruptGame(); ///< Stops the running thread (abort)
 
-	/// Interface for Player
+	/// Stops the running thread because the server ends: unlike interruptGame,
+	/// the game is not told over to the checkpoints, so that it is resumed at
+	/// the next start of the server
+	void suspendGame();
+
+	/// \return True if suspendGame stopped the game
+	bool isSuspended() const;
+
+	/// Makes the second player a bot (see BotController), that plays with the
+	/// default deck
+	/// \param pool The threads that run the searches of the bot
+	/// \param moveBudget The time given to the bot to choose each action
+	/// \pre playGame has not been called yet
+	void setBotOpponent(BotPool& pool, std::chrono::milliseconds moveBudget);
+
+	/// \return True if the second player is a bot
+	bool hasBotOpponent() const;
+
+	/// Allows clients to watch the game (see addSpectator)
+	/// \param maxSpectators Maximum number of spectators of the game
+	/// \param timeout A spectator that could not be sent the state of the game
+	/// during this time (because it does not read it) is disconnected
+	void allowSpectators(std::size_t maxSpectators, std::chrono::seconds timeout);
+
+	/// Gives the connection of a spectator to the game, can be called by any
+	/// thread. The spectator is sent GAME_STATE each time the public state of
+	/// the game changes, and GAME_OVER at the end of the game. Each state is
+	/// framed once for all the spectators, and a spectator that is late only
+	/// gets the last state: the ones it could not be sent yet are dropped.
+	/// \param spectator The connection, non-blocking so that the game never
+	/// waits for it, taken by the game if it is accepted
+	/// \return False if the game is over or already has as many spectators as allowed
+	bool addSpectator(std::unique_ptr<TcpConnection>& spectator);
+
+	/// Sends the end of the game to the spectators and disconnects them, no
+	/// spectator is accepted anymore
+	/// \pre Called by the thread of the game
+	void closeSpectators();
+
+	/// Gives the clients of the players some time to reconnect to the game
+	/// after a network failure (see reattach), rather than ending the game
+	/// as soon as a client is disconnected
+	/// \param grace The time a client has to reconnect, the game is paused
+	/// meanwhile: no input is handled and the turn timer is stopped
+	/// \pre playGame has not been called yet
+	void allowReconnection(std::chrono::seconds grace);
+
+	/// Asks the game to connect again to the client of a player, can be
+	/// called by any thread. From its next tick, the game connects to the
+	/// client in the background, as at the beginning of the game
+	/// (NEW_GAME_SERVER_CONNECTION), then sends it the whole state of the
+	/// player and GAME_STARTING.
+	/// \param token The session token of the player, given to its client by
+	/// GAME_SESSION_TOKEN
+	/// \param address The address of the client
+	/// \param listeningPort The port the client listens on
+	/// \return False if \a token is not the one of a player of the game, or
+	/// if the game is over
+	bool reattach(SessionToken token, const sf::IpAddress& address, sf::Uint16 listeningPort);
+
+	/// Prints the measures of the game (see GameStats) periodically and at
+	/// the end of the game
+	/// \param interval Time between two prints, zero to never print them
+	/// \pre playGame has not been called yet
+	void setStatsInterval(std::chrono::seconds interval);
 
-	/// Signals the game is over and register the winner and the reason of the win
-	/// \param winnerId The id of the winner
-	/// \param cause The reason of the end of the game
-	void endGame(UserId winnerId, EndGame::Cause cause);
+	/// Saves a checkpoint of the game at the beginning of each turn, and
+	/// tells \a checkpoints when the game is over (unless it is suspended by
+	/// suspendGame, so that it can be resumed)
+	/// \pre playGame has not been called yet
+	void setCheckpoints(GameCheckpoints& checkpoints);
 
-	/// Method to call to force the end of the current turn and the start of the other player's turn
-	void swapTurns();
+	/// Makes the game start from \a snapshot (see GameCheckpoints) rather
+	/// than from the beginning: the clients still send the name of their
+	/// deck, but the cards of the players are the ones of the snapshot
+	/// \pre playGame has not been called yet, the players of the game are
+	/// the ones of the snapshot, in the same order
+	void resume(const GameSnapshot& snapshot);
 
-	/// Gives the random generator
-	RandomInteger& getGenerator();
+	/// \return True if resume has been called
+	bool isResumed() const;
 
-	/// Debug method printing \a message
-	void printVerbose(const std::string& message);
+	/// Records the game that will be played in a new journal file. The
+	/// journal of a resumed game starts with a CHECKPOINT record of the state
+	/// it is resumed from, its header only gives the players.
+	/// \param directory The directory where the journal is created
+	/// \pre playGame has not been called yet
+	void openJournal(const std::string& directory);
+
+	/// Interface for Player (see GameContext)
+	void endGame(UserId winnerId, EndGame::Cause cause) override;
+	void swapTurns() override;
+	RandomInteger& getGenerator() override;
+	GameJournal& getJournal() override;
+	Constraints::CasterVersion& getCasterVersion() override;
+	GameStats* getStats() override;
+	void printVerbose(const std::string& message) override;
+	bool isVerbose() const override;
+
+	/// Enables or disables printVerbose
+	void setVerbose(bool verbose);
 
 	/// Destructor
 	~GameThread();
@@ -67,15 +173,25 @@ private:
 	/*------------------------------ Attributes */
 	std::atomic_bool _running;
 
+	/// Version of the casters of the game, declared before the players whose
+	/// constraints refer to it
+	Constraints::CasterVersion _casterVersion{0};
+
+	/// The cards of the game, declared before the players that refer to them
+	CardArena _cards;
 	Player _player1;
 	Player _player2;
 	Player* _activePlayer;
 	Player* _passivePlayer;
 
-	sf::TcpSocket _specialOutputSocketPlayer1;
-	sf::TcpSocket _specialOutputSocketPlayer2;
-	sf::TcpSocket* _activeSpecialSocket;
-	sf::TcpSocket* _passiveSpecialSocket;
+	ClientController _clientPlayer1;
+	ClientController _clientPlayer2;
+	std::unique_ptr<BotController> _bot;  ///< Controller of the second player if it is a bot
+
+	TcpConnection _specialOutputSocketPlayer1;
+	TcpConnection _specialOutputSocketPlayer2;
+	TcpConnection* _activeSpecialSocket;
+	TcpConnection* _passiveSpecialSocket;
 
 	PostGameData _postGameDataPlayer1;
 	PostGameData _postGameDataPlayer2;
@@ -90,9 +206,62 @@ private:
 	std::thread _timerThread;
 	std::atomic_bool _turnSwap;
 	std::chrono::high_resolution_clock::time_point _startOfTurnTime;
+	std::atomic_bool _isTimerPaused{false};  ///< A client is disconnected, the turn does not time out
+	std::chrono::high_resolution_clock::time_point _pauseStartTime;
 
 	RandomInteger _intGenerator;
 
+	GameJournal _journal;
+
+	GameStats _stats;  ///< Only written by the thread of the game
+	std::chrono::seconds _statsInterval{0};
+	std::chrono::steady_clock::time_point _lastStatsPrint;
+
+	/// Connection of the client of a player, which can be replaced by a new
+	/// one (see reattach)
+	struct Session
+	{
+		SessionToken token;
+		bool isDetached;  ///< The client is disconnected, the game waits for it
+		std::chrono::steady_clock::time_point deadline;  ///< End of the grace window, if isDetached
+		bool isReattaching;  ///< Set by reattach, the address of the client follows
+		sf::IpAddress address;
+		sf::Uint16 listeningPort;
+		/// Connects to the client after reattach (see connectSession), the
+		/// sockets of the player are its own until it ends
+		std::thread connector;
+		std::atomic_bool isConnecting;  ///< The connector is running
+		bool isConnected;  ///< Result of the connector, read once isConnecting is false
+	};
+
+	/// Protects the members of the sessions that reattach sets
+	std::mutex _sessionsMutex;
+	Session _sessionPlayer1{};
+	Session _sessionPlayer2{};
+	std::chrono::seconds _reconnectionGrace{0};  ///< Zero if the game ends at the first disconnection
+
+	GameCheckpoints* _checkpoints=nullptr;       ///< Null if the game is not saved
+	std::atomic_bool _suspended{false};          ///< Set by suspendGame
+	std::unique_ptr<GameSnapshot> _resumedGame;  ///< State the game starts from, null for a new game
+
+	/// Connection of a spectator of the game
+	struct Spectator
+	{
+		std::unique_ptr<TcpConnection> socket;
+		std::chrono::steady_clock::time_point lastCaughtUp;  ///< Last time everything was sent to it
+	};
+
+	/// Protects the members about the spectators that addSpectator uses
+	std::mutex _spectatorsMutex;
+	std::vector<std::unique_ptr<TcpConnection>> _newSpectators;  ///< Given by addSpectator, not adopted yet
+	std::size_t _spectatorsCount=0;
+	std::size_t _maxSpectators=0;
+	bool _isSpectatingOver=false;
+	std::chrono::seconds _spectatorTimeout{0};
+
+	std::vector<Spectator> _spectators;  ///< Only used by the thread of the game
+	TcpConnection::Frame _stateFrame;     ///< Last state sent to the spectators
+
 	/*------------------------------ Static variables */
 	/// Currently low for tests, arbitrary, need more time now for testing
 	static constexpr std::chrono::seconds _turnTime{120};  // TODO: change this
@@ -100,17 +269,112 @@ private:
 	/*------------------------------ Methods */
 	void createPlayers();
 
+	/// \return The header of the journal of the game
+	JournalHeader makeJournalHeader(std::int64_t startTime) const;
+
+	/// Plays the game once the clients are connected
+	/// \return The id of the winner
+	UserId play();
+
+	/// \return True if \a player is played by a bot
+	bool isBot(const Player& player) const;
+
 	/// Main loop of the game: waits for each side inputs and forces turns swapping
 	void runGame();
 
-	void setSocket(sf::TcpSocket& socket, sf::TcpSocket& specialSocket, const ClientInformations& player);
+	void setSocket(TcpConnection& socket, TcpConnection& specialSocket, const ClientInformations& player);
+
+	/// Tells the client listening on \a listeningPort to connect to the game
+	/// (NEW_GAME_SERVER_CONNECTION), and accepts its connections
+	/// \param timeout Maximum time to wait for each connection, zero to wait
+	/// as long as needed
+	/// \return False if the client did not connect
+	bool connectSockets(TcpConnection& socket, TcpConnection& specialSocket, const sf::IpAddress& address,
+			sf::Uint16 listeningPort, sf::Time timeout);
+
+	/// Receives the name of the deck chosen by the client of \a player and
+	/// gives the deck to \a player (a bot gets the default deck)
+	void receiveDeck(Player& player);
+
+	/// \return The client that plays \a player
+	ClientController& getClient(const Player& player);
+
+	/// \return The socket the changes of the board are sent to \a player on
+	TcpConnection& getSpecialSocket(const Player& player);
+
+	/// \return The session of the client of \a player
+	Session& getSession(const Player& player);
+
+	/// Called when the client of \a player is disconnected: the game waits
+	/// for it to reconnect (see reattach), or ends if the reconnections are
+	/// not allowed
+	void detach(Player& player);
+
+	/// Connects again to the client of \a player if it asked to (see
+	/// reattach), and ends the game if \a player is detached for too long.
+	/// The connection is made by the connector of the session, the game does
+	/// not wait for it: \a player is reattached at the tick after it ends.
+	/// \return True if the client of \a player is connected
+	bool updateSession(Player& player);
+
+	/// Body of the connector of the session of \a player, connects to its
+	/// client (see connectSockets)
+	void connectSession(Player& player, sf::IpAddress address, sf::Uint16 listeningPort);
+
+	/// Waits for the connectors of the sessions to end, so that the game can
+	/// use the sockets of the players again
+	void joinConnectors();
+
+	/// Updates the sessions of the players that are not bots (see updateSession)
+	/// \return True if the client of a player is detached, the game is paused
+	/// then: no input is handled and the turns do not end
+	bool updateSessions();
+
+	/// Pauses or resumes the turn timer, the time of the pause is not counted
+	void pauseTimer(bool paused);
+
+	/// Sends what the tick produced for \a player (on both of its sockets),
+	/// without blocking
+	/// \return False if the player is disconnected or does not read its sockets
+	bool flushSockets(Player& player, TcpConnection& specialSocket);
 
 	void makeTimer();
 
+	/// Saves the state of the game in \a snapshot (see GameSimulation::save)
+	/// \pre No player is awaiting a selection
+	/// \throw std::runtime_error \see Player::saveGame
+	void save(GameSnapshot& snapshot) const;
+
+	/// Gives the game the state saved in \a snapshot (see GameSimulation::load),
+	/// but whether the game is running
+	void load(const GameSnapshot& snapshot);
+
+	/// Gives a checkpoint of the game to _checkpoints, if any. The previous
+	/// checkpoint is removed if the game cannot be saved.
+	void saveCheckpoint();
+
+	/// Prints _stats if _statsInterval elapsed since the last time
+	/// \param force Prints them anyway, unless the prints are disabled
+	void printStats(bool force);
+
 	void endTurn();
 	void swapData();
 
-	void sendFinalMessage(sf::TcpSocket& specialSocket, PostGameData& postGameData, CardId earnedCardId, AchievementList& newAchievements);
+	/// Ends the game because \a player is not connected anymore
+	void loseConnection(Player& player);
+
+	void sendFinalMessage(TcpConnection& specialSocket, PostGameData& postGameData, CardId earnedCardId, AchievementList& newAchievements);
+
+	/// Moves the spectators given by addSpectator to _spectators
+	void adoptSpectators();
+
+	/// Sends the state of the game to the spectators if it changed, or if
+	/// they just arrived
+	void updateSpectators();
+
+	/// Sends what waits for the spectators without blocking, and disconnects
+	/// the ones that are disconnected or late for too long
+	void flushSpectators();
 };
 
 /*------------------------------ Template code */
@@ -121,10 +385,12 @@ GameThread::GameThread(ServerDatabase& database, UserId player1Id, UserId player
 	_player1Id(player1Id),
 	_player2Id(player2Id),
 	_running(true),
-	_player1(*this, database, _player1Id, _player2, _postGameDataPlayer1),
-	_player2(*this, database, _player2Id, _player1, _postGameDataPlayer2),
+	_cards(GameSnapshot::cardsCount),
+	_player1(*this, database, _cards, _player1Id, _player2, _postGameDataPlayer1),
+	_player2(*this, database, _cards, _player2Id, _player1, _postGameDataPlayer2),
 	_database(database),
 	_winnerId{0},
+	_endGameCause(EndGame::Cause::ENDING_SERVER),
 	_turn(0),
 	_turnSwap{false}
 {
@@ -0,0 +1,75 @@
+#ifndef _HISTOGRAM_SERVER_HPP_
+#define _HISTOGRAM_SERVER_HPP_
+
+// std-C++ headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/// Distribution of non-negative values (durations in nanoseconds, sizes in
+/// bytes), with a bounded relative error as in HdrHistogram: the values are
+/// grouped by power of two, and each power of two is split in
+/// subBucketsCount linear buckets, so a value is known within 1/subBucketsCount
+/// of itself whatever its magnitude.
+/// A histogram is written by a single thread (record does not lock nor use
+/// read-modify-write instructions), and can be read by any thread meanwhile:
+/// the reader may see a record partially, but never blocks the writer.
+class Histogram
+{
+public:
+	/// log2 of the number of buckets per power of two
+	static constexpr std::size_t subBucketBits{3};
+
+	static constexpr std::size_t subBucketsCount{std::size_t(1) << subBucketBits};
+
+	/// Number of buckets, enough for any 64-bit value
+	static constexpr std::size_t bucketsCount{(64 - subBucketBits + 1) * subBucketsCount};
+
+	/// Constructor, the histogram is empty
+	Histogram();
+
+	Histogram(const Histogram&) = delete;
+	Histogram& operator=(const Histogram&) = delete;
+
+	/// Adds a value
+	/// \pre Called by the thread that writes the histogram
+	void record(std::uint64_t value);
+
+	/// Adds the nanoseconds elapsed since \a start
+	/// \pre Called by the thread that writes the histogram
+	void recordSince(std::chrono::steady_clock::time_point start);
+
+	/// \return The number of recorded values
+	std::uint64_t getCount() const;
+
+	/// \return The sum of the recorded values
+	std::uint64_t getSum() const;
+
+	/// \return The greatest recorded value, 0 if the histogram is empty
+	std::uint64_t getMax() const;
+
+	/// \param percentile In [0, 100]
+	/// \return The value that \a percentile percents of the recorded values
+	/// do not exceed (the highest value of its bucket), 0 if the histogram
+	/// is empty
+	std::uint64_t getValueAtPercentile(double percentile) const;
+
+	/// \return The number of values recorded in the bucket \a index
+	std::uint64_t getBucketCount(std::size_t index) const;
+
+	/// \return The highest value of the bucket \a index
+	static std::uint64_t getBucketUpperBound(std::size_t index);
+
+	/// \return The index of the bucket of \a value
+	static std::size_t getBucketIndex(std::uint64_t value);
+
+private:
+	std::array<std::atomic<std::uint64_t>, bucketsCount> _buckets;
+	std::atomic<std::uint64_t> _count;
+	std::atomic<std::uint64_t> _sum;
+	std::atomic<std::uint64_t> _max;
+};
+
+#endif  // _HISTOGRAM_SERVER_HPP_
@@ -2,10 +2,7 @@
 #define _PLAYER_HPP
 
 // std-C++ headers
-#include <stack>
-#include <random>
-#include <array>
-#include <functional>
+#include <vector>
 #include <cstddef>
 #include <atomic>
 #include <memory>
@@ -15,6 +12,8 @@
 #include "server/Creature.hpp"
 #include "server/Constraints.hpp"
 #include "server/ServerDatabase.hpp"
+#include "server/CardArena.hpp"
+#include "server/CardZone.hpp"
 #include "server/ServerCardData.hpp"
 #include "common/GameData.hpp"
 #include "common/Identifiers.hpp"  // UserId
@@ -22,28 +21,51 @@
 #include "common/sockets/EndGame.hpp"
 #include "common/Deck.hpp"
 #include "server/PostGameData.hpp"
-// SFML headers
-#include <SFML/Network/TcpSocket.hpp>
-
-class GameThread;
+#include "server/GameContext.hpp"
+#include "server/PlayerController.hpp"
+#include "server/GameSnapshot.hpp"
 
 /// Represents one of the two players for a given game.
+/// The rules do not make any I/O: the game is given by a GameContext and
+/// the decisions of the player by a PlayerController.
 class Player
 {
 public:
+	/// Zones of the cards, as indices in the arena of the game. A card can be
+	/// given to the opponent, so the hand, the board and the graveyard can
+	/// hold all the cards of the game.
+	typedef CardZone<Card, Deck::size> DeckCards;
+	typedef CardZone<Card, GameSnapshot::cardsCount> Cards;
+	typedef CardZone<Creature, GameSnapshot::cardsCount> Board;
+
 	PostGameData& _postGameData;
 
 	/*------------------------------ Methods */
 	/// Constructor
-	Player(GameThread& gameThread, ServerDatabase& database, UserId id, Player& opponent, PostGameData& postGameData);
+	/// \param cards The arena of the game, shared with \a opponent
+	Player(GameContext& game, ServerDatabase& database, CardArena& cards, UserId id, Player& opponent, PostGameData& postGameData);
+
+	/// Gives the side that takes the decisions of the player
+	/// \pre Called before setUpGame
+	void setController(PlayerController& controller);
+
+	/// Enables or disables the logging of the board changes (see
+	/// getBoardChanges), useless when nobody displays the game
+	void setBoardChangesLogged(bool logged);
 
 	// Interface for basic gameplay
-	/// Receive the deck sent by the client and put it in the game
-	void receiveDeck();
+	/// Shuffles the cards of \a newDeck and puts them in the deck
+	void setDeck(const Deck& newDeck);
 
 	/// The game has begun.
 	void setUpGame(bool isActivePlayer);
 
+	/// The game has been loaded (see loadGame) to be resumed, or the client
+	/// of the player has reconnected: sends the whole state of the player and
+	/// the "game starting" signal to its controller, as setUpGame does. The
+	/// targets of the card that awaits a selection, if any, are asked again.
+	void resumeGame();
+
 	/// The player's turn has started
 	void enterTurn(int turn);
 
@@ -51,10 +73,18 @@ public:
 	void leaveTurn();
 
 	// Interface for client input
-	/// Tries to receive an input from the client, executes the corresponding
-	/// action.
-	/// \return the status of the socket after the receiving
-	sf::Socket::Status tryReceiveClientInput();
+	/// Executes the action sent by the client, or uses the card that waits
+	/// for the cards it has selected (see isAwaitingSelection)
+	void handleClientInput(sf::Packet& playerActionPacket);
+
+	/// Executes an action of the player (sent by its client, chosen by a bot
+	/// or read in a game journal)
+	void handleAction(const PlayerAction& action);
+
+	/// \return True if the card the player has used waits for the player to
+	/// choose the targets of its effects (see PlayerController::selectCards).
+	/// The card is not used if the turn ends meanwhile.
+	bool isAwaitingSelection() const;
 
 	/// \return true if some changes has been logged since the last player's
 	/// action, false otherwise.
@@ -66,6 +96,42 @@ public:
 	/// \post !thereAreBoardChanges();
 	sf::Packet getBoardChanges();
 
+	/// Appends to \a packet what everybody can see of the player (its
+	/// spectators, see GameThread::addSpectator): its health, its energy,
+	/// its board and its graveyard, but only the numbers of cards of its
+	/// hand and of its deck
+	void appendPublicState(sf::Packet& packet) const;
+
+	/// Saves the state of both players, and of their cards, in \a snapshot
+	/// \param player1 The first player of the game
+	/// \param player2 The opponent of \a player1
+	/// \param snapshot It is zeroed (padding included, so that equal games
+	/// give equal bytes), then its members about the players and the cards
+	/// are set
+	/// \pre The players are not awaiting a selection
+	/// \throw std::runtime_error if a card or a player has more timed
+	/// values than a snapshot holds (see Constraints::save)
+	static void saveGame(const Player& player1, const Player& player2, GameSnapshot& snapshot);
+
+	/// Gives to both players the state saved in \a snapshot. The current
+	/// cards of the game are restored in place if they are the cards of
+	/// \a snapshot (e.g. when the same game is loaded again and again), they
+	/// are created again from the database otherwise.
+	/// \param player1 The first player of the game, with the id of the first player of \a snapshot
+	/// \param player2 The opponent of \a player1
+	/// \param snapshot A snapshot made by saveGame
+	/// \throw std::runtime_error if the players do not have the ids of the
+	/// snapshot, or if it is not valid (see checkSnapshot), the players are
+	/// then left unchanged
+	static void loadGame(Player& player1, Player& player2, const GameSnapshot& snapshot);
+
+	/// Checks that \a snapshot is a game that can be loaded: its zones hold
+	/// all the cards, the decks are not larger than Deck::size, the cards
+	/// exist in \a database, the cards on the boards are creatures, and the
+	/// indices of the players and of the casters are in range
+	/// \throw std::runtime_error if it is not, with the first problem found
+	static void checkSnapshot(ServerDatabase& database, const GameSnapshot& snapshot);
+
 	/// This method is called by a creature when it dies to be remvoed from
 	/// the board and to be placed in the graveyard
 	void cardBoardToGraveyard(const Creature *card);
@@ -73,20 +139,35 @@ public:
 	// Getters
 	int getCreatureConstraint(const Creature& subject, int constraintId) const;
 	const Card* getLastCaster() const;
+	/// \return The last used card if it is a creature, null otherwise
+	const Creature* getLastCasterCreature() const;
+	/// \return The version of the casters of the game, for the constraints
+	/// of the creatures of the player (see GameContext::getCasterVersion)
+	Constraints::CasterVersion& getCasterVersion();
 	UserId getId() const;
+	int getHealth() const;
 	static int getMaxHealth();
-	sf::TcpSocket& getSocket();
+	int getEnergy() const;
+	const Cards& getHand() const;
+	const Board& getBoard() const;
+	Cards::size_type getHandSize() const;
 	void printVerbose(const std::string& message);
 
+	/// Prints the call of the effect method \a method with its arguments,
+	/// the message is only built if the game is verbose
+	void printVerbose(const char* method, const EffectArgs& effect);
+
 private:
 	/*------------------------------ Types */
-	struct TurnData
+	typedef PlayerTurnData TurnData;
+
+	/// A card that waits for the player to choose the targets of its effects,
+	/// when its controller does not answer at once. The card is used when
+	/// the selection is received.
+	struct CardUse
 	{
-		int turnCount;
-		int cardsUsed;
-		int creaturesPlaced;
-		int creatureAttacks;
-		int spellCalls;
+		Card* card;     ///< Null if no card is waiting
+		int handIndex;  ///< Index of the card in the hand
 	};
 
 	/*------------------------------ Static variables */
@@ -96,16 +177,17 @@ private:
 	constexpr static unsigned _maximumAmountOfTurnsWithEmptyDeck{10};
 
 	/*------------------------------ Attributes */
-	GameThread& _gameThread;
+	GameContext& _game;
 	ServerDatabase& _database;
+	PlayerController* _controller;
 
 	Player& _opponent;
 	UserId _id;
 	std::atomic_bool _isActive; // blocks functions that are only allowed for active player
 
 	// Client communication
-	sf::TcpSocket _socketToClient;
 	sf::Packet _pendingBoardChanges;
+	bool _logBoardChanges;
 
 	// Gameplay
 	int _energyInit, _energy, _healthInit, _health;
@@ -113,33 +195,36 @@ private:
 	TurnData _turnData;
 
 	// Constraints
-	Constraints _constraints = Constraints(playerDefaultConstraints);
-	Constraints _teamConstraints = Constraints(creatureDefaultConstraints);
+	Constraints _constraints;
+	Constraints _teamConstraints;
+
+	/// The cards of the game, the card holders store their indices
+	CardArena& _cards;
 
 	// Card holders
-	// The sum of the lengths of these std::vectors/std::stacks is **always** 20
-	// because at first, all are empty except the deck which contains... The deck
+	// The sum of the sizes of the zones of both players is **always** 40
+	// because at first, all are empty except the decks which contain... The decks
 	// obviously... And then the cards move from one to another but never disappear
 	// or are created
 
-	/// Cards that are in the deck (not usable yet)
-	std::stack<std::unique_ptr<Card>> _cardDeck;
+	/// Cards that are in the deck (not usable yet), the last one is drawn first
+	DeckCards _cardDeck;
 
 	/// Cards that are in the player's hand (usable)
-	std::vector<std::unique_ptr<Card>> _cardHand;
+	Cards _cardHand;
 
 	/// Cards that are on the board (usable for attacks)
-	std::vector<std::unique_ptr<Creature>> _cardBoard;
+	Board _cardBoard;
 
 	/// Cards that are discarded (dead creatures, used spells)
-	std::vector<std::unique_ptr<Card>> _cardGraveyard;
+	Cards _cardGraveyard;
 
 	/// Last card that was used to cast an effect (his or his opponent's)
 	/// This is not a smart pointer because it points to an already allocated card.
 	const Card* _lastCasterCard = nullptr;
 
-	// Effects container
-	static std::array<std::function<void(Player&, EffectArgs)>, P_EFFECTS_COUNT> _effectMethods;
+	/// The card waiting for a selection
+	CardUse _cardUse;
 
 	/*------------------------------ Methods */
 	// User actions
@@ -157,38 +242,42 @@ private:
 
 	// Interface for applying effects
 	/// Generic method that will then call the appropriate method below.
+	/// \param selectedIndex The index of the target chosen by the player if
+	/// the subject of the effect is chosen (see CardEffects::getSelection),
+	/// -1 if none has been chosen
 	/// \return True if the effect could have been applied and false otherwise
-	bool applyEffect(Card* usedCard, EffectArgs effect);
+	bool applyEffect(Card* usedCard, const CardEffect& effect, int selectedIndex);
 
 	/// Apply an effect to itself
-	void applyEffectToSelf(EffectArgs effect);
+	void applyEffectToSelf(const CardEffect& effect);
 
 	/// Apply an effect to one of its Creatures, with reference to creature
-	void applyEffectToCreature(Creature* casterAndSubject, EffectArgs effect);
+	void applyEffectToCreature(Creature* casterAndSubject, const CardEffect& effect);
 
 	/// Apply an effect to one of its Creatures, with creature index
-	void applyEffectToCreature(EffectArgs effect, const std::vector<int>& boardIndexes);
+	void applyEffectToCreature(const CardEffect& effect, int boardIndex);
 
 	/// Apply an effect to all of its Creatures
-	void applyEffectToCreatureTeam(EffectArgs effect);
+	void applyEffectToCreatureTeam(const CardEffect& effect);
 
-	/// Generate a ramdom number in the interval [0, vector.size()[. This is a
+	/// Generate a ramdom number in the interval [0, zone.size()[. This is a
 	/// convenience function used only to lightweight the code.
-	/// \tparam Type contained in the vector.
-	/// \param vector The vector that need a random index.
-	/// \return A ramdom number in the interval [0, vector.size()[.
+	/// \tparam Zone Type of the zone.
+	/// \param zone The zone that need a random index.
+	/// \return A ramdom number in the interval [0, zone.size()[.
 	/// \note The implementation is in source file rather than in the header
 	/// because this is a private method.
-	template <typename T>
-	inline int getRandomIndex(const std::vector<T>& vector);
+	template <typename Zone>
+	inline int getRandomIndex(const Zone& zone);
 
-	/// \param selection a vector of values telling whether the choice must be in player's cards or opponent's cards
-	/// \return a vector of indices selected
-	std::vector<int> getRandomBoardIndexes(const std::vector<CardToSelect>& selection);
+	/// \return True if the player has to choose cards in \a selection: it is
+	/// not empty, and there is something to choose in each of its zones (the
+	/// effect targeting an empty zone fails anyway)
+	bool needsSelection(const std::vector<CardToSelect>& selection) const;
 
-	/// \param selection a vector of values telling whether the choice must be in player's cards or opponent's cards
-	/// \return a vector of indices selected
-	std::vector<int> askUserToSelectCards(const std::vector<CardToSelect>& selection);
+	/// Uses the card that waits for the selection given by the client
+	/// \param selectedIndices The indices received from the client
+	void receiveSelection(std::vector<int> selectedIndices);
 
 	// Effects (private)
 	void setConstraint(EffectArgs effect);
@@ -205,11 +294,24 @@ private:
 	/// The method calling all of the effects generated by the presence
 	/// of the card \a usedCard
 	/// \param usedCard The card to exploit
+	/// \param selectedIndices The targets chosen by the player, one per
+	/// element of the selection of the card, or none if it was not asked
 	/// \return True if all of the effects could have been applied
 	/// and false otherwise
-	bool exploitCardEffects(Card* usedCard);
+	bool exploitCardEffects(Card* usedCard, const std::vector<int>& selectedIndices);
+
+	/// Uses the card \a usedCard, whose targets have been chosen
+	void playCard(int handIndex, Card* usedCard, const std::vector<int>& selectedIndices);
+
+	/// Logs the changes made by the use of a card
+	void logCardUse();
+
 	void setTeamConstraint(EffectArgs effect);
-	void setDeck(const Deck& newDeck);
+
+	/// Puts the cards in the deck, without shuffling them
+	/// \param cards The cards of the deck, in the order they are stacked
+	/// (the last one is drawn first)
+	void loadDeck(const std::vector<CardId>& cards);
 
 	void cardDeckToHand(int amount);
 	void cardHandToBoard(int handIndex);
@@ -220,16 +322,19 @@ private:
 	/// Move the card at boardIndex from the board to the bin
 	void cardBoardToGraveyard(int boardIndex);
 	void cardGraveyardToHand(int binIndex);
-	void cardAddToHand(std::unique_ptr<Card> given);
-	std::unique_ptr<Card> cardRemoveFromHand();
-	std::unique_ptr<Card> cardExchangeFromHand(std::unique_ptr<Card> given);
-	std::unique_ptr<Card> cardExchangeFromHand(std::unique_ptr<Card> given, int handIndex);
+	void cardAddToHand(Card* given);
+	Card* cardRemoveFromHand();
+	Card* cardExchangeFromHand(Card* given);
+	Card* cardExchangeFromHand(Card* given, int handIndex);
 
-	void useCreature(int handIndex, Card* usedCard);
-	void useSpell(int handIndex, Card* useSpell);
+	void useCreature(int handIndex, Card* usedCard, const std::vector<int>& selectedIndices);
+	void useSpell(int handIndex, Card* useSpell, const std::vector<int>& selectedIndices);
 
 	void logEverything();
 
+	/// Sends the whole state of the player then the "game starting" signal
+	void sendGameStarting();
+
 	void logCurrentEnergy();
 	void logCurrentHealth();
 	void logOpponentHealth();
@@ -242,16 +347,46 @@ private:
 	void logGraveyardState();
 
 
-	template <typename CardType>
-	void logIdsFromVector(TransferType type, const std::vector<std::unique_ptr<CardType>>& vect);
-	void logCardDataFromVector(TransferType type, const std::vector<std::unique_ptr<Card>>& vect);
-	void logBoardCreatureDataFromVector(TransferType type, const std::vector<std::unique_ptr<Creature>>& vect);
+	template <typename Zone>
+	void logIdsFromVector(TransferType type, const Zone& vect);
+	template <typename Zone>
+	void logCardDataFromVector(TransferType type, const Zone& vect);
+	void logBoardCreatureDataFromVector(TransferType type, const Board& vect);
 	void sendValueToClient(TransferType value);
 
-	// Some getters
-	const std::vector<std::unique_ptr<Creature>>& getBoard() const;
-	int getHealth() const;
-	std::vector<std::unique_ptr<Card>>::size_type getHandSize() const;
+	/// Appends the cards of the player to \a cards, in the order of PlayerSnapshot
+	void listCards(std::vector<const Card*>& cards) const;
+
+	/// Checks the parts of \a snapshot that do not need the database: the
+	/// sizes of the zones, the owners and the casters (see checkSnapshot)
+	/// \throw std::runtime_error if \a snapshot is not valid
+	static void checkSnapshotLayout(const GameSnapshot& snapshot);
+
+	/// \return True if the card \a index of \a snapshot is on the board of its player
+	static bool isOnBoard(const GameSnapshot& snapshot, std::size_t index);
+
+	/// Finds the cards of \a snapshot among the current cards of the game
+	/// \param arena The arena of the game
+	/// \param cards Set to the card of each index of the snapshot
+	/// \return False if the current cards are not the ones of \a snapshot
+	static bool findCards(const CardArena& arena, const GameSnapshot& snapshot, std::vector<Card*>& cards);
+
+	/// Saves the state of the player
+	/// \param cards The cards of the game, in the order of GameSnapshot::cards
+	/// \param casters The same as \a cards, but null for the spells
+	void save(PlayerSnapshot& snapshot, const std::vector<const Card*>& cards, const std::vector<const Creature*>& casters) const;
+
+	/// Gives to the player the state saved in \a snapshot
+	/// \param cards The cards of the game, put in the zones of the player
+	/// \param firstCard The index of the first card of the player in \a cards
+	/// \param casters The cards of the game, null for the spells
+	void load(const PlayerSnapshot& snapshot, const std::vector<Card*>& cards, std::size_t firstCard,
+			const std::vector<const Creature*>& casters);
+
+	/// \return The creatures of the board. A dead creature leaves the board
+	/// but stays alive in the graveyard, so the returned pointers can be used
+	/// to apply an effect to each creature even if some of them die meanwhile.
+	Board getBoardCreatures() const;
 };
 
 
@@ -0,0 +1,45 @@
+#ifndef _PLAYER_CONTROLLER_SERVER_HPP_
+#define _PLAYER_CONTROLLER_SERVER_HPP_
+
+// std-C++ headers
+#include <vector>
+// WizardPoker headers
+#include "common/GameData.hpp"  // CardToSelect
+#include "common/sockets/TransferType.hpp"
+// SFML headers
+#include <SFML/Network/Packet.hpp>
+
+/// An action of the active player, the same as the ones a client can send
+struct PlayerAction
+{
+	/// GAME_USE_CARD, GAME_ATTACK_WITH_CREATURE, GAME_PLAYER_LEAVE_TURN or GAME_QUIT_GAME
+	TransferType type;
+	int first;   ///< Index of the used card in the hand, or of the attacker on the board
+	int second;  ///< Index of the victim on the opponent's board, -1 for the opponent himself
+};
+
+/// The side of a Player that takes the decisions: a client connected to the
+/// server (ClientController), a bot or a replayed journal (GameSimulation).
+/// The actions themselves are given to Player::handleAction.
+class PlayerController
+{
+public:
+	/// Gives to the player the result of one of its actions (ACKNOWLEDGE,
+	/// FAILURE, GAME_NOT_ENOUGH_ENERGY...)
+	virtual void send(sf::Packet& packet) = 0;
+
+	/// Asks the player to choose the targets of the effects of the card he
+	/// uses, all at once. If the answer can not be given at once (e.g. it
+	/// comes from the network), the card is used when the answer is given to
+	/// the player (see Player::handleClientInput).
+	/// \param selection Where each card must be chosen, not empty
+	/// \param indices Set to one index per element of \a selection if the
+	/// answer is given at once
+	/// \return True if the answer is given at once, false if it comes later
+	virtual bool selectCards(const std::vector<CardToSelect>& selection, std::vector<int>& indices) = 0;
+
+	/// Destructor
+	virtual ~PlayerController() = default;
+};
+
+#endif  // _PLAYER_CONTROLLER_SERVER_HPP_
@@ -0,0 +1,68 @@
+#ifndef _PRESENCE_MANAGER_SERVER_HPP_
+#define _PRESENCE_MANAGER_SERVER_HPP_
+
+// std-C++ headers
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+// WizardPoker headers
+#include "common/Identifiers.hpp"  // UserId
+#include "common/Database.hpp"  // FriendsList
+
+/// In-memory friendship graph of the connected users. The friends list of a
+/// user is loaded once from the database when he connects, then the graph is
+/// kept up to date by the server, so that knowing who must be told about a
+/// presence change never needs a database query.
+/// The class only computes who must be notified, sending the notifications is
+/// up to the server.
+class PresenceManager
+{
+public:
+	/// Constructor
+	PresenceManager();
+
+	/// Registers a user who just connected.
+	/// \param id The id of the user
+	/// \param name The name of the user
+	/// \param friends The friends list of the user, as stored in the database
+	/// \return The names of the friends of the user that are connected
+	/// (they must be told that the user is now connected)
+	std::vector<std::string> connect(UserId id, const std::string& name, const FriendsList& friends);
+
+	/// Unregisters a user who is disconnecting.
+	/// \param id The id of the user
+	/// \return The names of the friends of the user that are connected
+	/// (they must be told that the user is now disconnected)
+	std::vector<std::string> disconnect(UserId id);
+
+	/// Updates the graph when a new friendship is made
+	void addFriendship(UserId first, UserId second);
+
+	/// Updates the graph when a friendship is broken
+	void removeFriendship(UserId first, UserId second);
+
+	/// \return True if the user is connected
+	bool isOnline(UserId id) const;
+
+	/// \param id A connected user
+	/// \param friendId Any user
+	/// \return True if \a friendId is a friend of \a id
+	bool areFriend(UserId id, UserId friendId) const;
+
+	/// \param id A connected user
+	/// \return The names of the friends of \a id that are connected
+	std::vector<std::string> getOnlineFriends(UserId id) const;
+
+private:
+	/// A connected user and the ids of all of his friends (connected or not)
+	struct Subscriber
+	{
+		std::string name;
+		std::unordered_set<UserId> friends;
+	};
+
+	std::unordered_map<UserId, Subscriber> _subscribers;  ///< Connected users
+};
+
+#endif  // _PRESENCE_MANAGER_SERVER_HPP_
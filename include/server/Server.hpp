@@ -10,6 +10,13 @@
 #include "server/ServerDatabase.hpp"
 #include "server/GameThread.hpp"
 #include "server/ClientInformations.hpp"
+#include "server/PresenceManager.hpp"
+#include "server/ServerSettings.hpp"
+#include "server/TimerQueue.hpp"
+#include "server/TcpConnection.hpp"
+#include "server/BotPool.hpp"
+#include "server/GameCheckpoints.hpp"
+#include "server/ServerMetrics.hpp"
 // std-C++ headers
 #include <unordered_map>
 #include <memory>
@@ -22,7 +29,8 @@ class Server final
 {
 public:
 	/// Constructor
-	Server();
+	/// \param settings The tunable parameters of the server
+	explicit Server(const ServerSettings& settings=ServerSettings());
 
 	/// Function used to start the server: it starts to listen and then to handle incoming packets
 	/// \param listenerPort The port the server must be listening on
@@ -37,7 +45,15 @@ public:
 private:
 	typedef std::unordered_map<std::string, ClientInformations>::iterator _iterator;
 
+	/// An accepted connection whose first packet is not received yet
+	struct PendingConnection
+	{
+		std::unique_ptr<TcpConnection> socket;
+		TimerQueue::TimerId deadline;  ///< Timer closing the connection if it is too slow
+	};
+
 	// attributes
+	const ServerSettings _settings;
 	std::unordered_map<std::string, ClientInformations> _clients;
 	sf::SocketSelector _socketSelector;
 	std::atomic_bool _done;
@@ -45,25 +61,52 @@ private:
 	std::thread _quitThread;
 	std::string _waitingPlayer;
 	bool _isAPlayerWaiting;
+	TimerQueue::TimerId _botOpponentTimer;  ///< Timer giving a bot to the waiting player
+	bool _isBotOpponentTimerSet;
 	std::mutex _lobbyMutex;
 	const std::string _quitPrompt;
 	ServerDatabase _database;
+	PresenceManager _presence;
+	ServerMetrics _metrics;  ///< Destructed after the games, which count themselves
+	std::unique_ptr<BotPool> _bots;  ///< Null if the bots are disabled, destructed after the games
+	std::unique_ptr<GameCheckpoints> _checkpoints;  ///< Null if the games are not saved, destructed after the games
+	/// Players whose game can be resumed and who wait for their opponent to
+	/// look for a game too, with their name
+	std::unordered_map<UserId, std::string> _playersWaitingForResume;
 	std::vector<std::unique_ptr<GameThread>> _runningGames;
 	std::mutex _accessRunningGames;
+	TimerQueue _timers;  ///< Timers run by the main loop
+	std::vector<PendingConnection> _pendingConnections;
 
 	// private methods
-	/// Used to handle a new connection request (when the listener gets a packet)
+	/// Used to handle new connection requests (when the listener gets a packet).
+	/// The accepted sockets are non-blocking and wait for their first packet
+	/// in _pendingConnections, so that a slow client does not block the server.
 	void takeConnection(sf::TcpListener& listener);
 
-	/// Used to handle data sent by a logged user
+	/// Receives what is available on the pending connections, and dispatches
+	/// the ones whose first packet is complete
+	/// \return The number of connections dispatched
+	std::size_t advanceHandshakes();
+
+	/// Handles the first packet of a connection
+	void dispatchHandshake(sf::Packet& packet, std::unique_ptr<TcpConnection> client);
+
+	/// Closes a pending connection (called when its deadline is reached)
+	void dropPendingConnection(const TcpConnection* client);
+
+	/// Used to handle data sent by the logged users, all the ready ones are served
 	void receiveData();
 
+	/// Used to handle data sent by the logged user \a it
+	void receiveData(const _iterator& it);
+
 	/// Used to receive packet when the user want to connect.
 	/// This functions takes the ownership of the socket, so that the responsability
 	/// of deleting the object is transferred. For example, if the connection
 	/// does not succeded, the function can safely delete the socket. It is not
 	/// up to the caller to know whether the socket must be deleted or not.
-	void connectUser(sf::Packet& connectionPacket, std::unique_ptr<sf::TcpSocket> client);
+	void connectUser(sf::Packet& connectionPacket, std::unique_ptr<TcpConnection> client);
 
 	/// Used to receive packet when the user want to register.
 	/// See connectUser for informations about the smart pointer.
@@ -87,9 +130,30 @@ private:
 	/// Used to remove a player from the server connection
 	void removeClient(const _iterator& it);
 
+	/// Sends what is waiting in the send queues of the clients, without
+	/// blocking. The clients that are disconnected or whose queue is
+	/// overloaded (because they do not read their socket) are removed.
+	void flushClients();
+
+	/// Disconnects the clients that did not send anything (not even a
+	/// heartbeat) for longer than the idle timeout. Called periodically.
+	void evictIdleClients();
+
+	/// Gives the state of the lobby to the gauges of _metrics. Called periodically.
+	void updateGauges();
+
 	/// Used to tell whether or not a user is connected
 	void checkPresence(const _iterator& it, sf::Packet& transmission);
 
+	/// Pushes to the given connected users that \a name connected or disconnected
+	/// \param subscribers The names of the users to notify
+	/// \param name The name of the user whose presence changed
+	/// \param isOnline True if \a name connected, false if he disconnected
+	void notifyPresence(const std::vector<std::string>& subscribers, const std::string& name, bool isOnline);
+
+	/// Pushes to a single client that \a name connected or disconnected
+	void sendPresence(TcpConnection& client, const std::string& name, bool isOnline);
+
 	/// Used to send the list of friends of a user
 	void sendFriends(const _iterator& it);
 
@@ -113,12 +177,50 @@ private:
 	/// Used when a player wants to leave the lobby
 	void clearLobby(const _iterator& it);
 
+	/// Starts a game against a bot for \a playerName, if he is still waiting
+	/// for an opponent (called when the bot opponent delay is over)
+	void matchWithBot(const std::string& playerName);
+
+	/// Puts the player back in the game he was playing when the server
+	/// stopped, if any (see GameCheckpoints). The game starts once both
+	/// players look for an opponent.
+	/// \return True if the player has such a game, he is not matched with
+	/// another opponent then
+	/// \pre _lobbyMutex is locked
+	bool resumeGame(const _iterator& it);
+
+	/// Cancels the timer of matchWithBot, if any
+	/// \pre _lobbyMutex is locked
+	void cancelBotOpponentTimer();
+
 	/// Called by the new GameThread to start a game for two players
 	void startGame(std::size_t idx);
 
 	/// Starts the new thread for the new game
 	void createGame(UserId Id1, UserId Id2);
 
+	/// Starts the new thread for a game against a bot
+	void createBotGame(UserId playerId);
+
+	/// Starts the new thread for a game resumed from \a snapshot
+	void createResumedGame(const GameSnapshot& snapshot);
+
+	/// Gives the settings of the server to a new game
+	/// \pre _accessRunningGames is locked
+	void setUpGame(GameThread& game);
+
+	/// Used when a connected user asks to watch the game of a player, the
+	/// connection is given to the game (see GameThread::addSpectator). The
+	/// request must carry the session token of the user's connection to the
+	/// lobby, his name is not enough.
+	/// See connectUser for informations about the smart pointer.
+	void handleSpectateRequest(sf::Packet& packet, std::unique_ptr<TcpConnection> client);
+
+	/// Used when a client whose connection to its game failed asks to play
+	/// it again (see GameThread::reattach), the connection is closed once
+	/// the client is answered
+	void handleReconnectRequest(sf::Packet& packet, std::unique_ptr<TcpConnection> client);
+
 	//////////// Cards management
 
 	/// Used when the user wants its decks list
@@ -3,14 +3,67 @@
 
 // WizardPocker
 #include "common/CardData.hpp" // CommonCreatureData,... CostValue,...
+#include "common/GameData.hpp"  // CardToSelect
 // std-C++
 #include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// An effect of a card template, compiled when the templates are loaded (see
+/// CardEffects): its subject and its method are decoded and its arguments
+/// are checked, so that applying it only reads its fields.
+struct CardEffect
+{
+	/// The maximum number of arguments of an effect, after its subject and its method
+	static constexpr std::size_t maxArgsCount{5};
+
+	EffectSubject subject;  ///< Who the effect applies to
+	int method;             ///< PlayerEffect or CreatureEffect, according to the subject
+	std::array<int, maxArgsCount> args;
+	std::uint8_t argsCount;
+
+	/// \return The arguments of the method, valid as long as the effect
+	EffectArgs getArgs() const;
+};
+
+/// The effects of a card template, stored contiguously and compiled once
+/// for all when the template is created. A malformed effect (unknown
+/// subject or method, missing arguments, unknown constraint...) makes the
+/// template invalid, so that the rules never meet it during a game.
+class CardEffects
+{
+private:
+	std::vector<CardEffect> _effects;
+	std::vector<CardToSelect> _selection;
+
+public:
+	/// Constructor, compiles the effects
+	/// \param card The id of the card, for the error messages
+	/// \param isCreature True if the card is a creature, false for a spell
+	/// \param effects The parameters of each effect: its subject, its method
+	/// then its arguments
+	/// \throw std::runtime_error if an effect is not valid
+	CardEffects(CardId card, bool isCreature, const std::vector<EffectParamsCollection>& effects);
+
+	/// \return The number of effects
+	std::size_t size() const;
+
+	/// \return Where the player chooses the targets of the effects whose
+	/// subject is chosen (CREATURE_SELF_INDX, CREATURE_OPPO_INDX), in the
+	/// order of the effects, so that they are all asked at once
+	const std::vector<CardToSelect>& getSelection() const;
+
+	/// Iterators on the effects
+	std::vector<CardEffect>::const_iterator begin() const;
+	std::vector<CardEffect>::const_iterator end() const;
+};
 
 /// ServerCreatureData class: hold data of a creature card template (i.e. a card out-game)
 class ServerCreatureData : public CommonCreatureData
 {
 private:
-	std::vector<EffectParamsCollection> _effects; // To avoid a multiple inheritance, prohibited by INFOF204
+	CardEffects _effects; // To avoid a multiple inheritance, prohibited by INFOF204
 
 public:
 	/// Constructor
@@ -18,7 +71,7 @@ public:
 	                   int attack, int health, int shield, int shieldType);
 
 	/// Getters
-	const std::vector<EffectParamsCollection>& getEffects() const;
+	const CardEffects& getEffects() const;
 
 	virtual ~ServerCreatureData() = default;
 };
@@ -28,14 +81,14 @@ public:
 class ServerSpellData : public CommonSpellData
 {
 private:
-	std::vector<EffectParamsCollection> _effects; // To avoid a multiple inheritance, prohibited by INFOF204
+	CardEffects _effects; // To avoid a multiple inheritance, prohibited by INFOF204
 
 public:
 	/// Constructor
 	ServerSpellData(CardId, int cost, const std::vector<EffectParamsCollection>& effects);
 
 	/// Getters
-	const std::vector<EffectParamsCollection>& getEffects() const;
+	const CardEffects& getEffects() const;
 
 	virtual ~ServerSpellData() = default;
 };
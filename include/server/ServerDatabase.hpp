@@ -14,6 +14,7 @@
 #include "server/PostGameData.hpp"
 
 class Player;
+class CardArena;
 // Cards
 class Creature;
 class Spell;
@@ -31,8 +32,9 @@ public:
 	explicit ServerDatabase(const std::string& filename = FILENAME);
 
 	//////////////// Cards
-	/// Card* to be deallocated by the caller
-	Card* getCard(CardId card, Player& player);
+	/// Card* owned by \a arena
+	Card* getCard(CardId card, Player& player, CardArena& arena);
+	/// \return The data of \a card, nullptr if it does not exist
 	const CommonCardData* getCardData(CardId card);
 	/// Number of card templates in database
 	CardId countCards();
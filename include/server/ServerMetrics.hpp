@@ -0,0 +1,94 @@
+#ifndef _SERVER_METRICS_SERVER_HPP_
+#define _SERVER_METRICS_SERVER_HPP_
+
+// std-C++ headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+// SFML headers
+#include <SFML/Network/TcpListener.hpp>
+// WizardPoker headers
+#include "server/Histogram.hpp"
+#include "common/sockets/TransferType.hpp"
+
+/// Measures of the lobby of the server: a counter and the latency of each
+/// operation (split between the database and the rest), the time spent
+/// on the network, and gauges of the state of the server.
+/// The operations are recorded by the thread of the server only (see
+/// Histogram), the gauges can be set by any thread. The metrics are served
+/// in the Prometheus text format by a thread of their own (see startExporter),
+/// which reads them without locking.
+class ServerMetrics
+{
+public:
+	/// Number of measured operations: the packets that the lobby handles,
+	/// and one for the unknown ones
+	static constexpr std::size_t operationsCount{23};
+
+	/// Number of connected clients
+	std::atomic<std::uint64_t> connectedClients;
+
+	/// Number of players waiting for an opponent or for their opponent to
+	/// resume their game
+	std::atomic<std::uint64_t> lobbyDepth;
+
+	/// Number of accepted connections that did not send their first packet yet
+	std::atomic<std::uint64_t> pendingHandshakes;
+
+	/// Number of games being played
+	std::atomic<std::uint64_t> runningGames;
+
+	/// Constructor, nothing is served until startExporter is called
+	ServerMetrics();
+
+	ServerMetrics(const ServerMetrics&) = delete;
+	ServerMetrics& operator=(const ServerMetrics&) = delete;
+
+	/// Starts the thread that serves the metrics over HTTP, to the local
+	/// connections only (any request gets the metrics)
+	/// \return False if \a port could not be listened
+	bool startExporter(sf::Uint16 port);
+
+	/// Records an operation handled by the lobby
+	/// \param type The first field of the packet of the operation
+	/// \param duration Time taken to handle it, including \a databaseTime
+	/// \param databaseTime Time spent executing statements (see Database::getStepTime)
+	/// \pre Called by the thread of the server
+	void recordOperation(TransferType type, std::chrono::nanoseconds duration, std::chrono::nanoseconds databaseTime);
+
+	/// Records the reception of the packet of an operation
+	/// \param isDone False if the packet could not be received
+	/// \pre Called by the thread of the server
+	void recordReceive(std::chrono::steady_clock::time_point start, bool isDone);
+
+	/// Records the sending of what a loop of the server produced
+	/// \pre Called by the thread of the server
+	void recordSend(std::chrono::steady_clock::time_point start);
+
+	/// \return The metrics in the Prometheus text format
+	std::string display() const;
+
+	/// Destructor, stops the thread of the exporter
+	~ServerMetrics();
+
+private:
+	std::array<std::atomic<std::uint64_t>, operationsCount> _requests;
+	std::array<Histogram, operationsCount> _durations;
+	std::array<Histogram, operationsCount> _databaseTimes;
+	std::atomic<std::uint64_t> _receiveErrors;
+	Histogram _receiveTimes;
+	Histogram _sendTimes;
+
+	sf::TcpListener _listener;
+	std::atomic_bool _stopping;
+	std::thread _exporter;
+
+	/// Main loop of the thread of the exporter
+	void serve();
+};
+
+#endif  // _SERVER_METRICS_SERVER_HPP_
@@ -0,0 +1,80 @@
+#ifndef _SERVER_SETTINGS_SERVER_HPP_
+#define _SERVER_SETTINGS_SERVER_HPP_
+
+// std-C++ headers
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <algorithm>
+// WizardPoker headers
+#include "common/ini/IniFile.hpp"
+#include "server/TcpConnection.hpp"
+
+/// Tunable parameters of the server, read from the configuration file.
+/// Every parameter has a default value so that the keys are optional.
+struct ServerSettings
+{
+	/// Period of the heartbeats the clients must send (given to the clients at connection)
+	std::chrono::seconds heartbeatInterval{10};
+
+	/// A client that did not send anything during this time is disconnected
+	std::chrono::seconds idleTimeout{35};
+
+	/// An accepted connection that did not send its first packet (connection,
+	/// registering or chat request) during this time is closed
+	std::chrono::seconds handshakeTimeout{5};
+
+	/// A client whose send queue holds more bytes than this limit does not
+	/// read its socket and is disconnected
+	std::size_t sendQueueLimit{TcpConnection::defaultSendQueueLimit};
+
+	/// A player whose client is disconnected from its game has this time to
+	/// reconnect (see GameThread::reattach) before he loses the game, the
+	/// game is paused meanwhile. With zero, the player loses at the first
+	/// disconnection.
+	std::chrono::seconds reconnectionGrace{30};
+
+	/// Directory where the journals of the games are written (see GameJournal),
+	/// the games are not recorded if it is empty
+	std::string journalDirectory;
+
+	/// File where the running games save their state at each turn (see
+	/// GameCheckpoints), so that they are resumed after a restart of the
+	/// server. The games are not saved if it is empty.
+	std::string checkpointFile;
+
+	/// A player that waits for an opponent during this time plays against a
+	/// bot (see BotController), zero (the default) disables the bots
+	std::chrono::seconds botOpponentDelay{0};
+
+	/// Time given to a bot to choose each of its actions, from the moment it
+	/// is asked to (see BotSearch)
+	std::chrono::milliseconds botMoveBudget{500};
+
+	/// Number of threads shared by the bots of all the games (see BotPool)
+	std::size_t botThreadsCount{std::max(std::thread::hardware_concurrency() / 2, 1U)};
+
+	/// Maximum number of spectators of a game (see GameThread::addSpectator)
+	std::size_t maxSpectators{1000};
+
+	/// A spectator that could not be sent the state of its game during this
+	/// time (because it does not read it) is disconnected
+	std::chrono::seconds spectatorTimeout{10};
+
+	/// Period of the prints of the measures of each game (see GameStats),
+	/// zero (the default) disables them
+	std::chrono::seconds gameStatsInterval{0};
+
+	/// Port on which the metrics of the server are served to the local
+	/// connections, in the Prometheus text format (see ServerMetrics), zero
+	/// (the default) disables them
+	sf::Uint16 metricsPort{0};
+
+	/// Reads the values given in \a config, keeps the default for the missing keys
+	/// \param config The configuration file of the server
+	/// \return SUCCESS, or WRONG_FORMAT_CONFIG_FILE if a value is not valid
+	int readFromIni(IniFile& config);
+};
+
+#endif  // _SERVER_SETTINGS_SERVER_HPP_
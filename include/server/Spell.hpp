@@ -16,7 +16,7 @@ public:
 	Spell(const ServerSpellData&);
 
 	/// Effects interface
-	std::vector<EffectParamsCollection> getEffects();
+	const CardEffects& getEffects() const;
 };
 
 #endif //_SPELL_SERVER_HPP
@@ -0,0 +1,101 @@
+#ifndef _TCP_CONNECTION_SERVER_HPP_
+#define _TCP_CONNECTION_SERVER_HPP_
+
+// std-C++ headers
+#include <deque>
+#include <vector>
+#include <memory>
+#include <cstddef>
+// SFML headers
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/Time.hpp>
+
+/// sf::TcpSocket with access to the options of the underlying system socket,
+/// which SFML does not expose, and with a queue of outgoing packets.
+/// The packets given to queue are sent by flush, all at once with a single
+/// system call whenever possible, and without blocking: what the system
+/// cannot take yet stays in the queue for the next flush. Thus, a client
+/// that does not read its socket does not block the server.
+/// The packets are framed as sf::TcpSocket::send(sf::Packet&) does, so the
+/// receiver does not see any difference.
+class TcpConnection : public sf::TcpSocket
+{
+public:
+	/// A framed packet, it can be shared by the queues of several connections
+	/// so that a packet sent to many clients is framed only once
+	typedef std::shared_ptr<const std::vector<char>> Frame;
+
+	/// Default maximum amount of bytes waiting in the queue
+	static constexpr std::size_t defaultSendQueueLimit{256 * 1024};
+
+	/// Constructor
+	/// \param sendQueueLimit Maximum amount of bytes waiting in the queue
+	/// before the connection is considered as overloaded
+	explicit TcpConnection(std::size_t sendQueueLimit=defaultSendQueueLimit);
+
+	/// Enables the TCP keepalive probes so that a dead peer (e.g. a client whose
+	/// computer crashed) is detected by the system even if nothing is sent.
+	/// \param idleSeconds Time without any traffic before the first probe is sent
+	/// \param intervalSeconds Time between two probes
+	/// \param probes Number of unanswered probes before the connection is closed
+	/// \return True if the options could have been set
+	/// \pre The socket is connected
+	bool enableKeepAlive(int idleSeconds, int intervalSeconds, int probes);
+
+	/// Enables or disables the Nagle's algorithm. The packets are already
+	/// gathered by flush, so disabling it only removes latency.
+	/// \return True if the option could have been set
+	/// \pre The socket is connected
+	bool setNoDelay(bool noDelay);
+
+	/// \return The frame of \a packet, to be given to queue
+	static Frame makeFrame(const sf::Packet& packet);
+
+	/// Adds a packet at the end of the send queue, the packet is not sent
+	/// until flush is called
+	/// \return False if the queue is overloaded (the packet is queued anyway)
+	bool queue(sf::Packet& packet);
+
+	/// Adds a frame at the end of the send queue, \see queue(sf::Packet&)
+	bool queue(const Frame& frame);
+
+	/// Drops the frames of the queue whose sending has not started yet, the
+	/// first frame is kept if it is partially sent so that the peer does not
+	/// receive a truncated packet
+	void dropUnsentFrames();
+
+	/// Sends as much of the queue as possible without blocking
+	/// \return Done if the queue is empty, Partial if some data could not be
+	/// sent yet, Disconnected or Error if the connection failed
+	sf::Socket::Status flush();
+
+	/// Sends the whole queue, waiting for the socket to be writable if needed.
+	/// Used when an answer is expected right after the sending.
+	/// \param timeout Maximum time to wait for the peer, a peer that does not
+	/// read its socket must not block the caller
+	/// \return Done if the queue is empty, Disconnected or Error otherwise
+	/// (Error if the queue is overloaded or if \a timeout is elapsed)
+	sf::Socket::Status flushAll(sf::Time timeout);
+
+	/// Drops the data waiting to be sent
+	void clearQueue();
+
+	/// \return True if some data waits to be sent
+	bool hasPendingData() const;
+
+	/// \return True if the queue holds more data than its limit, the peer
+	/// does not read fast enough and should be disconnected
+	bool isOverloaded() const;
+
+private:
+	std::deque<Frame> _sendQueue;  ///< Framed packets waiting to be sent
+	std::size_t _frontOffset;      ///< Bytes of the first frame already sent
+	std::size_t _pendingBytes;     ///< Total of bytes waiting to be sent
+	const std::size_t _sendQueueLimit;
+
+	/// Removes \a sent bytes from the front of the queue
+	void consume(std::size_t sent);
+};
+
+#endif  // _TCP_CONNECTION_SERVER_HPP_
@@ -0,0 +1,67 @@
+#ifndef _TIMER_QUEUE_SERVER_HPP_
+#define _TIMER_QUEUE_SERVER_HPP_
+
+// std-C++ headers
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <unordered_set>
+#include <cstddef>
+
+/// Timers driven by the main loop of the server: the loop calls runExpired
+/// after each wait on the sockets, and the callbacks whose deadline is reached
+/// are called from the loop thread. Thus, a callback can safely access the
+/// data of the server without any lock.
+/// This class is not thread-safe.
+class TimerQueue
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	typedef std::function<void()> Callback;
+	typedef std::size_t TimerId;
+
+	/// Constructor
+	TimerQueue();
+
+	/// Schedules a callback to be called once
+	/// \param delay The time to wait before calling \a callback
+	/// \param callback The function to call
+	/// \return An identifier that can be given to cancel
+	TimerId schedule(Clock::duration delay, Callback callback);
+
+	/// Schedules a callback to be called periodically
+	/// \param period The time between two calls of \a callback
+	/// \param callback The function to call
+	/// \return An identifier that can be given to cancel
+	TimerId scheduleEvery(Clock::duration period, Callback callback);
+
+	/// Cancels a timer, does nothing if the timer has already expired
+	void cancel(TimerId id);
+
+	/// Calls the callbacks of all timers whose deadline is reached
+	/// \return The number of called callbacks
+	std::size_t runExpired();
+
+	/// Removes all timers
+	void clear();
+
+private:
+	struct Timer
+	{
+		Clock::time_point deadline;
+		TimerId id;
+		Clock::duration period;  ///< Zero for a timer called only once
+		Callback callback;
+	};
+
+	/// Comparison used to have the closest deadline at the top of the heap
+	static bool isLater(const Timer& lhs, const Timer& rhs);
+
+	TimerId push(Clock::duration delay, Clock::duration period, Callback callback);
+
+	std::vector<Timer> _timers;  ///< Heap of timers, the closest deadline on top
+	std::unordered_set<TimerId> _cancelled;
+	TimerId _nextId;
+};
+
+#endif  // _TIMER_QUEUE_SERVER_HPP_
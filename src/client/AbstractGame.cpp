@@ -32,8 +32,13 @@ void AbstractGame::init()
 	// receive in game data
 	_client.getGameSocket().receive(packet);
 	handlePacket(packet);
+	receiveGameStarting();
+}
 
+void AbstractGame::receiveGameStarting()
+{
 	// receive turn informations
+	sf::Packet packet;
 	_client.getGameSocket().receive(packet);
 	TransferType type;
 	packet >> type;
@@ -98,25 +103,20 @@ void AbstractGame::useCard(int cardIndex)
 	sf::Packet actionPacket;
 	actionPacket << TransferType::GAME_USE_CARD << static_cast<sf::Int32>(cardIndex);
 	_client.getGameSocket().send(actionPacket);
-	// receive amount of selection to make
 	_client.getGameSocket().receive(actionPacket);
 	TransferType responseHeader;
 	actionPacket >> responseHeader;
-	if(handleHeader(responseHeader))
-		return;
-	assert(responseHeader == TransferType::GAME_SEND_NB_OF_EFFECTS);
-	sf::Uint32 nbOfEffects;
-	actionPacket >> nbOfEffects;
-	for(sf::Uint32 i{0}; i < nbOfEffects; ++i)
+	// the targets of all the effects are asked at once, if there are some
+	if(responseHeader == TransferType::GAME_SELECT_CARDS)
 	{
-		_client.getGameSocket().receive(actionPacket);
 		// ask and send the additionnal inputs to the server
-		if(not treatAdditionnalInputs(actionPacket))
-			return;
+		treatAdditionnalInputs(actionPacket);
+		// receive status of operation from server
+		_client.getGameSocket().receive(actionPacket);
+		actionPacket >> responseHeader;
 	}
-	// receive status of operation from server
-	_client.getGameSocket().receive(actionPacket);
-	actionPacket >> responseHeader;
+	if(handleHeader(responseHeader))
+		return;
 	switch(responseHeader)
 	{
 	case TransferType::ACKNOWLEDGE:
@@ -131,35 +131,8 @@ void AbstractGame::useCard(int cardIndex)
 	}
 }
 
-bool AbstractGame::treatAdditionnalInputs(sf::Packet& actionPacket)
+void AbstractGame::treatAdditionnalInputs(sf::Packet& actionPacket)
 {
-	TransferType responseHeader;
-	actionPacket >> responseHeader;
-	switch(responseHeader)
-	{
-	case TransferType::FAILURE:
-		displayMessage("No card to select, unable to play this card!");
-		return false;
-
-	case TransferType::GAME_NOT_ENOUGH_ENERGY:
-		displayMessage("You have not enough energy to use this card.");
-		return false;
-
-	case TransferType::GAME_CARD_LIMIT_TURN_REACHED:
-		displayMessage("You can't use more cards, the limit is reached.");
-		return false;
-
-	// note the case here so that ACKNOWLEDGE is not taken as `default`
-	// but the code for ACKNOWLEDGE is after the switch
-	case TransferType::ACKNOWLEDGE:
-		break;
-
-	default:
-		std::cerr << "Unexpected value: " << static_cast<sf::Uint32>(responseHeader) << std::endl;
-		return false;
-	}
-
-	assert(responseHeader == TransferType::ACKNOWLEDGE);
 	std::vector<CardToSelect> requiredInputs;
 	actionPacket >> requiredInputs;
 
@@ -195,9 +168,8 @@ bool AbstractGame::treatAdditionnalInputs(sf::Packet& actionPacket)
 		}
 	}
 	sf::Packet indicesPacket;
-	indicesPacket << indices;
+	indicesPacket << TransferType::GAME_SELECT_CARDS << indices;
 	_client.getGameSocket().send(indicesPacket);
-	return true;
 }
 
 void AbstractGame::attackWithCreature(int selfCardIndex, bool attackOpponent, int opponentCardIndex)
@@ -301,7 +273,14 @@ void AbstractGame::inputListening()
 			continue;
 		assert(selector.isReady(listeningSocket));
 		auto receiveStatus{listeningSocket.receive(receivedPacket)};
-		if(receiveStatus == sf::Socket::Disconnected)
+		if(receiveStatus == sf::Socket::Disconnected and reconnect())
+		{
+			// the socket has been connected again, its handle changed
+			selector.clear();
+			selector.add(listeningSocket);
+			updateDisplay();
+		}
+		else if(receiveStatus == sf::Socket::Disconnected)
 		{
 			std::cerr << "Connection lost with the server\n";
 			_playing.store(false);
@@ -321,6 +300,34 @@ void AbstractGame::inputListening()
 	}
 }
 
+bool AbstractGame::reconnect()
+{
+	// the server gives the token only if it keeps the game of a disconnected player
+	if(_sessionToken == 0 or not _playing.load())
+		return false;
+	displayMessage("Connection lost with the game, trying to reconnect...");
+	// no action is sent until the game is back
+	_myTurn.store(false);
+	if(not _client.reconnectToGame(_sessionToken))
+		return false;
+	// the server sends the whole state again, then the turn, as at the start of the game
+	sf::Packet packet;
+	if(_client.getGameSocket().receive(packet) != sf::Socket::Done)
+		return false;
+	handlePacket(packet);
+	try
+	{
+		receiveGameStarting();
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return false;
+	}
+	displayMessage("Reconnected to the game.");
+	return true;
+}
+
 void AbstractGame::onListeningThreadCreation()
 {
 	// Enpty body to be overriden
@@ -380,6 +387,10 @@ void AbstractGame::handlePacket(sf::Packet& transmission)
 			endGame(transmission);
 			break;
 
+		case TransferType::GAME_SESSION_TOKEN:
+			transmission >> _sessionToken;
+			break;
+
 		case TransferType::GAME_PLAYER_ENTER_TURN:
 			displayMessage("You got the turn");
 			_myTurn.store(true);
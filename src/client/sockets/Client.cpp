@@ -1,5 +1,6 @@
 // SFML headers
 #include <SFML/System/Sleep.hpp>
+#include <SFML/System/Clock.hpp>
 #include <SFML/Network/IpAddress.hpp>
 #include <SFML/Network/SocketSelector.hpp>
 // WizardPoker headers
@@ -25,6 +26,9 @@ Client::Client(bool isGui):
 	_isConnected{false},
 	_serverPort{0},
 	_threadLoop{false},
+	_heartbeatLoop{false},
+	_heartbeatInterval{},
+	_sessionToken{0},
 	_isGui{isGui},
 	_inGame{false},
 	_readyToPlay{false}
@@ -55,11 +59,11 @@ void Client::sendConnectionToken(const std::string& password)
 	       << _name
 	       << password
 	       << static_cast<sf::Uint16>(_chatListenerPort);
-	if(_socket.send(packet) != sf::Socket::Done)
+	if(sendToServer(packet) != sf::Socket::Done)
 		throw std::runtime_error("failed to send connection packet.");
 
 	// Receive the server response
-	_socket.receive(packet);
+	receiveFromServer(packet);
 	TransferType response;
 	packet >> response;
 	switch(response)
@@ -71,9 +75,16 @@ void Client::sendConnectionToken(const std::string& password)
 		throw std::runtime_error("invalid username or password.");
 
 	case TransferType::ACKNOWLEDGE:
+	{
+		sf::Uint32 heartbeatSeconds;
+		packet >> heartbeatSeconds >> _sessionToken;
+		_heartbeatInterval = sf::seconds(static_cast<float>(heartbeatSeconds));
 		_isConnected = true;
+		_heartbeatLoop.store(true);
+		_heartbeatThread = std::thread(&Client::sendHeartbeats, this);
 		updateFriends();
 		break;
+	}
 
 	default:
 		throw std::runtime_error("unidentified server response.");
@@ -155,8 +166,11 @@ void Client::quit()
 		// tell the server that the player leaves
 		sf::Packet packet;
 		packet << TransferType::DISCONNECTION;
-		_socket.send(packet);
+		sendToServer(packet);
 	}
+	_heartbeatLoop.store(false);
+	if(_heartbeatThread.joinable())
+		_heartbeatThread.join();
 	// If a connection failed, the socket is connected but the server
 	// no longer listen to it, so quit must be called even if _isConnected is false
 	_socket.disconnect();
@@ -166,6 +180,7 @@ void Client::quit()
 	if(_listenerThread.joinable())
 		_listenerThread.join();
 	_isConnected = false;
+	_presentFriends.clear();
 }
 
 Client::~Client()
@@ -180,7 +195,7 @@ void Client::enterLobby()
 	// send a request for the server to place the client in its internal lobby
 	sf::Packet packet;
 	packet << TransferType::GAME_REQUEST;
-	_socket.send(packet);
+	sendToServer(packet);
 	// use a selector to
 	sf::SocketSelector selector;
 	selector.add(_socket);
@@ -190,18 +205,26 @@ void Client::leaveLobby()
 {
 	sf::Packet leavingPacket;
 	leavingPacket << TransferType::GAME_CANCEL_REQUEST;
-	_socket.send(leavingPacket);
+	sendToServer(leavingPacket);
 }
 
 bool Client::isGameStarted(std::string& opponentName)
 {
 	sf::Packet opponentPacket;
-	_socket.setBlocking(false);
-	bool ret{_socket.receive(opponentPacket) == sf::Socket::Done};
-	_socket.setBlocking(true);
+	bool ret{false};
+	{
+		// the heartbeat thread must not send while the socket is non-blocking
+		std::lock_guard<std::mutex> lockSend{_sendAccess};
+		_socket.setBlocking(false);
+		// skip the notifications that were pushed while waiting in the lobby
+		while(not ret and _socket.receive(opponentPacket) == sf::Socket::Done)
+			ret = not handleServerNotification(opponentPacket);
+		_socket.setBlocking(true);
+	}
 	if(ret)
 	{
-		opponentPacket >> opponentName;
+		TransferType header;
+		opponentPacket >> header >> opponentName;
 		_inGame = true;
 	}
 	return ret;
@@ -230,6 +253,44 @@ void Client::endGame()
 	_readyToPlay.store(false);
 }
 
+bool Client::reconnectToGame(SessionToken token)
+{
+	if(!_inGame)
+		throw std::runtime_error("unable to reconnect: not in game.");
+	// the game connects to the listening thread, as at the start of the game
+	if(_chatListenerPort == 0)
+		return false;
+	// the network may take some time to come back, the server keeps the game meanwhile
+	static const sf::Time retryingPeriod(sf::seconds(60));
+	static const sf::Time retryingDelay(sf::seconds(1));
+	sf::Clock clock;
+	_readyToPlay.store(false);
+	TransferType response{TransferType::FAILURE};
+	bool isAnswered{false};
+	while(!isAnswered and clock.getElapsedTime() < retryingPeriod)
+	{
+		// a new connection, the lobby one may have been lost too
+		sf::TcpSocket socket;
+		sf::Packet packet;
+		packet << TransferType::GAME_RECONNECT << token << static_cast<sf::Uint16>(_chatListenerPort);
+		isAnswered = socket.connect(_serverAddress, _serverPort, retryingDelay) == sf::Socket::Done
+		             and socket.send(packet) == sf::Socket::Done
+		             and socket.receive(packet) == sf::Socket::Done
+		             and (packet >> response);
+		if(!isAnswered)
+			sf::sleep(retryingDelay);
+	}
+	if(response != TransferType::ACKNOWLEDGE)
+		return false;
+	// the game connects to the client at its next tick (see initInGameConnection)
+	static const sf::Time connectionPeriod(sf::seconds(10));
+	static const sf::Time awaitingDelay(sf::milliseconds(50));
+	clock.restart();
+	while(!_readyToPlay.load() and clock.getElapsedTime() < connectionPeriod)
+		sf::sleep(awaitingDelay);
+	return _readyToPlay.load();
+}
+
 void Client::waitTillReadyToPlay()
 {
 	static const sf::Time awaitingDelay(sf::milliseconds(50));  // arbitrary
@@ -261,28 +322,69 @@ FriendsList Client::getConnectedFriends()
 {
 	if(!_isConnected)
 		throw NotConnectedException("unable to send connected friends.");
+	// this also handles the presence notifications pushed since the last request
 	updateFriends();
 	FriendsList connectedFriends;
 	for(const auto& friendUser: _friends)
-	{
-		// ask the server if player is conencted
-		sf::Packet packet;
-		packet << TransferType::CHECK_PRESENCE << friendUser.name;
-		_socket.send(packet);
-		_socket.receive(packet);
-		TransferType type;
-		packet >> type;
-		if(type == TransferType::FAILURE)
-			throw std::runtime_error("Unable to check " + friendUser.name + " presence: not friends");
-		bool isPresent;
-		packet >> isPresent;
 		// add to vector only if friend is present
-		if(isPresent)
+		if(_presentFriends.count(friendUser.name) > 0)
 			connectedFriends.push_back(friendUser);
-	}
 	return connectedFriends;
 }
 
+sf::Socket::Status Client::sendToServer(sf::Packet& packet)
+{
+	std::lock_guard<std::mutex> lockSend{_sendAccess};
+	return _socket.send(packet);
+}
+
+// function called by a new thread only
+void Client::sendHeartbeats()
+{
+	// sleep by small steps so that the loop variable is checked frequently enough
+	static const sf::Time sleepingStep(sf::milliseconds(100));
+	sf::Time elapsed;
+	while(_heartbeatLoop.load())
+	{
+		sf::sleep(sleepingStep);
+		elapsed += sleepingStep;
+		if(elapsed < _heartbeatInterval)
+			continue;
+		elapsed = sf::Time::Zero;
+		sf::Packet packet;
+		packet << TransferType::HEARTBEAT;
+		sendToServer(packet);
+	}
+}
+
+sf::Socket::Status Client::receiveFromServer(sf::Packet& packet)
+{
+	sf::Socket::Status status;
+	do
+		status = _socket.receive(packet);
+	while(status == sf::Socket::Done and handleServerNotification(packet));
+	return status;
+}
+
+bool Client::handleServerNotification(const sf::Packet& packet)
+{
+	// work on a copy so that the packet is left untouched if this is not a notification
+	sf::Packet notification{packet};
+	TransferType type;
+	notification >> type;
+	if(type != TransferType::FRIEND_PRESENCE_UPDATE)
+		return false;
+
+	std::string friendName;
+	bool isOnline;
+	notification >> friendName >> isOnline;
+	if(isOnline)
+		_presentFriends.insert(friendName);
+	else
+		_presentFriends.erase(friendName);
+	return true;
+}
+
 const FriendsList& Client::getFriendshipRequests()
 {
 	if(!_isConnected)
@@ -296,8 +398,8 @@ void Client::updateFriends()
 	sf::Packet packet;
 	// send that friends list is asked
 	packet << TransferType::ASK_FRIENDS;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -312,8 +414,8 @@ void Client::updateFriendshipRequests()
 	sf::Packet packet;
 	// send that requests list is asked
 	packet << TransferType::GET_FRIEND_REQUESTS;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -334,9 +436,9 @@ void Client::sendFriendshipRequest(const std::string& name)
 		throw std::runtime_error(name + "is already your friend.");
 	sf::Packet packet;
 	packet << TransferType::NEW_FRIEND << name;
-	_socket.send(packet);
+	sendToServer(packet);
 	// server acknowledges with ACKNOWLEDGE if request was correctly made and by NOT_EXISTING_FRIEND otherwise
-	_socket.receive(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -362,8 +464,8 @@ void Client::removeFriend(const std::string& name)
 	// send that the user remove name from its friend list
 	packet << TransferType::REMOVE_FRIEND;
 	packet << name;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -374,8 +476,8 @@ void Client::acceptFriendshipRequest(const std::string& name, bool accept)
 {
 	sf::Packet packet;
 	packet << TransferType::RESPONSE_FRIEND_REQUEST << name << accept;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader == TransferType::NOT_EXISTING_FRIEND)
@@ -478,8 +580,9 @@ void Client::initInGameConnection(sf::Packet& transmission)
 {
 	sf::Uint16 serverListeningPort;
 	transmission >> serverListeningPort;
-	_inGameSocket.connect(_socket.getRemoteAddress(), serverListeningPort);
-	_inGameListeningSocket.connect(_socket.getRemoteAddress(), serverListeningPort);
+	// the connection to the lobby may be lost when the game connects again (see reconnectToGame)
+	_inGameSocket.connect(_serverAddress, serverListeningPort);
+	_inGameListeningSocket.connect(_serverAddress, serverListeningPort);
 	_readyToPlay.store(true);
 }
 
@@ -492,8 +595,8 @@ std::vector<Deck> Client::getDecks()
 	sf::Packet packet;
 	// send that friends list is asked
 	packet << TransferType::ASK_DECKS_LIST;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -510,8 +613,8 @@ void Client::handleDeckEditing(const Deck& editedDeck)
 	sf::Packet packet;
 	// send that friends list is asked
 	packet << TransferType::EDIT_DECK << editedDeck;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -525,8 +628,8 @@ void Client::handleDeckCreation(const Deck& createdDeck)
 	sf::Packet packet;
 	// send that friends list is asked
 	packet << TransferType::CREATE_DECK << createdDeck;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -540,8 +643,8 @@ void Client::handleDeckDeletion(const std::string& deletedDeckName)
 	sf::Packet packet;
 	// send that friends list is asked
 	packet << TransferType::DELETE_DECK << deletedDeckName;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -555,8 +658,8 @@ CardsCollection Client::getCardsCollection()
 	sf::Packet packet;
 	// send that friends list is asked
 	packet << TransferType::ASK_CARDS_COLLECTION;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -589,8 +692,8 @@ Ladder Client::getLadder()
 	sf::Packet packet;
 	// send that friends list is asked
 	packet << TransferType::ASK_LADDER;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
@@ -607,8 +710,8 @@ ClientAchievementList Client::getAchievements()
 	sf::Packet packet;
 	// send that achievements list is asked
 	packet << TransferType::ASK_ACHIEVEMENTS;
-	_socket.send(packet);
-	_socket.receive(packet);
+	sendToServer(packet);
+	receiveFromServer(packet);
 	TransferType responseHeader;
 	packet >> responseHeader;
 	if(responseHeader != TransferType::ACKNOWLEDGE)
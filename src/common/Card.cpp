@@ -1,7 +1,10 @@
 #include "common/Card.hpp"
 
 Card::Card(const CommonCardData& cardData):
-	_prototype(cardData), _cost(cardData.getCost())
+	_prototype(cardData),
+	_id(cardData.getId()),
+	_isCreature(cardData.isCreature()),
+	_cost(cardData.getCost())
 {
 }
 
@@ -12,15 +15,15 @@ int Card::getEnergyCost() const
 
 CardId Card::getId() const
 {
-	return _prototype.getId();
+	return _id;
 }
 
 bool Card::isCreature() const
 {
-	return _prototype.isCreature();
+	return _isCreature;
 }
 
 bool Card::isSpell() const
 {
-	return _prototype.isSpell();
+	return not _isCreature;
 }
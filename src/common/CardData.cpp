@@ -1,6 +1,9 @@
 // WizardPoker headers
 #include "common/GameData.hpp"
 #include "common/CardData.hpp"
+// std-C++ headers
+#include <stdexcept>
+#include <algorithm>
 
 // CommonCardData base class
 CommonCardData::CommonCardData(CardId id, int cost) :
@@ -80,41 +83,62 @@ bool CommonSpellData::isSpell() const
 
 constexpr std::array<const char *, 4> BoardCreatureData::shieldTypes;
 
+constexpr std::size_t EffectArgs::_maxListSize;
+
 EffectArgs::EffectArgs(const EffectParamsCollection& args):
-	_args(args),
+	_list(),
+	_args(args.data()),
+	_size{args.size()},
 	_index{0}
 {
 
 }
 
-EffectArgs::EffectArgs(const std::initializer_list<int>& args):
+EffectArgs::EffectArgs(const int* args, std::size_t size):
+	_list(),
 	_args(args),
+	_size{size},
 	_index{0}
 {
 
 }
 
+EffectArgs::EffectArgs(std::initializer_list<int> args):
+	_list(),
+	_args(nullptr),
+	_size{args.size()},
+	_index{0}
+{
+	if(_size > _maxListSize)
+		throw std::length_error("EffectArgs: too many values in the list");
+	std::copy(args.begin(), args.end(), _list.begin());
+}
+
 int EffectArgs::getArg()
 {
-	return _args.at(_index++);
+	const int arg{peekArg()};
+	_index++;
+	return arg;
 }
 
 int EffectArgs::peekArg() const
 {
-	return _args.at(_index);
+	if(_index >= _size)
+		throw std::out_of_range("EffectArgs: no parameter left");
+	return _args != nullptr ? _args[_index] : _list[_index];
 }
 
 int EffectArgs::remainingArgs() const
 {
-	return static_cast<int>(_args.size() - _index);
+	return static_cast<int>(_size - _index);
 }
 
 std::string EffectArgs::toString() const
 {
 	std::stringstream ss;
 	ss << "[";
-	for(size_t i = _index; i < _args.size(); ++i)
-		ss << _args.at(i) << (i+1 == _args.size() ? "" : ", ");
+	for(size_t i = _index; i < _size; ++i)
+		ss << (_args != nullptr ? _args[i] : _list[i]) << (i+1 == _size ? "" : ", ");
 	ss << "]";
 	return ss.str();
 }
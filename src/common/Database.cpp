@@ -3,6 +3,10 @@
 #include <string>
 #include <cstring>
 
+/// Time spent in Database::step by the thread, each thread has its own
+/// counter so that the measures do not need any synchronization
+static thread_local std::chrono::nanoseconds stepTime{0};
+
 Database::Database(const std::string& filename)
 {
 	sqliteThrowExcept(sqlite3_open(filename.c_str(), &_database));
@@ -15,6 +19,19 @@ void Database::prepareStmt(Statement& statement)
 	                                     statement.statement(), nullptr));
 }
 
+std::chrono::nanoseconds Database::getStepTime()
+{
+	return stepTime;
+}
+
+int Database::step(sqlite3_stmt* statement)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	const int errcode{sqlite3_step(statement)};
+	stepTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+	return errcode;
+}
+
 Database::~Database()
 {
 	// TODO finalize all prepared statements, close all BLOB handles, and finish all sqlite3_backup objects associated with the sqlite3 object
@@ -1,14 +1,80 @@
 #include "common/random/RandomInteger.hpp"
+// std-C++ headers
+#include <random>
+#include <cassert>
+
+/// \return \a value rotated to the left by \a shift bits
+static inline std::uint32_t rotateLeft(std::uint32_t value, int shift)
+{
+	return (value << shift) | (value >> (32 - shift));
+}
 
 RandomInteger::RandomInteger():
-	_device{},
-	_generator{_device()}
+	RandomInteger(std::random_device{}())
 {
 
 }
 
+RandomInteger::RandomInteger(Seed seed):
+	_seed{seed},
+	_state()
+{
+	setSeed(seed);
+}
+
 int RandomInteger::next(int upperBound, int lowerBound)
 {
-	// as lowerBound is the first non possible number, remove 1 before to generate
-	return std::uniform_int_distribution<int>(lowerBound, upperBound-1)(_generator);
+	assert(lowerBound < upperBound);
+	const std::uint32_t range{static_cast<std::uint32_t>(upperBound) - static_cast<std::uint32_t>(lowerBound)};
+	// the high half of bits * range is in [0, range), it is uniform once the
+	// few low halves that would bias it are rejected (Lemire's method, only
+	// computes a division in the rare case where a rejection is possible)
+	std::uint64_t product{static_cast<std::uint64_t>(nextBits()) * range};
+	std::uint32_t low{static_cast<std::uint32_t>(product)};
+	if(low < range)
+	{
+		const std::uint32_t threshold{(0U - range) % range};
+		while(low < threshold)
+		{
+			product = static_cast<std::uint64_t>(nextBits()) * range;
+			low = static_cast<std::uint32_t>(product);
+		}
+	}
+	return lowerBound + static_cast<int>(product >> 32);
+}
+
+RandomInteger::Seed RandomInteger::getSeed() const
+{
+	return _seed;
+}
+
+void RandomInteger::setSeed(Seed seed)
+{
+	_seed = seed;
+	// the state is filled by splitmix64, so that close seeds give unrelated
+	// sequences and the state is never zero
+	std::uint64_t mixer{seed};
+	for(std::size_t i{0}; i < _state.size(); i += 2)
+	{
+		mixer += 0x9E3779B97F4A7C15ULL;
+		std::uint64_t value{mixer};
+		value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+		value ^= value >> 31;
+		_state[i] = static_cast<std::uint32_t>(value);
+		_state[i + 1] = static_cast<std::uint32_t>(value >> 32);
+	}
+}
+
+std::uint32_t RandomInteger::nextBits()
+{
+	const std::uint32_t result{rotateLeft(_state[1] * 5, 7) * 9};
+	const std::uint32_t shifted{_state[1] << 9};
+	_state[2] ^= _state[0];
+	_state[3] ^= _state[1];
+	_state[1] ^= _state[2];
+	_state[0] ^= _state[3];
+	_state[2] ^= shifted;
+	_state[3] = rotateLeft(_state[3], 11);
+	return result;
 }
@@ -0,0 +1,219 @@
+// WizardPoker headers
+#include "server/BalanceSimulator.hpp"
+#include "server/GameSimulation.hpp"
+#include "server/GamePolicy.hpp"
+// std-C++ headers
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <stdexcept>
+#include <cassert>
+#include <iostream>
+
+constexpr std::size_t BalanceSimulator::_maxCopies;
+
+/// SplitMix64 step: derives independent seeds from a counter
+static std::uint64_t splitMix(std::uint64_t& state)
+{
+	std::uint64_t value{state += 0x9E3779B97F4A7C15ULL};
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+/// \return A seed for a RandomInteger
+static RandomInteger::Seed nextSeed(std::uint64_t& state)
+{
+	return static_cast<RandomInteger::Seed>(splitMix(state) >> 32);
+}
+
+/// Games still to be played by a thread of BalanceSimulator::run
+struct GamesRange
+{
+	std::mutex mutex;
+	std::size_t begin;
+	std::size_t end;
+};
+
+/// Takes the next game of \a range
+/// \return False if the range is empty
+static bool takeGame(GamesRange& range, std::size_t& gameIndex)
+{
+	std::lock_guard<std::mutex> lock{range.mutex};
+	if(range.begin == range.end)
+		return false;
+	gameIndex = range.begin++;
+	return true;
+}
+
+/// Steals the second half of the games of another thread
+/// \param ranges The ranges of all the threads
+/// \param thief The index of the range of the thread that steals, empty
+/// \return False if all the ranges are empty
+static bool stealGames(std::vector<std::unique_ptr<GamesRange>>& ranges, std::size_t thief, std::size_t& gameIndex)
+{
+	for(std::size_t i{1}; i < ranges.size(); ++i)
+	{
+		GamesRange& victim(*ranges[(thief + i) % ranges.size()]);
+		std::size_t begin, end;
+		{
+			std::lock_guard<std::mutex> lock{victim.mutex};
+			if(victim.begin == victim.end)
+				continue;
+			// the victim keeps the first half, at least the game it would take next
+			begin = victim.begin + (victim.end - victim.begin) / 2;
+			end = victim.end;
+			if(begin == victim.begin)
+				begin = victim.begin++;
+			else
+				victim.end = begin;
+		}
+		// the thief is the only one to fill its own range
+		std::lock_guard<std::mutex> lock{ranges[thief]->mutex};
+		gameIndex = begin;
+		ranges[thief]->begin = begin + 1;
+		ranges[thief]->end = end;
+		return true;
+	}
+	return false;
+}
+
+///////////////////////// BalanceReport
+
+void BalanceReport::merge(const BalanceReport& other)
+{
+	assert(cards.size() == other.cards.size());
+	gamesCount += other.gamesCount;
+	draws += other.draws;
+	errors += other.errors;
+	if(gameLengths.size() < other.gameLengths.size())
+		gameLengths.resize(other.gameLengths.size(), 0);
+	for(std::size_t i{0}; i < other.gameLengths.size(); ++i)
+		gameLengths[i] += other.gameLengths[i];
+	for(std::size_t i{0}; i < cards.size(); ++i)
+	{
+		cards[i].decks += other.cards[i].decks;
+		cards[i].wins += other.cards[i].wins;
+	}
+}
+
+///////////////////////// BalanceSimulator
+
+BalanceSimulator::BalanceSimulator(ServerDatabase& database, std::uint64_t seed):
+	_database(database),
+	_seed(seed),
+	_cardIds(database.getFirstCardIds(static_cast<unsigned>(database.countCards())))
+{
+	std::sort(_cardIds.begin(), _cardIds.end());
+	if(_cardIds.size() * _maxCopies < Deck::size)
+		throw std::runtime_error("Not enough cards in the database to build a deck");
+}
+
+BalanceReport BalanceSimulator::makeEmptyReport() const
+{
+	BalanceReport report{0, 0, 0, {}, {}};
+	for(const CardId card: _cardIds)
+		report.cards.push_back({card, 0, 0});
+	return report;
+}
+
+BalanceReport BalanceSimulator::run(std::size_t gamesCount, unsigned threadsCount)
+{
+	threadsCount = std::max(threadsCount, 1U);
+	// each thread starts with a contiguous share of the games
+	std::vector<std::unique_ptr<GamesRange>> ranges;
+	for(std::size_t i{0}; i < threadsCount; ++i)
+	{
+		ranges.emplace_back(new GamesRange);
+		ranges.back()->begin = gamesCount * i / threadsCount;
+		ranges.back()->end = gamesCount * (i + 1) / threadsCount;
+	}
+	std::vector<BalanceReport> reports(threadsCount, makeEmptyReport());
+	auto worker = [this, &ranges, &reports](std::size_t self)
+	{
+		std::size_t gameIndex;
+		while(takeGame(*ranges[self], gameIndex) or stealGames(ranges, self, gameIndex))
+			playGame(gameIndex, reports[self]);
+	};
+	std::vector<std::thread> threads;
+	for(std::size_t i{1}; i < threadsCount; ++i)
+		threads.emplace_back(worker, i);
+	worker(0);
+	for(auto& thread: threads)
+		thread.join();
+
+	// the results are sums, the order of the merge does not matter
+	BalanceReport report{makeEmptyReport()};
+	for(const auto& threadReport: reports)
+		report.merge(threadReport);
+	return report;
+}
+
+void BalanceSimulator::playGame(std::size_t gameIndex, BalanceReport& report)
+{
+	std::uint64_t state{_seed};
+	state = splitMix(state) ^ static_cast<std::uint64_t>(gameIndex);
+	RandomInteger deckGenerator{nextSeed(state)};
+	const Deck deck1{sampleDeck(deckGenerator)};
+	const Deck deck2{sampleDeck(deckGenerator)};
+	RandomPolicy policy1{nextSeed(state)};
+	RandomPolicy policy2{nextSeed(state)};
+	GameSimulation game(_database, nextSeed(state));
+	report.gamesCount++;
+	UserId winnerId;
+	try
+	{
+		winnerId = game.play(deck1, policy1, deck2, policy2);
+	}
+	catch(const std::exception& e)
+	{
+		// the game can be played again alone with the same seed and index
+		std::cerr << "Game " << gameIndex << " interrupted: " << e.what() << "\n";
+		report.errors++;
+		return;
+	}
+
+	if(winnerId == 0)
+		report.draws++;
+	const std::size_t turns{static_cast<std::size_t>(game.getTurnsCount())};
+	if(report.gameLengths.size() <= turns)
+		report.gameLengths.resize(turns + 1, 0);
+	report.gameLengths[turns]++;
+	addDeck(deck1, winnerId == 1, report);
+	addDeck(deck2, winnerId == 2, report);
+}
+
+Deck BalanceSimulator::sampleDeck(RandomInteger& generator) const
+{
+	// partial Fisher-Yates shuffle of the copies of all the cards
+	std::vector<CardId> copies;
+	copies.reserve(_cardIds.size() * _maxCopies);
+	for(const CardId card: _cardIds)
+		copies.insert(copies.end(), _maxCopies, card);
+	std::array<CardId, Deck::size> cards;
+	for(std::size_t i{0}; i < Deck::size; ++i)
+	{
+		const std::size_t chosen{i + static_cast<std::size_t>(generator.next(static_cast<int>(copies.size() - i)))};
+		std::swap(copies[i], copies[chosen]);
+		cards[i] = copies[i];
+	}
+	return Deck("", cards);
+}
+
+void BalanceSimulator::addDeck(const Deck& deck, bool hasWon, BalanceReport& report) const
+{
+	std::array<CardId, Deck::size> cards;
+	std::copy(deck.begin(), deck.end(), cards.begin());
+	std::sort(cards.begin(), cards.end());
+	const auto last = std::unique(cards.begin(), cards.end());
+	for(auto it = cards.begin(); it != last; ++it)
+	{
+		CardBalance& balance(report.cards[static_cast<std::size_t>(
+				std::lower_bound(_cardIds.begin(), _cardIds.end(), *it) - _cardIds.begin())]);
+		balance.decks++;
+		if(hasWon)
+			balance.wins++;
+	}
+}
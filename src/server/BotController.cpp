@@ -0,0 +1,67 @@
+// WizardPoker headers
+#include "server/BotController.hpp"
+#include "server/Player.hpp"
+// std-C++ headers
+#include <limits>
+
+constexpr UserId BotController::botId;
+const std::string BotController::botName{"WizardBot"};
+
+BotController::BotController(BotPool& pool, ServerDatabase& database, std::chrono::milliseconds moveBudget,
+		const Player& self, const Player& opponent):
+	_pool(pool),
+	_database(database),
+	_moveBudget(moveBudget),
+	_self(self),
+	_opponent(opponent),
+	_generator(),
+	_selectionPolicy(_generator.getSeed()),
+	_search(),
+	_start()
+{
+}
+
+void BotController::setStartingState(const GameSnapshot& snapshot)
+{
+	_start = std::make_shared<const GameSnapshot>(snapshot);
+}
+
+void BotController::send(sf::Packet& /* packet */)
+{
+}
+
+bool BotController::selectCards(const std::vector<CardToSelect>& selection, std::vector<int>& indices)
+{
+	// the selection is a part of an action that has already been searched
+	indices = _selectionPolicy.selectCards(_self, _opponent, selection);
+	return true;
+}
+
+bool BotController::pollAction(const GameJournal& journal, PlayerAction& action)
+{
+	const std::vector<JournalRecord>& records(journal.getRecords());
+	// the game went on since the search started (e.g. the turn timed out)
+	if(_search != nullptr and _search->getRecordsCount() != records.size())
+	{
+		_search->cancel();
+		_search.reset();
+	}
+	if(_search == nullptr)
+	{
+		const RandomInteger::Seed seed{static_cast<RandomInteger::Seed>(_generator.next(std::numeric_limits<int>::max()))};
+		_search = std::make_shared<BotSearch>(_database, journal.getHeader(), records, _self.getId(), _moveBudget, seed, _start);
+		_pool.submit(_search);
+		return false;
+	}
+	if(not _search->isDone())
+		return false;
+	action = _search->getAction();
+	_search.reset();
+	return true;
+}
+
+BotController::~BotController()
+{
+	if(_search != nullptr)
+		_search->cancel();
+}
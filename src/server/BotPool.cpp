@@ -0,0 +1,79 @@
+// WizardPoker headers
+#include "server/BotPool.hpp"
+// std-C++ headers
+#include <algorithm>
+#include <iostream>
+// system headers
+#ifdef __linux__
+extern "C"
+{
+# include <sys/resource.h>
+}
+#endif
+
+constexpr int BotPool::niceness;
+constexpr std::size_t BotPool::waitingSearchesPerThread;
+
+BotPool::BotPool(unsigned threadsCount):
+	_threads(),
+	_waitingSearches(),
+	_waitingSearchesMutex(),
+	_searchSubmitted(),
+	_stopping(false)
+{
+	for(unsigned i{0}; i < std::max(threadsCount, 1U); ++i)
+		_threads.emplace_back(&BotPool::work, this);
+}
+
+void BotPool::submit(std::shared_ptr<BotSearch> search)
+{
+	{
+		std::lock_guard<std::mutex> lock{_waitingSearchesMutex};
+		if(_waitingSearches.size() >= _threads.size() * waitingSearchesPerThread)
+		{
+			search->shed();
+			return;
+		}
+		_waitingSearches.push_back(std::move(search));
+	}
+	_searchSubmitted.notify_one();
+}
+
+void BotPool::work()
+{
+#ifdef __linux__
+	// on Linux, setpriority(PRIO_PROCESS, 0, ...) only changes the calling thread
+	if(setpriority(PRIO_PROCESS, 0, niceness) != 0)
+		std::cerr << "Unable to lower the priority of a bot thread\n";
+#endif
+	while(true)
+	{
+		std::shared_ptr<BotSearch> search;
+		{
+			std::unique_lock<std::mutex> lock{_waitingSearchesMutex};
+			_searchSubmitted.wait(lock, [this]()
+			{
+				return _stopping or not _waitingSearches.empty();
+			});
+			if(_stopping)
+				return;
+			search = std::move(_waitingSearches.front());
+			_waitingSearches.pop_front();
+		}
+		// the game of a cancelled search went on, its result would be ignored
+		if(not search->isCancelled())
+			search->run();
+	}
+}
+
+BotPool::~BotPool()
+{
+	{
+		std::lock_guard<std::mutex> lock{_waitingSearchesMutex};
+		_stopping = true;
+		_waitingSearches.clear();
+	}
+	_searchSubmitted.notify_all();
+	for(auto& thread: _threads)
+		thread.join();
+}
@@ -0,0 +1,225 @@
+// WizardPoker headers
+#include "server/BotSearch.hpp"
+#include "server/GameSimulation.hpp"
+#include "server/GamePolicy.hpp"
+// std-C++ headers
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+constexpr double BotSearch::exploration;
+constexpr std::size_t BotSearch::maxPlayouts;
+
+/// Policy of the bot in the playouts: plays a given action first, then at random
+class FirstActionPolicy final : public GamePolicy
+{
+public:
+	FirstActionPolicy(const PlayerAction& firstAction, RandomInteger::Seed seed):
+		_firstAction(firstAction),
+		_isFirstActionPlayed(false),
+		_randomPolicy(seed)
+	{
+	}
+
+	PlayerAction nextAction(const Player& self, const Player& opponent) override
+	{
+		if(_isFirstActionPlayed)
+			return _randomPolicy.nextAction(self, opponent);
+		_isFirstActionPlayed = true;
+		return _firstAction;
+	}
+
+	std::vector<int> selectCards(const Player& self, const Player& opponent, const std::vector<CardToSelect>& selection) override
+	{
+		return _randomPolicy.selectCards(self, opponent, selection);
+	}
+
+private:
+	const PlayerAction _firstAction;
+	bool _isFirstActionPlayed;
+	RandomPolicy _randomPolicy;
+};
+
+BotSearch::BotSearch(ServerDatabase& database, const JournalHeader& header, const std::vector<JournalRecord>& records,
+		UserId botId, std::chrono::milliseconds budget, RandomInteger::Seed seed,
+		std::shared_ptr<const GameSnapshot> start):
+	_database(database),
+	_header(header),
+	_records(records),
+	_start(std::move(start)),
+	_botId(botId),
+	_deadline(std::chrono::steady_clock::now() + budget),
+	_generator(seed),
+	_candidates(),
+	_snapshot(),
+	_action{TransferType::GAME_PLAYER_LEAVE_TURN, 0, 0},
+	_cancelled(false),
+	_done(false)
+{
+}
+
+void BotSearch::run()
+{
+	// the game thread is already waiting for longer than the budget
+	if(std::chrono::steady_clock::now() >= _deadline)
+	{
+		shed();
+		return;
+	}
+	try
+	{
+		listCandidates();
+		std::size_t playoutsCount{0};
+		GameSimulation game(_database, _header.seed, _header.player1Id, _header.player2Id);
+		// a single candidate is ending the turn, there is nothing to evaluate
+		while(_candidates.size() > 1 and playoutsCount < maxPlayouts and not isCancelled()
+		      and std::chrono::steady_clock::now() < _deadline)
+		{
+			const std::size_t index{chooseCandidate(playoutsCount)};
+			const double result{playout(index, game)};
+			_candidates[index].playouts++;
+			_candidates[index].score += result;
+			playoutsCount++;
+		}
+		// the most evaluated action is the most reliable one
+		const auto best = std::max_element(_candidates.begin(), _candidates.end(), [](const Candidate& lhs, const Candidate& rhs)
+		{
+			return lhs.playouts < rhs.playouts;
+		});
+		if(best != _candidates.end())
+			_action = best->action;
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << "Bot search aborted, the bot ends its turn: " << e.what() << "\n";
+	}
+	_done.store(true);
+}
+
+void BotSearch::shed()
+{
+	_done.store(true);
+}
+
+void BotSearch::cancel()
+{
+	_cancelled.store(true);
+}
+
+bool BotSearch::isCancelled() const
+{
+	return _cancelled.load();
+}
+
+bool BotSearch::isDone() const
+{
+	return _done.load();
+}
+
+const PlayerAction& BotSearch::getAction() const
+{
+	assert(isDone());
+	return _action;
+}
+
+std::size_t BotSearch::getRecordsCount() const
+{
+	return _records.size();
+}
+
+void BotSearch::listCandidates()
+{
+	GameSimulation game(_database, _header.seed, _header.player1Id, _header.player2Id);
+	const bool isOver{_start != nullptr ? game.restore(*_start, _records) : game.restore(_header, _records)};
+	if(isOver or not game.isRunning())
+		throw std::runtime_error("the game is over");
+	game.save(_snapshot);
+	const Player& bot(game.getPlayer(_botId));
+	const Player& opponent(game.getPlayer(_botId == _header.player1Id ? _header.player2Id : _header.player1Id));
+	std::vector<PlayerAction> actions;
+	GamePolicy::listActions(bot, opponent, actions);
+	_candidates.clear();
+	for(const PlayerAction& action: actions)
+		_candidates.push_back({action, 0, 0.});
+}
+
+std::size_t BotSearch::chooseCandidate(std::size_t playoutsCount) const
+{
+	std::size_t chosen{0};
+	double bestValue{-std::numeric_limits<double>::infinity()};
+	for(std::size_t i{0}; i < _candidates.size(); ++i)
+	{
+		const Candidate& candidate(_candidates[i]);
+		// every candidate is evaluated once before the others are evaluated again
+		if(candidate.playouts == 0)
+			return i;
+		const double playouts{static_cast<double>(candidate.playouts)};
+		const double value{candidate.score / playouts
+		                   + exploration * std::sqrt(std::log(static_cast<double>(playoutsCount)) / playouts)};
+		if(value > bestValue)
+		{
+			bestValue = value;
+			chosen = i;
+		}
+	}
+	return chosen;
+}
+
+void BotSearch::determinize(GameSnapshot& snapshot)
+{
+	std::array<bool, GameSnapshot::cardsCount> isReferenced{};
+	const auto reference = [&isReferenced](const Constraints::Snapshot& constraints)
+	{
+		// the casters past the last timed value are not set for the spells
+		const std::size_t end{*std::max_element(constraints.offsets.begin(), constraints.offsets.end())};
+		for(std::size_t i{0}; i < end; ++i)
+			if(constraints.casters[i] < GameSnapshot::cardsCount)
+				isReferenced[constraints.casters[i]] = true;
+	};
+	for(const CardSnapshot& card: snapshot.cards)
+		reference(card.constraints);
+	for(const PlayerSnapshot& player: snapshot.players)
+	{
+		reference(player.constraints);
+		reference(player.teamConstraints);
+		if(player.lastCaster < GameSnapshot::cardsCount)
+			isReferenced[player.lastCaster] = true;
+	}
+
+	std::size_t firstCard{0};
+	for(const PlayerSnapshot& player: snapshot.players)
+	{
+		// the deck comes first, then the hand
+		const std::size_t hiddenCount{player.deckSize + (player.id == _botId ? 0U : player.handSize)};
+		std::array<std::size_t, GameSnapshot::cardsCount> hidden;
+		std::size_t count{0};
+		for(std::size_t i{firstCard}; i < firstCard + hiddenCount; ++i)
+			if(not isReferenced[i])
+				hidden[count++] = i;
+		// Fisher-Yates shuffle, as Player::setDeck
+		for(std::size_t i{count}; i > 1; --i)
+			std::swap(snapshot.cards[hidden[i - 1]], snapshot.cards[hidden[static_cast<std::size_t>(_generator.next(static_cast<int>(i)))]]);
+		firstCard += player.deckSize + player.handSize + player.boardSize + player.graveyardSize;
+	}
+}
+
+double BotSearch::playout(std::size_t index, GameSimulation& game)
+{
+	GameSnapshot dealt(_snapshot);
+	determinize(dealt);
+	game.load(dealt);
+	// the future draws of the game are not known by the bot
+	game.getGenerator().setSeed(static_cast<RandomInteger::Seed>(_generator.next(std::numeric_limits<int>::max())));
+	FirstActionPolicy botPolicy(_candidates[index].action, static_cast<RandomInteger::Seed>(_generator.next(std::numeric_limits<int>::max())));
+	RandomPolicy opponentPolicy(static_cast<RandomInteger::Seed>(_generator.next(std::numeric_limits<int>::max())));
+	const bool isBotFirst{_botId == _header.player1Id};
+	const UserId winnerId{isBotFirst ? game.playOut(botPolicy, opponentPolicy) : game.playOut(opponentPolicy, botPolicy)};
+	if(winnerId == _botId)
+		return 1.;
+	return winnerId == 0 ? 0.5 : 0.;
+}
@@ -0,0 +1,118 @@
+// WizardPoker headers
+#include "server/CardArena.hpp"
+#include "server/Creature.hpp"
+#include "server/Spell.hpp"
+// std-C++ headers
+#include <type_traits>
+#include <functional>
+#include <stdexcept>
+#include <new>
+#include <cassert>
+
+/// Size of a slot, rounded up to an alignment suitable for any card
+static constexpr std::size_t slotSize{sizeof(std::aligned_union<0, Creature, Spell>::type)};
+
+constexpr std::size_t CardArena::capacity;
+
+CardArena::CardArena(std::size_t cardsCount):
+	_blockSize(cardsCount),
+	_blocks(),
+	_cards(),
+	_tags(),
+	_stats()
+{
+	assert(_blockSize > 0);
+	_blocks.emplace_back(new unsigned char[_blockSize * slotSize]);
+	_cards.reserve(_blockSize);
+}
+
+Creature* CardArena::createCreature(const ServerCreatureData& data, Player& owner)
+{
+	const std::size_t index{_cards.size()};
+	void* slot{allocate(sizeof(Creature))};
+	_tags[index] = {data.getId(), data.getCost(), true};
+	_stats[index] = {data.getAttack(), data.getHealth(), data.getShield(), data.getShieldType()};
+	Creature* creature{new (slot) Creature(data, owner, _stats[index])};
+	_cards.push_back(creature);
+	return creature;
+}
+
+Spell* CardArena::createSpell(const ServerSpellData& data)
+{
+	const std::size_t index{_cards.size()};
+	void* slot{allocate(sizeof(Spell))};
+	_tags[index] = {data.getId(), data.getCost(), false};
+	Spell* spell{new (slot) Spell(data)};
+	_cards.push_back(spell);
+	return spell;
+}
+
+void CardArena::clear()
+{
+	for(Card* card: _cards)
+		card->~Card();
+	_cards.clear();
+}
+
+std::size_t CardArena::getCardsCount() const
+{
+	return _cards.size();
+}
+
+const std::vector<Card*>& CardArena::getCards() const
+{
+	return _cards;
+}
+
+Card* CardArena::getCard(Index index) const
+{
+	assert(index < _cards.size());
+	return _cards[index];
+}
+
+CardArena::Index CardArena::getIndex(const Card* card) const
+{
+	// the slot of a card is its index, it is found from its address
+	const unsigned char* address{reinterpret_cast<const unsigned char*>(card)};
+	const std::less<const unsigned char*> isBefore;
+	for(std::size_t block{0}; block < _blocks.size(); ++block)
+	{
+		const unsigned char* first{_blocks[block].get()};
+		if(isBefore(address, first) or not isBefore(address, first + _blockSize * slotSize))
+			continue;
+		const std::size_t slot{block * _blockSize + static_cast<std::size_t>(address - first) / slotSize};
+		if(slot < _cards.size())
+			return static_cast<Index>(slot);
+	}
+	throw std::invalid_argument("CardArena::getIndex: the card is not in the arena");
+}
+
+const CardTag& CardArena::getTag(Index index) const
+{
+	assert(index < _cards.size());
+	return _tags[index];
+}
+
+const CreatureStats& CardArena::getStats(Index index) const
+{
+	assert(index < _cards.size() and _tags[index].isCreature);
+	return _stats[index];
+}
+
+CardArena::~CardArena()
+{
+	clear();
+}
+
+void* CardArena::allocate(std::size_t size)
+{
+	assert(size <= slotSize);
+	static_cast<void>(size);
+	const std::size_t slot{_cards.size()};
+	if(slot == capacity)
+		throw std::length_error("CardArena::allocate: too many cards for their indices");
+	// the blocks are reused in their order after a clear
+	if(slot / _blockSize == _blocks.size())
+		_blocks.emplace_back(new unsigned char[_blockSize * slotSize]);
+	return _blocks[slot / _blockSize].get() + (slot % _blockSize) * slotSize;
+}
@@ -5,68 +5,227 @@
 #include <cassert>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <string>
 
-Constraints::Constraints(const std::vector<ConstraintDefaultValue>& defaultValues):
+const std::vector<ConstraintDefaultValue> playerDefaultConstraints =
+{
+	//turn-based constraints
+	{1, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //PC_TURN_CARDS_PICKED
+	{1, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //PC_TURN_ENERGY_INIT_CHANGE
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //PC_TURN_ENERGY_CHANGE
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //PC_TURN_HEALTH_CHANGE
+	{-5, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},          //PC_TURN_HEALTH_CHANGE_DECK_EMPTY
+	//passive constraints
+	{100, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},        //PC_TEMP_CARD_USE_LIMIT
+	{100, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},        //PC_TEMP_SPELL_CALL_LIMIT
+	{100, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},        //PC_TEMP_CREATURE_ATTACK_LIMIT
+	{6, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //PC_TEMP_CREATURE_PLACING_LIMIT
+	{6, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST}           //PC_TEMP_CREATURE_BOARD_LIMIT
+};
+
+const std::vector<ConstraintDefaultValue> creatureDefaultConstraints =
+{
+	//turn-based constraints: all default to 0
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_TURN_ATTACK_CHANGE
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_TURN_HEALTH_CHANGE
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_TURN_SHIELD_CHANGE
+	//passive
+	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_FORCE_ATTACKS
+	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_BLOCK_ATTACKS
+	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_MIRROR_ATTACKS
+	{0, ConstraintValueOption::VALUE_GET_DECREMENT, ConstraintOrderOption::GET_LAST},  //CC_TEMP_BACKFIRE_ATTACKS
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //CC_TEMP_DISABLE_ATTACKS
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_LAST},          //CC_TEMP_IS_PARALYZED
+	//on creature death
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_DEATH_TEAM_HEALTH_GAIN
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM},           //CC_DEATH_TEAM_ATTACK_LOSS
+	{0, ConstraintValueOption::VALUE_FIXED, ConstraintOrderOption::GET_SUM}            //CC_DEATH_TEAM_SHIELD_LOSS
+};
+
+constexpr std::size_t Constraints::capacity;
+constexpr std::size_t Constraints::_maxConstraintsCount;
+constexpr Constraints::CasterIndex Constraints::noCaster;
+const bool Constraints::_noCasterNeeded{true};
+
+Constraints::Constraints(const std::vector<ConstraintDefaultValue>& defaultValues, CasterVersion& casterVersion):
 	_defaultValues(defaultValues),
-	_timedValues(defaultValues.size())  // creates a vector of size `defaultValues.size()`
+	_isCreatureConstraints(&defaultValues == &creatureDefaultConstraints),
+	_offsets(),
+	_values(),
+	_turns(),
+	_casters(),
+	_casterOnBoard(),
+	_versions(),
+	_memoVersions(),
+	_memoCasterVersions(),
+	_memoUsesCasters(),
+	_memoValues(),
+	_casterVersion(&casterVersion)
 {
+	if(defaultValues.size() > _maxConstraintsCount)
+		throw std::runtime_error("Constraints: too many constraint ids");
+	_offsets.fill(0);
+	// nothing is memoized yet
+	_versions.fill(1);
+	_memoVersions.fill(0);
+}
 
+void Constraints::casterChanged()
+{
+	++*_casterVersion;
 }
 
-void Constraints::setConstraint(int constraintId, int value, int turns, const Creature* caster)
+void Constraints::save(Snapshot& snapshot, const std::vector<const Creature*>& casters) const
 {
-	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
-	_timedValues.at(constraintId).push_back({value, turns, caster});
+	const std::size_t end{_offsets[_defaultValues.size()]};
+	if(end > capacity)
+		throw std::runtime_error("Constraints::save: " + std::to_string(end) + " timed values, a snapshot holds "
+				+ std::to_string(capacity));
+	for(std::size_t id{0}; id < _offsets.size(); ++id)
+		snapshot.offsets[id] = static_cast<std::uint8_t>(_offsets[id]);
+	// the unused values are zeroed, so that equal constraints give equal snapshots
+	snapshot.values.fill(0);
+	snapshot.turns.fill(0);
+	std::copy(_values.begin(), _values.begin() + end, snapshot.values.begin());
+	std::copy(_turns.begin(), _turns.begin() + end, snapshot.turns.begin());
+	for(std::size_t i{0}; i < capacity; ++i)
+	{
+		if(i >= end or _casters[i] == nullptr)
+		{
+			snapshot.casters[i] = noCaster;
+			continue;
+		}
+		const auto caster = std::find(casters.begin(), casters.end(), _casters[i]);
+		assert(caster != casters.end());
+		snapshot.casters[i] = static_cast<CasterIndex>(caster - casters.begin());
+	}
 }
 
-int Constraints::getConstraint(int constraintId) const
+bool Constraints::isValid(const Snapshot& snapshot, const std::vector<ConstraintDefaultValue>& defaultValues,
+		std::size_t castersCount)
 {
-	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
-	switch(_defaultValues.at(constraintId).orderOption)
+	// the offsets after the last id are not used
+	for(std::size_t id{0}; id <= defaultValues.size(); ++id)
+		if(snapshot.offsets[id] > capacity or (id > 0 and snapshot.offsets[id] < snapshot.offsets[id - 1]))
+			return false;
+	for(const CasterIndex caster : snapshot.casters)
+		if(caster != noCaster and caster >= castersCount)
+			return false;
+	return true;
+}
+
+void Constraints::load(const Snapshot& snapshot, const std::vector<const Creature*>& casters)
+{
+	for(std::size_t id{0}; id < _offsets.size(); ++id)
+		_offsets[id] = snapshot.offsets[id];
+	// a snapshot holds at most capacity values
+	_values.shrink();
+	_turns.shrink();
+	_casters.shrink();
+	_casterOnBoard.shrink();
+	std::copy(snapshot.values.begin(), snapshot.values.end(), _values.begin());
+	std::copy(snapshot.turns.begin(), snapshot.turns.end(), _turns.begin());
+	for(std::size_t i{0}; i < capacity; ++i)
+	{
+		_casters[i] = snapshot.casters[i] == noCaster ? nullptr : casters.at(snapshot.casters[i]);
+		_casterOnBoard[i] = _casters[i] == nullptr ? &_noCasterNeeded : &_casters[i]->getOnBoardFlag();
+	}
+	// nothing is memoized anymore
+	for(std::size_t id{0}; id < _defaultValues.size(); ++id)
+		++_versions[id];
+	casterChanged();
+}
+
+void Constraints::touch(int constraintId)
+{
+	++_versions[constraintId];
+	// a paralysis is an input of the constraints casted by the creature (see isActive)
+	if(_isCreatureConstraints and constraintId == CC_TEMP_IS_PARALYZED)
+		casterChanged();
+}
+
+int Constraints::getTimedValue(int constraintId) const
+{
+	const ConstraintDefaultValue& defaultValue(_defaultValues[constraintId]);
+	const bool isMemoizable{defaultValue.valueOption != ConstraintValueOption::VALUE_GET_DECREMENT
+	                        and defaultValue.valueOption != ConstraintValueOption::VALUE_GET_INCREMENT};
+	if(isMemoizable and _memoVersions[constraintId] == _versions[constraintId]
+	   and (not _memoUsesCasters[constraintId] or _memoCasterVersions[constraintId] == *_casterVersion))
+		return _memoValues[constraintId];
+
+	int value;
+	switch(defaultValue.orderOption)
 	{
 		case ConstraintOrderOption::GET_FIRST:
-			return getFirstTimedValue(constraintId);
+			value = getFirstTimedValue(constraintId);
+			break;
 		case ConstraintOrderOption::GET_LAST:
-			return getLastTimedValue(constraintId);
+			value = getLastTimedValue(constraintId);
+			break;
 		case ConstraintOrderOption::GET_SUM:
-			return getSumTimedValues(constraintId);
+			value = getSumTimedValues(constraintId);
+			break;
+		default:
+			throw std::runtime_error("Order option not valid");
 	}
-	throw std::runtime_error("Order option not valid");
+	if(isMemoizable)
+	{
+		const auto first = _casters.begin();
+		_memoUsesCasters[constraintId] = std::any_of(first + _offsets[constraintId], first + _offsets[constraintId + 1],
+				[](const Creature* caster)
+				{
+					return caster != nullptr;
+				});
+		_memoCasterVersions[constraintId] = *_casterVersion;
+		_memoVersions[constraintId] = _versions[constraintId];
+		_memoValues[constraintId] = value;
+	}
+	return value;
+}
+
+void Constraints::setConstraint(int constraintId, int value, int turns, const Creature* caster)
+{
+	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
+	// the new value is the last one of its constraint
+	insertValue(constraintId, _offsets[constraintId + 1], value, turns, caster);
+}
+
+int Constraints::getConstraint(int constraintId) const
+{
+	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
+	return getTimedValue(constraintId);
 }
 
 int Constraints::getOverallConstraint(int constraintId, int otherValue) const
 {
 	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
-	switch(_defaultValues.at(constraintId).orderOption)
+	switch(_defaultValues[constraintId].orderOption)
 	{
 		case ConstraintOrderOption::GET_FIRST:
-			if(otherValue == _defaultValues.at(constraintId).value)
-				return getFirstTimedValue(constraintId);
-			else
-				return otherValue;
 		case ConstraintOrderOption::GET_LAST:
-			if(otherValue == _defaultValues.at(constraintId).value)
-				return getLastTimedValue(constraintId);
+			if(otherValue == _defaultValues[constraintId].value)
+				return getTimedValue(constraintId);
 			else
 				return otherValue;
 		case ConstraintOrderOption::GET_SUM:
-			otherValue += getSumTimedValues(constraintId);
+			otherValue += getTimedValue(constraintId);
 			return otherValue;
 	}
 	throw std::runtime_error("Order option not valid");
 }
 
-int Constraints::getValue(int constraintId, unsigned valueIndex) const
+int Constraints::getValue(int constraintId, std::size_t valueIndex) const
 {
-	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
-	int value{_timedValues.at(constraintId).at(valueIndex).value};
-	switch(_defaultValues.at(constraintId).valueOption) //rules
+	int value{_values[valueIndex]};
+	switch(_defaultValues[constraintId].valueOption) //rules
 	{
 		case ConstraintValueOption::VALUE_GET_INCREMENT:
-			_timedValues.at(constraintId).at(valueIndex).value++;
+			_values[valueIndex]++;
 			break;
 		case ConstraintValueOption::VALUE_GET_DECREMENT:
-			_timedValues.at(constraintId).at(valueIndex).value--;
+			_values[valueIndex]--;
 			break;
 		default:
 			// do nothing to value
@@ -75,75 +234,111 @@ int Constraints::getValue(int constraintId, unsigned valueIndex) const
 	return value;
 }
 
-int Constraints::getFirstTimedValue(int constraintId) const
+bool Constraints::isActive(std::size_t valueIndex) const
 {
-	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
-	std::vector<ConstraintTimedValue>& vect(_timedValues.at(constraintId)); //value, turns left, caster
-	for(auto vectIt(vect.begin()); vectIt != vect.end(); vectIt++)
-	{
-		//if the caster is not remembered, or is on the board
-		if(vectIt->caster == nullptr or vectIt->caster->isOnBoard() or vectIt->caster->getConstraint(CC_TEMP_IS_PARALYZED) == 0)
-			return getValue(constraintId, static_cast<unsigned>(vectIt - vect.begin()));
+	// if the caster is not remembered, or is on the board, the flag is true.
+	// Otherwise, the value stays active as long as its caster is not paralyzed
+	return *_casterOnBoard[valueIndex] or _casters[valueIndex]->getConstraint(CC_TEMP_IS_PARALYZED) == 0;
+}
 
-	}
-	return _defaultValues.at(constraintId).value;
+int Constraints::getFirstTimedValue(int constraintId) const
+{
+	for(std::size_t i{_offsets[constraintId]}; i < _offsets[constraintId + 1]; ++i)
+		if(isActive(i))
+			return getValue(constraintId, i);
+	return _defaultValues[constraintId].value;
 }
 
 int Constraints::getLastTimedValue(int constraintId) const
 {
-	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
-	std::vector<ConstraintTimedValue>& vect = _timedValues.at(constraintId); //value, turns left, caster
-	for(auto vectIt(vect.rbegin()); vectIt != vect.rend(); vectIt++)
-	{
-		//if the caster is not remembered, or is on the board and active
-		if(vectIt->caster == nullptr or vectIt->caster->isOnBoard() or vectIt->caster->getConstraint(CC_TEMP_IS_PARALYZED) == 0)
-			return getValue(constraintId, static_cast<unsigned>(vectIt - vect.rbegin()));
-
-	}
-	return _defaultValues.at(constraintId).value;
+	for(std::size_t i{_offsets[constraintId + 1]}; i > _offsets[constraintId]; --i)
+		if(isActive(i - 1))
+			return getValue(constraintId, i - 1);
+	return _defaultValues[constraintId].value;
 }
 
 int Constraints::getSumTimedValues(int constraintId) const
 {
-	assert(constraintId < static_cast<int>(_defaultValues.size()) and constraintId >= 0);
-	int value = _defaultValues.at(constraintId).value;
-	std::vector<ConstraintTimedValue>& vect = _timedValues.at(constraintId); //value, turns left, caster
-	for(auto vectIt(vect.begin()); vectIt != vect.end(); vectIt++)
-	{
-		//if the caster is not remembered, or is on the board and active
-		if(vectIt->caster == nullptr or vectIt->caster->isOnBoard() or vectIt->caster->getConstraint(CC_TEMP_IS_PARALYZED) == 0)
-			value += getValue(constraintId, static_cast<unsigned>(vectIt - vect.begin()));
-	}
+	int value{_defaultValues[constraintId].value};
+	for(std::size_t i{_offsets[constraintId]}; i < _offsets[constraintId + 1]; ++i)
+		if(isActive(i))
+			value += getValue(constraintId, i);
 	return value;
 }
 
 void Constraints::timeOutConstraints()
 {
-	for (unsigned i{0}; i < _defaultValues.size(); i++)
+	for(std::size_t id{0}; id < _defaultValues.size(); ++id)
 	{
-		std::vector<ConstraintTimedValue>& vect(_timedValues[i]); //value, turns left, caster
-		for(auto vectIt(vect.begin()); vectIt != vect.end();)
+		const int constraintId{static_cast<int>(id)};
+		if(_offsets[id] == _offsets[id + 1])
+			continue;
+		// the values and the remaining turns change
+		touch(constraintId);
+		for(std::size_t i{_offsets[id]}; i < _offsets[id + 1];)
 		{
 			//if the constraint has run our of turns or if its caster has died
-			if(vectIt->turns == 1 or not (vectIt->caster == nullptr or vectIt->caster->isOnBoard()))
-				vectIt = vect.erase(vectIt); //returns iterator to following object
+			if(_turns[i] == 1 or not *_casterOnBoard[i])
+				eraseValue(constraintId, i);  // the following value is now at i
 			else
 			{
-				vectIt->turns--;
-				switch(_defaultValues[i].valueOption)  // rules
+				_turns[i]--;
+				switch(_defaultValues[id].valueOption)  // rules
 				{
 					case ConstraintValueOption::VALUE_TURN_INCREMENT:
-						vectIt->value++;
+						_values[i]++;
 						break;
 					case ConstraintValueOption::VALUE_TURN_DECREMENT:
-						vectIt->value--;
+						_values[i]--;
 						break;
 					default:
 						//do nothing to value
 						break;
 				}
-				vectIt++;
+				i++;
 			}
 		}
 	}
 }
+
+void Constraints::insertValue(int constraintId, std::size_t valueIndex, int value, int turns, const Creature* caster)
+{
+	const std::size_t end{_offsets[_defaultValues.size()]};
+	assert(valueIndex <= end);
+	if(end == std::numeric_limits<std::uint16_t>::max())
+		throw std::length_error("Constraints::setConstraint: too many timed values for their offsets");
+	// past the inline capacity, the values move to the heap rather than being dropped
+	if(end == _values.size())
+	{
+		const std::size_t size{std::min<std::size_t>(2 * end, std::numeric_limits<std::uint16_t>::max())};
+		_values.grow(size, end);
+		_turns.grow(size, end);
+		_casters.grow(size, end);
+		_casterOnBoard.grow(size, end);
+	}
+	// shift the following values (of this constraint and of the next ones)
+	std::move_backward(_values.begin() + valueIndex, _values.begin() + end, _values.begin() + end + 1);
+	std::move_backward(_turns.begin() + valueIndex, _turns.begin() + end, _turns.begin() + end + 1);
+	std::move_backward(_casters.begin() + valueIndex, _casters.begin() + end, _casters.begin() + end + 1);
+	std::move_backward(_casterOnBoard.begin() + valueIndex, _casterOnBoard.begin() + end, _casterOnBoard.begin() + end + 1);
+	_values[valueIndex] = value;
+	_turns[valueIndex] = turns;
+	_casters[valueIndex] = caster;
+	_casterOnBoard[valueIndex] = caster == nullptr ? &_noCasterNeeded : &caster->getOnBoardFlag();
+	for(std::size_t id{static_cast<std::size_t>(constraintId) + 1}; id <= _defaultValues.size(); ++id)
+		_offsets[id]++;
+	touch(constraintId);
+}
+
+void Constraints::eraseValue(int constraintId, std::size_t valueIndex)
+{
+	const std::size_t end{_offsets[_defaultValues.size()]};
+	assert(valueIndex < end);
+	std::move(_values.begin() + valueIndex + 1, _values.begin() + end, _values.begin() + valueIndex);
+	std::move(_turns.begin() + valueIndex + 1, _turns.begin() + end, _turns.begin() + valueIndex);
+	std::move(_casters.begin() + valueIndex + 1, _casters.begin() + end, _casters.begin() + valueIndex);
+	std::move(_casterOnBoard.begin() + valueIndex + 1, _casterOnBoard.begin() + end, _casterOnBoard.begin() + valueIndex);
+	for(std::size_t id{static_cast<std::size_t>(constraintId) + 1}; id <= _defaultValues.size(); ++id)
+		_offsets[id]--;
+	touch(constraintId);
+}
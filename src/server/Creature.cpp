@@ -5,35 +5,26 @@
 #include <iostream>
 #include <cassert>
 
-std::array<std::function<void(Creature&, EffectArgs)>, P_EFFECTS_COUNT> Creature::_effectMethods =
-{
-	&Creature::setConstraint,
-	&Creature::resetAttack,
-	&Creature::resetHealth,
-	&Creature::resetShield,
-	&Creature::changeAttack,
-	&Creature::changeHealth,
-	&Creature::changeShield
-};
-
-Creature::Creature(const ServerCreatureData& cardData, Player& owner):
+Creature::Creature(const ServerCreatureData& cardData, Player& owner, CreatureStats& stats):
 	Card(cardData),
-	_attack(cardData.getAttack()),
-	_health(cardData.getHealth()),
-	_shield(cardData.getShield()),
-	_shieldType(cardData.getShieldType()),
-	_owner(owner)
+	_stats(stats),
+	_owner(&owner),
+	_isOnBoard(false),
+	_constraints(creatureDefaultConstraints, owner.getCasterVersion())
 {
 }
 
-void Creature::moveToBoard()
+void Creature::moveToBoard(Player& owner)
 {
+	_owner = &owner;
 	_isOnBoard = true;
+	_constraints.casterChanged();
 }
 
 void Creature::removeFromBoard()
 {
 	_isOnBoard = false;
+	_constraints.casterChanged();
 	//Creature's death-based constraints
 	changeAttack({getConstraint(CC_DEATH_ATTACK_CHANGE)});
 	changeHealth({getConstraint(CC_DEATH_HEALTH_CHANGE)});
@@ -45,6 +36,11 @@ bool Creature::isOnBoard() const
 	return _isOnBoard;
 }
 
+const bool& Creature::getOnBoardFlag() const
+{
+	return _isOnBoard;
+}
+
 
 /*--------------------------- PLAYER INTERFACE */
 void Creature::enterTurn()
@@ -74,9 +70,9 @@ void Creature::makeAttack(Creature& victim)
 
 	bool attackBackfires = getConstraintBool(CC_TEMP_BACKFIRE_ATTACKS);
 	if(attackBackfires)	//Attack turns agains the creature
-		changeHealth({_attack, attackForced});
+		changeHealth({_stats.attack, attackForced});
 	else
-		victim.receiveAttack(*this, _attack, attackForced);
+		victim.receiveAttack(*this, _stats.attack, attackForced);
 }
 
 void Creature::receiveAttack(Creature& attacker, int attack, int forced, int loopCount)
@@ -94,36 +90,61 @@ void Creature::receiveAttack(Creature& attacker, int attack, int forced, int loo
 }
 
 /*--------------------------- EFFECTS INTERFACE */
-void Creature::applyEffectToSelf(EffectArgs effect)
+void Creature::applyEffectToSelf(const CardEffect& effect)
 {
-	assert(effect.remainingArgs() >= 1);
-	const int method = effect.getArg();  // What method is used
-	_effectMethods.at(method)(*this, effect);  // Call the method
+	// the effect has been checked when the card templates were loaded (see
+	// CardEffects), the calls are direct so that the compiler can inline them
+	switch(effect.method)
+	{
+		case CE_SET_CONSTRAINT:
+			setConstraint(effect.getArgs());
+			break;
+		case CE_RESET_ATTACK:
+			resetAttack(effect.getArgs());
+			break;
+		case CE_RESET_HEALTH:
+			resetHealth(effect.getArgs());
+			break;
+		case CE_RESET_SHIELD:
+			resetShield(effect.getArgs());
+			break;
+		case CE_CHANGE_ATTACK:
+			changeAttack(effect.getArgs());
+			break;
+		case CE_CHANGE_HEALTH:
+			changeHealth(effect.getArgs());
+			break;
+		case CE_CHANGE_SHIELD:
+			changeShield(effect.getArgs());
+			break;
+		default:
+			throw std::runtime_error("Creature effect not valid");
+	}
 }
 
-const std::vector<EffectParamsCollection>& Creature::getEffects() const
+const CardEffects& Creature::getEffects() const
 {
 	return prototype().getEffects();
 }
 
 int Creature::getAttack() const
 {
-	return _attack;
+	return _stats.attack;
 }
 
 int Creature::getHealth() const
 {
-	return _health;
+	return _stats.health;
 }
 
 int Creature::getShield() const
 {
-	return _shield;
+	return _stats.shield;
 }
 
 int Creature::getShieldType() const
 {
-	return _shieldType;
+	return _stats.shieldType;
 }
 
 int Creature::getPersonalConstraint(int constraintId) const
@@ -133,7 +154,7 @@ int Creature::getPersonalConstraint(int constraintId) const
 
 int Creature::getConstraint(int constraintId) const
 {
-	return _owner.getCreatureConstraint(*this, constraintId);
+	return _owner->getCreatureConstraint(*this, constraintId);
 }
 
 bool Creature::getConstraintBool(int constraintId) const
@@ -165,7 +186,7 @@ void Creature::setConstraint(EffectArgs effect)
 	switch(casterOptions)
 	{
 		case IF_CASTER_ALIVE:
-			_constraints.setConstraint(constraintId, value, turns, dynamic_cast<const Creature*>(_owner.getLastCaster()));
+			_constraints.setConstraint(constraintId, value, turns, _owner->getLastCasterCreature());
 			break;
 
 		default:
@@ -177,28 +198,28 @@ void Creature::setConstraint(EffectArgs effect)
 void Creature::resetAttack(EffectArgs /* effect */)
 {
 	// no arguments
-	 _attack = prototype().getAttack();
+	 _stats.attack = prototype().getAttack();
 }
 
 void Creature::resetHealth(EffectArgs /* effect */)
 {
 	// no arguments
-	 _health = prototype().getHealth();
+	 _stats.health = prototype().getHealth();
 }
 
 void Creature::resetShield(EffectArgs /* effect */)
 {
 	// no arguments
-	 _shield = prototype().getShield();
+	 _stats.shield = prototype().getShield();
 }
 
 void Creature::changeAttack(EffectArgs effect)
 {
 	try //check the input
 	{
-		_attack += effect.getArg();
-		if(_attack < 0)
-			_attack = 0;
+		_stats.attack += effect.getArg();
+		if(_stats.attack < 0)
+			_stats.attack = 0;
 	}
 	catch (std::out_of_range&)
 	{
@@ -225,15 +246,15 @@ void Creature::changeHealth(EffectArgs effect)
 
 	if(points < 0 and not forced)
 	{
-		switch (_shieldType)
+		switch (_stats.shieldType)
 		{
 			case SHIELD_BLUE:
-				points += _shield;  // Blue shield, can allow part of the attack to deal damage
+				points += _stats.shield;  // Blue shield, can allow part of the attack to deal damage
 				if(points > 0)
 					points = 0;
 				break;
 			case SHIELD_ORANGE:
-				if(-points <= _shield)
+				if(-points <= _stats.shield)
 					points = 0;  // Orange shield, only stronger attacks go through
 				break;
 			case SHIELD_LEGENDARY:
@@ -242,12 +263,12 @@ void Creature::changeHealth(EffectArgs effect)
 		}
 	}
 
-	_health += points;
-	if(_health <= 0)
+	_stats.health += points;
+	if(_stats.health <= 0)
 	{
-		_health = 0;
+		_stats.health = 0;
 		if(_isOnBoard)
-			_owner.cardBoardToGraveyard(this);
+			_owner->cardBoardToGraveyard(this);
 	}
 }
 
@@ -255,9 +276,9 @@ void Creature::changeShield(EffectArgs effect)
 {
 	try  // check the input
 	{
-		_shield += effect.getArg();
-		if(_shield < 0)
-			_shield = 0;
+		_stats.shield += effect.getArg();
+		if(_stats.shield < 0)
+			_stats.shield = 0;
 	}
 	catch (std::out_of_range&)
 	{
@@ -265,6 +286,32 @@ void Creature::changeShield(EffectArgs effect)
 	}
 }
 
+const Player& Creature::getOwner() const
+{
+	return *_owner;
+}
+
+void Creature::save(CardSnapshot& snapshot, const std::vector<const Creature*>& casters) const
+{
+	snapshot.isOnBoard = _isOnBoard;
+	snapshot.attack = _stats.attack;
+	snapshot.health = _stats.health;
+	snapshot.shield = _stats.shield;
+	snapshot.shieldType = _stats.shieldType;
+	_constraints.save(snapshot.constraints, casters);
+}
+
+void Creature::load(const CardSnapshot& snapshot, Player& owner, const std::vector<const Creature*>& casters)
+{
+	_owner = &owner;
+	_isOnBoard = snapshot.isOnBoard;
+	_stats.attack = snapshot.attack;
+	_stats.health = snapshot.health;
+	_stats.shield = snapshot.shield;
+	_stats.shieldType = snapshot.shieldType;
+	_constraints.load(snapshot.constraints, casters);
+}
+
 Creature::operator BoardCreatureData() const
 {
 	BoardCreatureData data {getId(), getHealth(), getAttack(), getShield(),
@@ -0,0 +1,286 @@
+// WizardPoker headers
+#include "server/GameCheckpoints.hpp"
+// std-C++ headers
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+constexpr std::uint16_t GameCheckpoints::version;
+const char GameCheckpoints::magic[4] = {'W', 'P', 'G', 'C'};
+
+/// Appends \a value to \a buffer in little-endian order, on \a bytes bytes
+static void writeFixed(std::string& buffer, std::uint64_t value, std::size_t bytes)
+{
+	for(std::size_t i{0}; i < bytes; ++i)
+		buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/// Reads a little-endian integer of \a bytes bytes at \a position of \a data
+/// \return False if \a data is too short
+static bool readFixed(const std::string& data, std::size_t& position, std::uint64_t& value, std::size_t bytes)
+{
+	if(data.size() - position < bytes)
+		return false;
+	value = 0;
+	for(std::size_t i{0}; i < bytes; ++i)
+		value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[position++])) << (8 * i);
+	return true;
+}
+
+/// FNV-1a hash of \a size bytes of \a data
+static std::uint32_t checksum(const char* data, std::size_t size)
+{
+	std::uint32_t hash{2166136261U};
+	for(std::size_t i{0}; i < size; ++i)
+	{
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/// Appends \a snapshot to \a buffer, as pairs of a run of non-zero bytes and
+/// a run of zero bytes, each run starting with its length on 2 bytes
+static void compress(const GameSnapshot& snapshot, std::string& buffer)
+{
+	static_assert(sizeof(GameSnapshot) <= 0xFFFF, "The runs are limited to 2 bytes");
+	const char* data{reinterpret_cast<const char*>(&snapshot)};
+	std::size_t position{0};
+	while(position < sizeof(snapshot))
+	{
+		std::size_t end{position};
+		while(end < sizeof(snapshot) and data[end] != 0)
+			++end;
+		writeFixed(buffer, end - position, 2);
+		buffer.append(data + position, end - position);
+		position = end;
+		while(end < sizeof(snapshot) and data[end] == 0)
+			++end;
+		writeFixed(buffer, end - position, 2);
+		position = end;
+	}
+}
+
+/// Reads a snapshot written by compress
+/// \return False if \a data is not a compressed snapshot
+static bool decompress(const std::string& data, GameSnapshot& snapshot)
+{
+	char* output{reinterpret_cast<char*>(&snapshot)};
+	std::size_t size{0};
+	std::size_t position{0};
+	while(position < data.size())
+	{
+		std::uint64_t nonZeros, zeros;
+		if(not readFixed(data, position, nonZeros, 2) or data.size() - position < nonZeros
+		   or sizeof(snapshot) - size < nonZeros)
+			return false;
+		std::memcpy(output + size, data.data() + position, nonZeros);
+		position += nonZeros;
+		size += nonZeros;
+		if(not readFixed(data, position, zeros, 2) or sizeof(snapshot) - size < zeros)
+			return false;
+		std::memset(output + size, 0, zeros);
+		size += zeros;
+	}
+	return size == sizeof(snapshot);
+}
+
+GameCheckpoints::GameCheckpoints(const std::string& filename):
+	_file(),
+	_pendingGames(),
+	_entriesMutex(),
+	_entriesAdded(),
+	_entries(),
+	_stopping(false),
+	_writer()
+{
+	readGames(filename);
+	rewrite(filename);
+	_writer = std::thread(&GameCheckpoints::write, this);
+}
+
+void GameCheckpoints::save(const GameSnapshot& snapshot)
+{
+	push(RecordType::CHECKPOINT, snapshot.players[0].id, snapshot.players[1].id, &snapshot);
+}
+
+void GameCheckpoints::finish(UserId player1Id, UserId player2Id)
+{
+	push(RecordType::GAME_OVER, player1Id, player2Id, nullptr);
+}
+
+bool GameCheckpoints::findGame(UserId playerId, GameSnapshot& snapshot) const
+{
+	const std::size_t index{findPendingGame(playerId)};
+	if(index == _pendingGames.size())
+		return false;
+	snapshot = _pendingGames[index];
+	return true;
+}
+
+bool GameCheckpoints::takeGame(UserId playerId, GameSnapshot& snapshot)
+{
+	if(not findGame(playerId, snapshot))
+		return false;
+	_pendingGames.erase(_pendingGames.begin() + static_cast<std::ptrdiff_t>(findPendingGame(playerId)));
+	return true;
+}
+
+void GameCheckpoints::abandonGame(UserId playerId)
+{
+	GameSnapshot snapshot;
+	if(takeGame(playerId, snapshot))
+		finish(snapshot.players[0].id, snapshot.players[1].id);
+}
+
+GameCheckpoints::~GameCheckpoints()
+{
+	{
+		std::lock_guard<std::mutex> lock{_entriesMutex};
+		_stopping = true;
+	}
+	_entriesAdded.notify_one();
+	_writer.join();
+}
+
+void GameCheckpoints::readGames(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary | std::ios::in);
+	if(not file)
+		return;
+	const std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	std::size_t position{sizeof(magic)};
+	std::uint64_t fileVersion, snapshotSize;
+	// a store of another version (or of another build, whose snapshots differ) is ignored
+	if(data.size() < sizeof(magic) or std::memcmp(data.data(), magic, sizeof(magic)) != 0
+	   or not readFixed(data, position, fileVersion, sizeof(version)) or fileVersion != version
+	   or not readFixed(data, position, snapshotSize, sizeof(std::uint32_t)) or snapshotSize != sizeof(GameSnapshot))
+	{
+		std::cerr << filename << " is not a store of checkpoints of this server, the games it holds are not resumed\n";
+		return;
+	}
+	std::string compressed;
+	GameSnapshot snapshot;
+	while(position < data.size())
+	{
+		std::uint64_t type, player1Id, player2Id, size, hash;
+		if(not readFixed(data, position, type, 1) or type > static_cast<std::uint64_t>(RecordType::GAME_OVER)
+		   or not readFixed(data, position, player1Id, sizeof(UserId))
+		   or not readFixed(data, position, player2Id, sizeof(UserId))
+		   or not readFixed(data, position, size, sizeof(std::uint32_t))
+		   or not readFixed(data, position, hash, sizeof(std::uint32_t))
+		   or data.size() - position < size or checksum(data.data() + position, size) != hash)
+		{
+			std::cerr << filename << " ends with an incomplete record, which is ignored\n";
+			break;
+		}
+		compressed.assign(data, position, size);
+		position += size;
+		const bool isCheckpoint{static_cast<RecordType>(type) == RecordType::CHECKPOINT};
+		if(isCheckpoint and (not decompress(compressed, snapshot)
+		   or snapshot.players[0].id != static_cast<UserId>(player1Id)
+		   or snapshot.players[1].id != static_cast<UserId>(player2Id)))
+		{
+			std::cerr << filename << " holds an invalid checkpoint, which is ignored\n";
+			continue;
+		}
+		// a record replaces the previous ones of the same game (the bots
+		// play several games at once, only the first player identifies a game)
+		const std::size_t index{findPendingGame(static_cast<UserId>(player1Id))};
+		if(index != _pendingGames.size())
+			_pendingGames.erase(_pendingGames.begin() + static_cast<std::ptrdiff_t>(index));
+		if(isCheckpoint and snapshot.running)
+			_pendingGames.push_back(snapshot);
+	}
+	std::cout << _pendingGames.size() << " game(s) can be resumed from " << filename << "\n";
+}
+
+void GameCheckpoints::rewrite(const std::string& filename)
+{
+	// the file is replaced at once, so that a crash meanwhile does not lose it
+	const std::string temporaryFilename{filename + ".tmp"};
+	_file.open(temporaryFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+	std::string buffer(magic, sizeof(magic));
+	writeFixed(buffer, version, sizeof(version));
+	writeFixed(buffer, sizeof(GameSnapshot), sizeof(std::uint32_t));
+	_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	for(const GameSnapshot& snapshot : _pendingGames)
+		writeEntry({RecordType::CHECKPOINT, snapshot.players[0].id, snapshot.players[1].id, snapshot}, buffer);
+	_file.close();
+	if(not _file or std::rename(temporaryFilename.c_str(), filename.c_str()) != 0)
+		throw std::runtime_error("Unable to write the checkpoints in " + filename);
+	_file.open(filename, std::ios::binary | std::ios::out | std::ios::app);
+	if(not _file)
+		throw std::runtime_error("Unable to write the checkpoints in " + filename);
+}
+
+void GameCheckpoints::push(RecordType type, UserId player1Id, UserId player2Id, const GameSnapshot* snapshot)
+{
+	{
+		std::lock_guard<std::mutex> lock{_entriesMutex};
+		_entries.emplace_back();
+		Entry& entry(_entries.back());
+		entry.type = type;
+		entry.player1Id = player1Id;
+		entry.player2Id = player2Id;
+		if(snapshot != nullptr)
+			entry.snapshot = *snapshot;
+	}
+	_entriesAdded.notify_one();
+}
+
+void GameCheckpoints::write()
+{
+	// the vectors are swapped so that their memory is reused
+	std::vector<Entry> entries;
+	std::string buffer;
+	bool stopping{false};
+	while(not stopping)
+	{
+		{
+			std::unique_lock<std::mutex> lock{_entriesMutex};
+			_entriesAdded.wait(lock, [this]()
+			{
+				return _stopping or not _entries.empty();
+			});
+			stopping = _stopping;
+			entries.swap(_entries);
+		}
+		for(const Entry& entry : entries)
+			writeEntry(entry, buffer);
+		entries.clear();
+	}
+}
+
+void GameCheckpoints::writeEntry(const Entry& entry, std::string& buffer)
+{
+	static constexpr std::size_t headerSize{1 + 2 * sizeof(UserId) + 2 * sizeof(std::uint32_t)};
+	buffer.clear();
+	buffer.push_back(static_cast<char>(entry.type));
+	writeFixed(buffer, static_cast<std::uint64_t>(entry.player1Id), sizeof(UserId));
+	writeFixed(buffer, static_cast<std::uint64_t>(entry.player2Id), sizeof(UserId));
+	// the size and the checksum are written once the data is encoded
+	buffer.append(2 * sizeof(std::uint32_t), '\0');
+	if(entry.type == RecordType::CHECKPOINT)
+		compress(entry.snapshot, buffer);
+	const std::size_t dataSize{buffer.size() - headerSize};
+	std::string sizeAndChecksum;
+	writeFixed(sizeAndChecksum, dataSize, sizeof(std::uint32_t));
+	writeFixed(sizeAndChecksum, checksum(buffer.data() + headerSize, dataSize), sizeof(std::uint32_t));
+	buffer.replace(headerSize - sizeAndChecksum.size(), sizeAndChecksum.size(), sizeAndChecksum);
+	// a record is written at once, so that a crash leaves at most one incomplete record
+	_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	_file.flush();
+	if(not _file)
+		std::cerr << "Unable to write a checkpoint, the game may not be resumed after a restart\n";
+}
+
+std::size_t GameCheckpoints::findPendingGame(UserId playerId) const
+{
+	std::size_t index{0};
+	while(index < _pendingGames.size() and _pendingGames[index].players[0].id != playerId
+	      and _pendingGames[index].players[1].id != playerId)
+		++index;
+	return index;
+}
@@ -0,0 +1,256 @@
+// WizardPoker headers
+#include "server/GameJournal.hpp"
+#include "server/GameSnapshot.hpp"
+// std-C++ headers
+#include <stdexcept>
+#include <cstring>
+
+constexpr std::uint16_t GameJournal::version;
+const char GameJournal::magic[4] = {'W', 'P', 'G', 'J'};
+
+/// Number of values of a CHECKPOINT record
+static constexpr std::size_t snapshotValuesCount{(sizeof(GameSnapshot) + sizeof(std::int64_t) - 1) / sizeof(std::int64_t)};
+
+/// Appends \a value to \a buffer in little-endian order, on \a bytes bytes
+static void writeFixed(std::string& buffer, std::uint64_t value, std::size_t bytes)
+{
+	for(std::size_t i{0}; i < bytes; ++i)
+		buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/// Appends \a value to \a buffer as a LEB128 variable-length integer
+static void writeVarint(std::string& buffer, std::uint64_t value)
+{
+	while(value >= 0x80)
+	{
+		buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back(static_cast<char>(value));
+}
+
+/// Zigzag encoding, so that the small negative values are small too
+static std::uint64_t zigzag(std::int64_t value)
+{
+	return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t value)
+{
+	return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/// Reads a little-endian integer of \a bytes bytes
+/// \return False if the end of the file is reached
+static bool readFixed(std::istream& input, std::uint64_t& value, std::size_t bytes)
+{
+	value = 0;
+	for(std::size_t i{0}; i < bytes; ++i)
+	{
+		const int byte{input.get()};
+		if(byte == std::char_traits<char>::eof())
+			return false;
+		value |= static_cast<std::uint64_t>(byte) << (8 * i);
+	}
+	return true;
+}
+
+/// Reads a LEB128 variable-length integer
+/// \return False if the end of the file is reached or if the value is not valid
+static bool readVarint(std::istream& input, std::uint64_t& value)
+{
+	static constexpr unsigned maxShift{63};
+	value = 0;
+	for(unsigned shift{0}; shift <= maxShift; shift += 7)
+	{
+		const int byte{input.get()};
+		if(byte == std::char_traits<char>::eof())
+			return false;
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+		if((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+
+///////////////////////// GameJournal
+
+GameJournal::GameJournal():
+	_file(),
+	_header(),
+	_lastRecordTime(),
+	_keepsRecords(false),
+	_records(),
+	_timestamp(0),
+	_buffer()
+{
+}
+
+bool GameJournal::open(const std::string& filename, const JournalHeader& header)
+{
+	close();
+	_file.open(filename, std::ios::binary | std::ios::out | std::ios::trunc);
+	if(not _file)
+		return false;
+	_header = header;
+	if(not _keepsRecords)
+		_lastRecordTime = std::chrono::steady_clock::now();
+	_buffer.assign(magic, sizeof(magic));
+	writeFixed(_buffer, version, sizeof(version));
+	writeFixed(_buffer, header.seed, sizeof(header.seed));
+	writeFixed(_buffer, static_cast<std::uint64_t>(header.player1Id), sizeof(header.player1Id));
+	writeFixed(_buffer, static_cast<std::uint64_t>(header.player2Id), sizeof(header.player2Id));
+	writeFixed(_buffer, static_cast<std::uint64_t>(header.firstPlayerId), sizeof(header.firstPlayerId));
+	writeFixed(_buffer, static_cast<std::uint64_t>(header.startTime), sizeof(header.startTime));
+	_file.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+	_file.flush();
+	return static_cast<bool>(_file);
+}
+
+bool GameJournal::isOpen() const
+{
+	return _file.is_open();
+}
+
+void GameJournal::keepRecords(const JournalHeader& header)
+{
+	if(not isOpen())
+		_lastRecordTime = std::chrono::steady_clock::now();
+	_header = header;
+	_keepsRecords = true;
+	_records.clear();
+	_timestamp = 0;
+}
+
+const JournalHeader& GameJournal::getHeader() const
+{
+	return _header;
+}
+
+const std::vector<JournalRecord>& GameJournal::getRecords() const
+{
+	return _records;
+}
+
+void GameJournal::record(JournalRecordType type, UserId player, const std::vector<std::int64_t>& values)
+{
+	if(not isOpen() and not _keepsRecords)
+		return;
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - _lastRecordTime);
+	// keep the rounding error in _lastRecordTime so that it does not accumulate
+	_lastRecordTime += elapsed;
+	if(_keepsRecords)
+	{
+		_timestamp += static_cast<std::uint32_t>(elapsed.count());
+		_records.push_back({type, _timestamp, player, values});
+	}
+	if(not isOpen())
+		return;
+
+	_buffer.clear();
+	_buffer.push_back(static_cast<char>(type));
+	writeVarint(_buffer, static_cast<std::uint64_t>(elapsed.count()));
+	_buffer.push_back(static_cast<char>(player == _header.player1Id ? 1 : 2));
+	writeVarint(_buffer, values.size());
+	for(const std::int64_t value: values)
+		writeVarint(_buffer, zigzag(value));
+	// a record is written at once, so that a crash leaves at most one incomplete record
+	_file.write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+	_file.flush();
+}
+
+void GameJournal::close()
+{
+	if(_file.is_open())
+		_file.close();
+}
+
+std::vector<std::int64_t> GameJournal::encodeSnapshot(const GameSnapshot& snapshot)
+{
+	// the last value is padded with zeros
+	std::vector<std::int64_t> values(snapshotValuesCount, 0);
+	std::memcpy(values.data(), &snapshot, sizeof(snapshot));
+	return values;
+}
+
+bool GameJournal::decodeSnapshot(const std::vector<std::int64_t>& values, GameSnapshot& snapshot)
+{
+	if(values.size() != snapshotValuesCount)
+		return false;
+	std::memcpy(static_cast<void*>(&snapshot), values.data(), sizeof(snapshot));
+	return true;
+}
+
+///////////////////////// GameJournalReader
+
+GameJournalReader::GameJournalReader(const std::string& filename):
+	_file(filename, std::ios::binary | std::ios::in),
+	_header(),
+	_timestamp(0),
+	_recordsCount(0)
+{
+	if(not _file)
+		throw std::runtime_error("Unable to open the journal " + filename);
+	char fileMagic[sizeof(GameJournal::magic)];
+	std::uint64_t fileVersion, seed, player1Id, player2Id, firstPlayerId, startTime;
+	if(not _file.read(fileMagic, sizeof(fileMagic))
+	   or std::memcmp(fileMagic, GameJournal::magic, sizeof(fileMagic)) != 0)
+		throw std::runtime_error(filename + " is not a game journal");
+	if(not readFixed(_file, fileVersion, sizeof(GameJournal::version))
+	   or fileVersion != GameJournal::version)
+		throw std::runtime_error(filename + " has an unsupported journal version");
+	if(not readFixed(_file, seed, sizeof(_header.seed))
+	   or not readFixed(_file, player1Id, sizeof(_header.player1Id))
+	   or not readFixed(_file, player2Id, sizeof(_header.player2Id))
+	   or not readFixed(_file, firstPlayerId, sizeof(_header.firstPlayerId))
+	   or not readFixed(_file, startTime, sizeof(_header.startTime)))
+		throw std::runtime_error(filename + " has an incomplete header");
+	_header.seed = static_cast<std::uint32_t>(seed);
+	_header.player1Id = static_cast<UserId>(player1Id);
+	_header.player2Id = static_cast<UserId>(player2Id);
+	_header.firstPlayerId = static_cast<UserId>(firstPlayerId);
+	_header.startTime = static_cast<std::int64_t>(startTime);
+}
+
+const JournalHeader& GameJournalReader::getHeader() const
+{
+	return _header;
+}
+
+bool GameJournalReader::next(JournalRecord& record)
+{
+	const int type{_file.get()};
+	if(type == std::char_traits<char>::eof())
+		return false;
+	std::uint64_t elapsed, valuesCount;
+	if(type > static_cast<int>(JournalRecordType::CHECKPOINT)
+	   or not readVarint(_file, elapsed))
+		return false;
+	// a deck is the longest record but the checkpoint, more values means
+	// the file is corrupted
+	static constexpr std::uint64_t maxValuesCount{1024};
+	const int player{_file.get()};
+	if((player != 1 and player != 2) or not readVarint(_file, valuesCount)
+	   or valuesCount > (type == static_cast<int>(JournalRecordType::CHECKPOINT) ? snapshotValuesCount : maxValuesCount))
+		return false;
+	record.values.resize(valuesCount);
+	for(auto& value: record.values)
+	{
+		std::uint64_t encoded;
+		if(not readVarint(_file, encoded))
+			return false;
+		value = unzigzag(encoded);
+	}
+	record.type = static_cast<JournalRecordType>(type);
+	_timestamp += static_cast<std::uint32_t>(elapsed);
+	record.timestamp = _timestamp;
+	record.player = player == 1 ? _header.player1Id : _header.player2Id;
+	++_recordsCount;
+	return true;
+}
+
+std::size_t GameJournalReader::getRecordsCount() const
+{
+	return _recordsCount;
+}
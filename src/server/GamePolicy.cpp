@@ -0,0 +1,90 @@
+// WizardPoker headers
+#include "server/GamePolicy.hpp"
+#include "server/Player.hpp"
+
+/// \return The number of cards in the zone \a zone
+static int getZoneSize(const Player& self, const Player& opponent, CardToSelect zone)
+{
+	switch(zone)
+	{
+		case CardToSelect::SELF_BOARD:
+			return static_cast<int>(self.getBoard().size());
+		case CardToSelect::OPPO_BOARD:
+			return static_cast<int>(opponent.getBoard().size());
+		case CardToSelect::SELF_HAND:
+			return static_cast<int>(self.getHandSize());
+	}
+	return 0;
+}
+
+///////////////////////// GamePolicy
+
+void GamePolicy::listActions(const Player& self, const Player& opponent, std::vector<PlayerAction>& actions)
+{
+	actions.clear();
+	actions.push_back({TransferType::GAME_PLAYER_LEAVE_TURN, 0, 0});
+	const int energy{self.getEnergy()};
+	const auto& hand(self.getHand());
+	for(std::size_t i{0}; i < hand.size(); ++i)
+		if(hand.getTag(i).cost <= energy)
+			actions.push_back({TransferType::GAME_USE_CARD, static_cast<int>(i), 0});
+	const auto& board(self.getBoard());
+	const int victimsCount{static_cast<int>(opponent.getBoard().size())};
+	for(std::size_t i{0}; i < board.size(); ++i)
+		if(board.getTag(i).cost <= energy)
+			// -1 is the opponent himself
+			for(int victim{-1}; victim < victimsCount; ++victim)
+				actions.push_back({TransferType::GAME_ATTACK_WITH_CREATURE, static_cast<int>(i), victim});
+}
+
+///////////////////////// RandomPolicy
+
+RandomPolicy::RandomPolicy(RandomInteger::Seed seed):
+	_generator(seed),
+	_candidates()
+{
+}
+
+PlayerAction RandomPolicy::nextAction(const Player& self, const Player& opponent)
+{
+	listActions(self, opponent, _candidates);
+	return _candidates[static_cast<std::size_t>(_generator.next(static_cast<int>(_candidates.size())))];
+}
+
+std::vector<int> RandomPolicy::selectCards(const Player& self, const Player& opponent, const std::vector<CardToSelect>& selection)
+{
+	std::vector<int> indices(selection.size(), 0);
+	for(std::size_t i{0}; i < selection.size(); ++i)
+	{
+		const int size{getZoneSize(self, opponent, selection[i])};
+		if(size > 0)
+			indices[i] = _generator.next(size);
+	}
+	return indices;
+}
+
+///////////////////////// ScriptedPolicy
+
+ScriptedPolicy::ScriptedPolicy(const std::vector<PlayerAction>& actions, const std::vector<std::vector<int>>& selections):
+	_actions(actions),
+	_selections(selections),
+	_nextAction(0),
+	_nextSelection(0)
+{
+}
+
+PlayerAction ScriptedPolicy::nextAction(const Player& /* self */, const Player& /* opponent */)
+{
+	if(_nextAction == _actions.size())
+		return {TransferType::GAME_PLAYER_LEAVE_TURN, 0, 0};
+	return _actions[_nextAction++];
+}
+
+std::vector<int> ScriptedPolicy::selectCards(const Player& /* self */, const Player& /* opponent */, const std::vector<CardToSelect>& selection)
+{
+	if(_nextSelection == _selections.size())
+		return std::vector<int>(selection.size(), 0);
+	std::vector<int> indices(_selections[_nextSelection++]);
+	indices.resize(selection.size(), 0);
+	return indices;
+}
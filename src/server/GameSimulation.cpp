@@ -0,0 +1,410 @@
+// WizardPoker headers
+#include "server/GameSimulation.hpp"
+// std-C++ headers
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <array>
+#include <memory>
+#include <cassert>
+
+constexpr int GameSimulation::maxActionsPerTurn;
+constexpr int GameSimulation::maxTurns;
+
+/// \return True if \a record is an empty selection: the previous versions of
+/// the server recorded one for each effect, even when nothing was selected
+static bool isSkippedSelection(const JournalRecord& record)
+{
+	return record.type == JournalRecordType::SELECTION and record.values.empty();
+}
+
+GameSimulation::GameSimulation(ServerDatabase& database, RandomInteger::Seed seed, UserId player1Id, UserId player2Id):
+	_player1Id(player1Id),
+	_player2Id(player2Id),
+	_postGameDataPlayer1(),
+	_postGameDataPlayer2(),
+	_casterVersion(0),
+	_cards(GameSnapshot::cardsCount),
+	_player1(*this, database, _cards, _player1Id, _player2, _postGameDataPlayer1),
+	_player2(*this, database, _cards, _player2Id, _player1, _postGameDataPlayer2),
+	_activePlayer(&_player1),
+	_passivePlayer(&_player2),
+	_seatPlayer1(*this, _player1, _player2),
+	_seatPlayer2(*this, _player2, _player1),
+	_running(false),
+	_turnSwap(false),
+	_verbose(false),
+	_turn(0),
+	_winnerId(0),
+	_endGameCause(EndGame::Cause::ENDING_SERVER),
+	_intGenerator(seed),
+	_journal(),
+	_replayedRecords(nullptr),
+	_nextRecord(0)
+{
+	if(_player1Id == _player2Id)
+		throw std::runtime_error("The players of a simulation must have different ids");
+	for(Player* player: {&_player1, &_player2})
+	{
+		player->setController(getSeat(*player));
+		// nobody displays the game
+		player->setBoardChangesLogged(false);
+	}
+	// same choice as GameThread, with the seeded generator
+	if(_intGenerator.next(2) == 1)
+		std::swap(_activePlayer, _passivePlayer);
+}
+
+UserId GameSimulation::play(const Deck& deck1, GamePolicy& policy1, const Deck& deck2, GamePolicy& policy2)
+{
+	_running = true;
+	// same order as GameThread, the shuffles use the generator of the game
+	_activePlayer->setDeck(_activePlayer == &_player1 ? deck1 : deck2);
+	_passivePlayer->setDeck(_passivePlayer == &_player1 ? deck1 : deck2);
+	setUpGame();
+	return playOut(policy1, policy2);
+}
+
+UserId GameSimulation::playOut(GamePolicy& policy1, GamePolicy& policy2)
+{
+	assert(_running);
+	_seatPlayer1.policy = &policy1;
+	_seatPlayer2.policy = &policy2;
+	int actionsInTurn{0};
+	while(_running)
+	{
+		if(_turnSwap or actionsInTurn == maxActionsPerTurn)
+		{
+			endTurn();
+			actionsInTurn = 0;
+			if(_turn == maxTurns and _running)
+				endGame(0, EndGame::Cause::ENDING_SERVER);
+			continue;
+		}
+		const PlayerAction action{getSeat(*_activePlayer).policy->nextAction(*_activePlayer, *_passivePlayer)};
+		++actionsInTurn;
+		_activePlayer->handleAction(action);
+	}
+	_journal.record(JournalRecordType::GAME_OVER, _player1Id, {_winnerId, static_cast<std::int64_t>(_endGameCause),
+			_player1.getHealth(), _player2.getHealth()});
+	_journal.close();
+	return _winnerId;
+}
+
+UserId GameSimulation::replay(GameJournalReader& journal)
+{
+	std::vector<JournalRecord> records;
+	JournalRecord record;
+	while(journal.next(record))
+		records.push_back(record);
+	// the journal of a resumed game starts from its checkpoint
+	bool isComplete;
+	if(not records.empty() and records.front().type == JournalRecordType::CHECKPOINT)
+	{
+		std::unique_ptr<GameSnapshot> snapshot{new GameSnapshot};
+		if(not GameJournal::decodeSnapshot(records.front().values, *snapshot))
+			throw std::runtime_error("The checkpoint of the journal is not a snapshot of this server");
+		isComplete = restore(*snapshot, records);
+	}
+	else
+		isComplete = restore(journal.getHeader(), records);
+	if(not isComplete)
+		std::cerr << "The journal is incomplete, the game was replayed up to its last record\n";
+	_running = false;
+	return _winnerId;
+}
+
+bool GameSimulation::restore(const JournalHeader& header, const std::vector<JournalRecord>& records)
+{
+	if(header.player1Id != _player1Id or header.player2Id != _player2Id)
+		throw std::runtime_error("The journal is not a game between these players");
+	_replayedRecords = &records;
+	_nextRecord = 0;
+	_seatPlayer1.policy = _seatPlayer2.policy = nullptr;
+	_running = true;
+	// replay the random choices made in the original game, from its beginning
+	_intGenerator.setSeed(header.seed);
+	_activePlayer = &_player1;
+	_passivePlayer = &_player2;
+	if(_intGenerator.next(2) == 1)
+		std::swap(_activePlayer, _passivePlayer);
+	if(_activePlayer->getId() != header.firstPlayerId)
+		throw std::runtime_error("Replay diverged: the first player is not the recorded one");
+
+	// the decks are shuffled again, in the recorded order
+	for(int i{0}; i < 2; ++i)
+	{
+		if(_nextRecord == records.size() or records[_nextRecord].type != JournalRecordType::DECK
+		   or records[_nextRecord].values.size() != Deck::size)
+			throw std::runtime_error("Replay diverged: the journal does not start with the decks");
+		const JournalRecord& record(records[_nextRecord++]);
+		std::array<CardId, Deck::size> cards;
+		std::copy(record.values.begin(), record.values.end(), cards.begin());
+		getRecordedPlayer(record.player).setDeck(Deck("", cards));
+	}
+	setUpGame();
+	return replayRecords();
+}
+
+bool GameSimulation::restore(const GameSnapshot& snapshot, const std::vector<JournalRecord>& records)
+{
+	load(snapshot);
+	_replayedRecords = &records;
+	_nextRecord = 0;
+	_seatPlayer1.policy = _seatPlayer2.policy = nullptr;
+	return replayRecords();
+}
+
+bool GameSimulation::replayRecords()
+{
+	const std::vector<JournalRecord>& records(*_replayedRecords);
+	bool gameOverRecorded{false};
+	while(not gameOverRecorded and _nextRecord < records.size())
+	{
+		// the selections are read by the seats, during the actions
+		const JournalRecord& record(records[_nextRecord++]);
+		Player& player(getRecordedPlayer(record.player));
+		// the card used last is suspended only if its selection is not recorded
+		if(_activePlayer->isAwaitingSelection() and (record.type == JournalRecordType::USE_CARD
+		   or record.type == JournalRecordType::ATTACK_WITH_CREATURE))
+			throw std::runtime_error("Replay diverged: selection of player " + std::to_string(_activePlayer->getId())
+					+ " expected at record " + std::to_string(_nextRecord));
+		if(isSkippedSelection(record))
+			continue;
+		switch(record.type)
+		{
+		case JournalRecordType::USE_CARD:
+			player.handleAction({TransferType::GAME_USE_CARD, static_cast<int>(record.values.at(0)), 0});
+			break;
+		case JournalRecordType::ATTACK_WITH_CREATURE:
+			player.handleAction({TransferType::GAME_ATTACK_WITH_CREATURE, static_cast<int>(record.values.at(0)),
+					static_cast<int>(record.values.at(1))});
+			break;
+		case JournalRecordType::QUIT_GAME:
+			player.handleAction({TransferType::GAME_QUIT_GAME, 0, 0});
+			break;
+		case JournalRecordType::TURN_SWAP:
+			if(&player != _activePlayer)
+				throw std::runtime_error("Replay diverged: turn swap of the passive player at record "
+						+ std::to_string(_nextRecord));
+			endTurn();
+			break;
+		case JournalRecordType::LOST_CONNECTION:
+		{
+			// same as GameThread::loseConnection
+			Player& otherPlayer(&player == &_player1 ? _player2 : _player1);
+			otherPlayer._postGameData.playerWon = true;
+			player._postGameData.playerRageQuit = true;
+			endGame(otherPlayer.getId(), EndGame::Cause::LOST_CONNECTION);
+			break;
+		}
+		case JournalRecordType::CHECKPOINT:
+			// the state of the checkpoint has been loaded by restore
+			if(_nextRecord != 1)
+				throw std::runtime_error("Replay diverged: checkpoint at record " + std::to_string(_nextRecord));
+			break;
+		case JournalRecordType::GAME_OVER:
+		{
+			gameOverRecorded = true;
+			// the replayed game must end the same way as the recorded one
+			if(_running)
+				endGame(0, EndGame::Cause::ENDING_SERVER);
+			const std::vector<std::int64_t> replayed{_winnerId, static_cast<std::int64_t>(_endGameCause),
+					_player1.getHealth(), _player2.getHealth()};
+			if(replayed != record.values)
+				throw std::runtime_error("Replay diverged: the game does not end as recorded");
+			break;
+		}
+		default:
+			throw std::runtime_error("Replay diverged: unexpected record at position "
+					+ std::to_string(_nextRecord));
+		}
+	}
+	_replayedRecords = nullptr;
+	return gameOverRecorded;
+}
+
+bool GameSimulation::isRunning() const
+{
+	return _running;
+}
+
+void GameSimulation::save(GameSnapshot& snapshot) const
+{
+	Player::saveGame(_player1, _player2, snapshot);
+	snapshot.activePlayer = _activePlayer == &_player1 ? 0 : 1;
+	snapshot.turn = _turn;
+	snapshot.running = _running;
+	snapshot.turnSwap = _turnSwap;
+	snapshot.winnerId = _winnerId;
+	snapshot.endGameCause = _endGameCause;
+	snapshot.generator = _intGenerator;
+}
+
+void GameSimulation::load(const GameSnapshot& snapshot)
+{
+	Player::loadGame(_player1, _player2, snapshot);
+	_activePlayer = snapshot.activePlayer == 0 ? &_player1 : &_player2;
+	_passivePlayer = snapshot.activePlayer == 0 ? &_player2 : &_player1;
+	_turn = snapshot.turn;
+	_running = snapshot.running;
+	_turnSwap = snapshot.turnSwap;
+	_winnerId = snapshot.winnerId;
+	_endGameCause = snapshot.endGameCause;
+	_intGenerator = snapshot.generator;
+}
+
+void GameSimulation::setUpGame()
+{
+	_activePlayer->setUpGame(true);
+	_passivePlayer->setUpGame(false);
+	// enterTurn is only called when the turns are swapped, the first turn is
+	// started explicitly
+	_activePlayer->enterTurn(1);
+}
+
+void GameSimulation::endTurn()
+{
+	// in a replay, the swaps are recorded: the ones the players ask for are ignored
+	_turnSwap = false;
+	if(not _running)
+		return;
+	_journal.record(JournalRecordType::TURN_SWAP, _activePlayer->getId());
+	_turn++;  // turn counter (for both players)
+	_activePlayer->leaveTurn();
+	std::swap(_activePlayer, _passivePlayer);
+	_activePlayer->enterTurn(_turn/2 + 1);
+}
+
+EndGame::Cause GameSimulation::getEndGameCause() const
+{
+	return _endGameCause;
+}
+
+int GameSimulation::getTurnsCount() const
+{
+	return _turn + 1;
+}
+
+UserId GameSimulation::getFirstPlayerId() const
+{
+	// the players are swapped at each turn
+	return _turn % 2 == 0 ? _activePlayer->getId() : _passivePlayer->getId();
+}
+
+const Player& GameSimulation::getPlayer(UserId playerId) const
+{
+	if(playerId == _player1Id)
+		return _player1;
+	if(playerId == _player2Id)
+		return _player2;
+	throw std::runtime_error("Player " + std::to_string(playerId) + " is not in this game");
+}
+
+Player& GameSimulation::getRecordedPlayer(UserId playerId)
+{
+	if(playerId == _player1Id)
+		return _player1;
+	if(playerId == _player2Id)
+		return _player2;
+	throw std::runtime_error("Player " + std::to_string(playerId) + " is not in this game");
+}
+
+GameSimulation::Seat& GameSimulation::getSeat(const Player& player)
+{
+	return &player == &_player1 ? _seatPlayer1 : _seatPlayer2;
+}
+
+void GameSimulation::setVerbose(bool verbose)
+{
+	_verbose = verbose;
+}
+
+//////////////// Interface for Player
+
+void GameSimulation::endGame(UserId winnerId, EndGame::Cause cause)
+{
+	_winnerId = winnerId;
+	_endGameCause = cause;
+	_running = false;
+}
+
+void GameSimulation::swapTurns()
+{
+	_turnSwap = true;
+}
+
+RandomInteger& GameSimulation::getGenerator()
+{
+	return _intGenerator;
+}
+
+GameJournal& GameSimulation::getJournal()
+{
+	return _journal;
+}
+
+Constraints::CasterVersion& GameSimulation::getCasterVersion()
+{
+	return _casterVersion;
+}
+
+GameStats* GameSimulation::getStats()
+{
+	// the simulations are played by thousands (bots, balance), they are not measured
+	return nullptr;
+}
+
+void GameSimulation::printVerbose(const std::string& message)
+{
+	if(not _verbose)
+		return;
+
+	std::istringstream iss("simulation - " + message);
+	std::string line;
+	while(std::getline(iss, line))
+		std::cout << "\t" << line << std::endl;  //print each line with indentation
+}
+
+bool GameSimulation::isVerbose() const
+{
+	return _verbose;
+}
+
+//////////////// Replay
+
+bool GameSimulation::nextReplayedSelection(UserId player, std::vector<int>& indices)
+{
+	assert(_replayedRecords != nullptr);
+	const std::vector<JournalRecord>& records(*_replayedRecords);
+	while(_nextRecord < records.size() and isSkippedSelection(records[_nextRecord]))
+		_nextRecord++;
+	if(_nextRecord == records.size() or records[_nextRecord].type != JournalRecordType::SELECTION
+	   or records[_nextRecord].player != player)
+		return false;
+	const JournalRecord& record(records[_nextRecord++]);
+	indices.assign(record.values.begin(), record.values.end());
+	return true;
+}
+
+//////////////// Seat
+
+GameSimulation::Seat::Seat(GameSimulation& simulation, const Player& self, const Player& opponent):
+	policy(nullptr),
+	_simulation(simulation),
+	_self(self),
+	_opponent(opponent)
+{
+}
+
+void GameSimulation::Seat::send(sf::Packet& /* packet */)
+{
+}
+
+bool GameSimulation::Seat::selectCards(const std::vector<CardToSelect>& selection, std::vector<int>& indices)
+{
+	if(_simulation._replayedRecords != nullptr)
+		return _simulation.nextReplayedSelection(_self.getId(), indices);
+	indices = policy->selectCards(_self, _opponent, selection);
+	return true;
+}
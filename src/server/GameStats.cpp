@@ -0,0 +1,21 @@
+// WizardPoker headers
+#include "server/GameStats.hpp"
+
+/// \return The line of \a histogram, the values are divided by \a unit
+static std::string displayHistogram(const std::string& prefix, const char* name, const Histogram& histogram,
+		std::uint64_t unit, const char* unitName)
+{
+	return prefix + name + ": count " + std::to_string(histogram.getCount())
+			+ ", p50 " + std::to_string(histogram.getValueAtPercentile(50) / unit)
+			+ ", p99 " + std::to_string(histogram.getValueAtPercentile(99) / unit)
+			+ ", max " + std::to_string(histogram.getMax() / unit) + " " + unitName + "\n";
+}
+
+std::string GameStats::display(const std::string& prefix) const
+{
+	return displayHistogram(prefix, "actionToUpdate", actionToUpdate, 1000, "us")
+			+ displayHistogram(prefix, "effectResolution", effectResolution, 1000, "us")
+			+ displayHistogram(prefix, "boardChangeBytes", boardChangeBytes, 1, "B")
+			+ displayHistogram(prefix, "socketSendTime", socketSendTime, 1000, "us")
+			+ displayHistogram(prefix, "turnTimerDrift", turnTimerDrift, 1000000, "ms");
+}
@@ -0,0 +1,107 @@
+// WizardPoker headers
+#include "server/Histogram.hpp"
+// std-C++ headers
+#include <algorithm>
+
+constexpr std::size_t Histogram::subBucketBits;
+constexpr std::size_t Histogram::subBucketsCount;
+constexpr std::size_t Histogram::bucketsCount;
+
+/// \return The index of the highest bit set in \a value
+/// \pre value != 0
+static std::size_t highestBit(std::uint64_t value)
+{
+	std::size_t bit{0};
+	for(std::size_t shift{32}; shift > 0; shift /= 2)
+		if(value >> shift != 0)
+		{
+			value >>= shift;
+			bit += shift;
+		}
+	return bit;
+}
+
+Histogram::Histogram():
+	_buckets(),
+	_count{0},
+	_sum{0},
+	_max{0}
+{
+}
+
+void Histogram::record(std::uint64_t value)
+{
+	// a single thread writes, a load and a store are enough (and much cheaper
+	// than a fetch_add, which locks the cache line)
+	std::atomic<std::uint64_t>& bucket(_buckets[getBucketIndex(value)]);
+	bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	_sum.store(_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	if(value > _max.load(std::memory_order_relaxed))
+		_max.store(value, std::memory_order_relaxed);
+	// the count is written last, a reader that sees it sees the bucket too
+	_count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Histogram::recordSince(std::chrono::steady_clock::time_point start)
+{
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	record(static_cast<std::uint64_t>(std::max<std::int64_t>(0,
+			std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())));
+}
+
+std::uint64_t Histogram::getCount() const
+{
+	return _count.load(std::memory_order_acquire);
+}
+
+std::uint64_t Histogram::getSum() const
+{
+	return _sum.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::getMax() const
+{
+	return _max.load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::getValueAtPercentile(double percentile) const
+{
+	const std::uint64_t count{getCount()};
+	if(count == 0)
+		return 0;
+	// rank of the value, at least the first one
+	const double clamped{std::min(std::max(percentile, 0.), 100.)};
+	const std::uint64_t rank{std::max<std::uint64_t>(1, static_cast<std::uint64_t>(clamped / 100. * static_cast<double>(count) + 0.5))};
+	std::uint64_t seen{0};
+	for(std::size_t i{0}; i < bucketsCount; ++i)
+	{
+		seen += getBucketCount(i);
+		if(seen >= rank)
+			return std::min(getBucketUpperBound(i), getMax());
+	}
+	// the buckets are being written, the last values are not counted yet
+	return getMax();
+}
+
+std::uint64_t Histogram::getBucketCount(std::size_t index) const
+{
+	return _buckets[index].load(std::memory_order_relaxed);
+}
+
+std::uint64_t Histogram::getBucketUpperBound(std::size_t index)
+{
+	if(index < subBucketsCount)
+		return index;
+	const std::size_t shift{index / subBucketsCount - 1};
+	const std::uint64_t lowest{static_cast<std::uint64_t>(subBucketsCount + index % subBucketsCount) << shift};
+	return lowest + ((std::uint64_t(1) << shift) - 1);
+}
+
+std::size_t Histogram::getBucketIndex(std::uint64_t value)
+{
+	// the small values have a bucket each
+	if(value < subBucketsCount)
+		return static_cast<std::size_t>(value);
+	const std::size_t shift{highestBit(value) - subBucketBits};
+	return (shift + 1) * subBucketsCount + static_cast<std::size_t>((value >> shift) & (subBucketsCount - 1));
+}
@@ -1,45 +1,60 @@
 // WizardPoker headers
 #include "server/Player.hpp"
-#include "server/GameThread.hpp"
 #include "common/sockets/TransferType.hpp"
 #include "common/sockets/PacketOverload.hpp"
 #include "common/random/RandomInteger.hpp"
 // std-C++ headers
 #include <iostream>
 #include <algorithm>
+#include <numeric>
 #include <cassert>
+#include <chrono>
+#include <cstring>
+#include <string>
 // SFML headers
 #include <SFML/Network/Packet.hpp>
 
-/*------------------------------ CONSTRUCTOR AND INIT */
-std::array<std::function<void(Player&, EffectArgs)>, P_EFFECTS_COUNT> Player::_effectMethods =
+/// \return The effects of \a card
+static const CardEffects& getCardEffects(const Card* card)
 {
-	&Player::setConstraint,
-	&Player::pickDeckCards,
-	&Player::loseHandCards,
-	&Player::reviveGraveyardCard,
-
-	&Player::stealHandCard,
-	&Player::exchgHandCard,
+	// Maybe I should have use multiple inheritance to avoid this
+	return card->isSpell()
+		? static_cast<const Spell *>(card)->getEffects()
+		: static_cast<const Creature *>(card)->getEffects();
+}
 
-	&Player::resetEnergy,
-	&Player::changeEnergy,
-	&Player::changeHealth,
-};
+/*------------------------------ CONSTRUCTOR AND INIT */
+constexpr Player::TurnData Player::_emptyTurnData;
 
-Player::Player(GameThread& gameThread, ServerDatabase& database, UserId id, Player& opponent, PostGameData& postGameData):
+Player::Player(GameContext& game, ServerDatabase& database, CardArena& cards, UserId id, Player& opponent, PostGameData& postGameData):
 	_postGameData(postGameData),
-	_gameThread(gameThread),
+	_game(game),
 	_database(database),
+	_controller(nullptr),
 	_opponent(opponent),
 	_id(id),
-	_isActive(false)
+	_isActive(false),
+	_logBoardChanges(true),
+	_constraints(playerDefaultConstraints, game.getCasterVersion()),
+	_teamConstraints(creatureDefaultConstraints, game.getCasterVersion()),
+	_cards(cards),
+	_cardDeck(_cards),
+	_cardHand(_cards),
+	_cardBoard(_cards),
+	_cardGraveyard(_cards),
+	_cardUse{nullptr, 0}
 {
-	// Input sockets are non-blocking, this is easier since the sockets of the
-	// two players are separated in the Player instances. So that as soon as a
-	// packet is received, the packet is handled, rather than waiting that the
-	// other Player instance receives a packet from the other client.
-	_socketToClient.setBlocking(false);
+}
+
+void Player::setController(PlayerController& controller)
+{
+	_controller = &controller;
+}
+
+void Player::setBoardChangesLogged(bool logged)
+{
+	_logBoardChanges = logged;
+	_pendingBoardChanges.clear();
 }
 
 int Player::getHealth() const
@@ -52,7 +67,17 @@ int Player::getMaxHealth()
 	return _maxHealth;
 }
 
-std::vector<std::unique_ptr<Card>>::size_type Player::getHandSize() const
+int Player::getEnergy() const
+{
+	return _energy;
+}
+
+const Player::Cards& Player::getHand() const
+{
+	return _cardHand;
+}
+
+Player::Cards::size_type Player::getHandSize() const
 {
 	return _cardHand.size();
 }
@@ -62,7 +87,12 @@ UserId Player::getId() const
 	return _id;
 }
 
-const std::vector<std::unique_ptr<Creature>>& Player::getBoard() const
+const Player::Board& Player::getBoard() const
+{
+	return _cardBoard;
+}
+
+Player::Board Player::getBoardCreatures() const
 {
 	return _cardBoard;
 }
@@ -79,38 +109,249 @@ sf::Packet Player::getBoardChanges()
 	return res;
 }
 
-void Player::setDeck(const Deck& newDeck)
+void Player::appendPublicState(sf::Packet& packet) const
 {
-	std::vector<std::unique_ptr<Card>> loadedCards{Deck::size};
-	for(std::size_t i{0}; i < Deck::size; ++i)
+	// cast to be sure that the right amount of bits is sent and received
+	packet << _id << static_cast<sf::Uint32>(_health) << static_cast<sf::Uint32>(_energy)
+	       << static_cast<sf::Uint32>(_cardHand.size()) << static_cast<sf::Uint32>(_cardDeck.size());
+	// same format as a std::vector (see PacketOverload.hpp), without building one
+	packet << static_cast<sf::Uint32>(_cardBoard.size());
+	for(const Creature* creature : _cardBoard)
+		packet << static_cast<BoardCreatureData>(*creature);
+	packet << static_cast<sf::Uint32>(_cardGraveyard.size());
+	for(const Card* card : _cardGraveyard)
 	{
-		const CardId card{newDeck.getCard(i)};
-		loadedCards[i].reset(_database.getCard(card, *this));
+		CardData data;
+		data.id = card->getId();
+		packet << data;
 	}
+}
 
-	// shuffle the deck of cards
-	std::shuffle(loadedCards.begin(), loadedCards.end(), std::mt19937(std::random_device()()));
-	for(auto& cardInShuffledDeck: loadedCards)
-		_cardDeck.push(std::move(cardInShuffledDeck));
+void Player::setDeck(const Deck& newDeck)
+{
+	std::vector<CardId> cards(newDeck.begin(), newDeck.end());
+	// the deck is recorded before being shuffled, so that a replay shuffles
+	// it again and draws the same random numbers as the game
+	_game.getJournal().record(JournalRecordType::DECK, _id, std::vector<std::int64_t>(cards.begin(), cards.end()));
+	// shuffle the deck of cards (Fisher-Yates, with the generator of the game
+	// so that the game can be reproduced from its seed)
+	RandomInteger& generator(_game.getGenerator());
+	for(std::size_t i{cards.size() - 1}; i > 0; --i)
+		std::swap(cards[i], cards[static_cast<std::size_t>(generator.next(static_cast<int>(i) + 1))]);
+	loadDeck(cards);
+}
+
+void Player::loadDeck(const std::vector<CardId>& cards)
+{
+	for(const CardId card: cards)
+		_cardDeck.push_back(_database.getCard(card, *this, _cards));
 	assert(_cardDeck.size() == Deck::size);
 }
 
-void Player::receiveDeck()
+/*------------------------------ SNAPSHOTS */
+void Player::saveGame(const Player& player1, const Player& player2, GameSnapshot& snapshot)
+{
+	assert(not player1.isAwaitingSelection() and not player2.isAwaitingSelection());
+	std::vector<const Card*> cards;
+	cards.reserve(GameSnapshot::cardsCount);
+	player1.listCards(cards);
+	player2.listCards(cards);
+	assert(cards.size() == GameSnapshot::cardsCount);
+	std::vector<const Creature*> casters(cards.size(), nullptr);
+	for(std::size_t i{0}; i < cards.size(); ++i)
+		if(cards[i]->isCreature())
+			casters[i] = static_cast<const Creature*>(cards[i]);
+
+	// the padding and the members of the spells are set too, so that equal
+	// games give equal snapshots, byte for byte
+	std::memset(static_cast<void*>(&snapshot), 0, sizeof(snapshot));
+	for(std::size_t i{0}; i < cards.size(); ++i)
+	{
+		CardSnapshot& card(snapshot.cards[i]);
+		card.id = cards[i]->getId();
+		if(casters[i] == nullptr)
+			continue;
+		card.owner = &casters[i]->getOwner() == &player1 ? 0 : 1;
+		casters[i]->save(card, casters);
+	}
+	player1.save(snapshot.players[0], cards, casters);
+	player2.save(snapshot.players[1], cards, casters);
+}
+
+void Player::loadGame(Player& player1, Player& player2, const GameSnapshot& snapshot)
 {
-	sf::Packet deckPacket;
-	TransferType type;
-	std::string deckName;
+	if(player1._id != snapshot.players[0].id or player2._id != snapshot.players[1].id)
+		throw std::runtime_error("The snapshot is not a game between these players");
+	checkSnapshotLayout(snapshot);
+	Player* const players[2]{&player1, &player2};
+	std::vector<Card*> cards(GameSnapshot::cardsCount);
+	assert(&player1._cards == &player2._cards);
+	if(findCards(player1._cards, snapshot, cards))
+	{
+		// the cards are known, only their places remain to be checked
+		for(std::size_t i{0}; i < cards.size(); ++i)
+			if(isOnBoard(snapshot, i) and not cards[i]->isCreature())
+				throw std::runtime_error("Invalid snapshot: the card " + std::to_string(i) + " is on a board but is not a creature");
+	}
+	else
+	{
+		// the snapshot is checked before the current cards are destroyed
+		checkSnapshot(player1._database, snapshot);
+		// the cards of the loaded game replace all the current ones
+		player1._cards.clear();
+		for(std::size_t i{0}; i < cards.size(); ++i)
+		{
+			Player& owner(*players[snapshot.cards[i].owner == 0 ? 0 : 1]);
+			cards[i] = player1._database.getCard(snapshot.cards[i].id, owner, owner._cards);
+		}
+	}
+	std::vector<const Creature*> casters(cards.size(), nullptr);
+	for(std::size_t i{0}; i < cards.size(); ++i)
+		if(cards[i]->isCreature())
+			casters[i] = static_cast<const Creature*>(cards[i]);
+	for(std::size_t i{0}; i < cards.size(); ++i)
+		if(casters[i] != nullptr)
+			static_cast<Creature*>(cards[i])->load(snapshot.cards[i], *players[snapshot.cards[i].owner == 0 ? 0 : 1], casters);
+	const PlayerSnapshot& first(snapshot.players[0]);
+	const std::size_t player2FirstCard{static_cast<std::size_t>(first.deckSize + first.handSize
+			+ first.boardSize + first.graveyardSize)};
+	// the last casters must be resolved before the cards are moved
+	player1._lastCasterCard = first.lastCaster == Constraints::noCaster ? nullptr : cards.at(first.lastCaster);
+	player2._lastCasterCard = snapshot.players[1].lastCaster == Constraints::noCaster
+			? nullptr : cards.at(snapshot.players[1].lastCaster);
+	player1.load(first, cards, 0, casters);
+	player2.load(snapshot.players[1], cards, player2FirstCard, casters);
+	player1._constraints.casterChanged();
+}
+
+void Player::checkSnapshot(ServerDatabase& database, const GameSnapshot& snapshot)
+{
+	checkSnapshotLayout(snapshot);
+	for(std::size_t i{0}; i < snapshot.cards.size(); ++i)
+	{
+		const CommonCardData* data{database.getCardData(snapshot.cards[i].id)};
+		if(data == nullptr)
+			throw std::runtime_error("Invalid snapshot: the card " + std::to_string(snapshot.cards[i].id) + " does not exist");
+		if(isOnBoard(snapshot, i) and not data->isCreature())
+			throw std::runtime_error("Invalid snapshot: the card " + std::to_string(i) + " is on a board but is not a creature");
+	}
+}
 
-	// Have the socket blocking because the data is needed to go further
-	_socketToClient.setBlocking(true);
-	_socketToClient.receive(deckPacket);
-	_socketToClient.setBlocking(false);
-	deckPacket >> type;
-	if(type != TransferType::GAME_PLAYER_GIVE_DECK_NAMES)
-		throw std::runtime_error("Unable to get player " + std::to_string(getId()) + " deck");
-	deckPacket >> deckName;
+void Player::checkSnapshotLayout(const GameSnapshot& snapshot)
+{
+	if(snapshot.activePlayer > 1)
+		throw std::runtime_error("Invalid snapshot: the active player is " + std::to_string(snapshot.activePlayer));
+	std::size_t cardsCount{0};
+	for(const PlayerSnapshot& player : snapshot.players)
+	{
+		if(player.deckSize > Deck::size)
+			throw std::runtime_error("Invalid snapshot: a deck has " + std::to_string(player.deckSize) + " cards");
+		cardsCount += std::size_t{player.deckSize} + player.handSize + player.boardSize + player.graveyardSize;
+		if((player.lastCaster != Constraints::noCaster and player.lastCaster >= GameSnapshot::cardsCount)
+		   or not Constraints::isValid(player.constraints, playerDefaultConstraints, GameSnapshot::cardsCount)
+		   or not Constraints::isValid(player.teamConstraints, creatureDefaultConstraints, GameSnapshot::cardsCount))
+			throw std::runtime_error("Invalid snapshot: the constraints of a player refer to unknown cards");
+	}
+	if(cardsCount != GameSnapshot::cardsCount)
+		throw std::runtime_error("Invalid snapshot: the zones hold " + std::to_string(cardsCount) + " cards");
+	for(const CardSnapshot& card : snapshot.cards)
+		if(card.owner > 1 or not Constraints::isValid(card.constraints, creatureDefaultConstraints, GameSnapshot::cardsCount))
+			throw std::runtime_error("Invalid snapshot: the card " + std::to_string(card.id) + " has an unknown owner or caster");
+}
 
-	setDeck(_database.getDeckByName(getId(), deckName));
+bool Player::isOnBoard(const GameSnapshot& snapshot, std::size_t index)
+{
+	// the cards of a player are its deck, its hand, its board and its graveyard
+	std::size_t first{0};
+	for(const PlayerSnapshot& player : snapshot.players)
+	{
+		const std::size_t boardFirst{first + player.deckSize + player.handSize};
+		if(index >= boardFirst and index < boardFirst + player.boardSize)
+			return true;
+		first = boardFirst + player.boardSize + player.graveyardSize;
+	}
+	return false;
+}
+
+bool Player::findCards(const CardArena& arena, const GameSnapshot& snapshot, std::vector<Card*>& cards)
+{
+	if(arena.getCardsCount() != cards.size())
+		return false;
+	// the cards are matched by their tags, the cards themselves are not read
+	std::vector<CardArena::Index> available(cards.size());
+	std::iota(available.begin(), available.end(), CardArena::Index{0});
+	for(std::size_t i{0}; i < cards.size(); ++i)
+	{
+		const auto card = std::find_if(available.begin(), available.end(), [&arena, &snapshot, i](CardArena::Index candidate)
+		{
+			return arena.getTag(candidate).id == snapshot.cards[i].id;
+		});
+		if(card == available.end())
+			return false;
+		cards[i] = arena.getCard(*card);
+		*card = available.back();
+		available.pop_back();
+	}
+	return true;
+}
+
+void Player::listCards(std::vector<const Card*>& cards) const
+{
+	cards.insert(cards.end(), _cardDeck.begin(), _cardDeck.end());
+	cards.insert(cards.end(), _cardHand.begin(), _cardHand.end());
+	cards.insert(cards.end(), _cardBoard.begin(), _cardBoard.end());
+	cards.insert(cards.end(), _cardGraveyard.begin(), _cardGraveyard.end());
+}
+
+void Player::save(PlayerSnapshot& snapshot, const std::vector<const Card*>& cards, const std::vector<const Creature*>& casters) const
+{
+	snapshot.id = _id;
+	snapshot.isActive = _isActive.load();
+	snapshot.energyInit = _energyInit;
+	snapshot.energy = _energy;
+	snapshot.healthInit = _healthInit;
+	snapshot.health = _health;
+	snapshot.turnsSinceEmptyDeck = _turnsSinceEmptyDeck;
+	snapshot.turnData = _turnData;
+	snapshot.postGameData = _postGameData;
+	_constraints.save(snapshot.constraints, casters);
+	_teamConstraints.save(snapshot.teamConstraints, casters);
+	const auto lastCaster = std::find(cards.begin(), cards.end(), _lastCasterCard);
+	snapshot.lastCaster = lastCaster == cards.end() ? Constraints::noCaster : static_cast<Constraints::CasterIndex>(lastCaster - cards.begin());
+	snapshot.deckSize = static_cast<std::uint8_t>(_cardDeck.size());
+	snapshot.handSize = static_cast<std::uint8_t>(_cardHand.size());
+	snapshot.boardSize = static_cast<std::uint8_t>(_cardBoard.size());
+	snapshot.graveyardSize = static_cast<std::uint8_t>(_cardGraveyard.size());
+}
+
+void Player::load(const PlayerSnapshot& snapshot, const std::vector<Card*>& cards, std::size_t firstCard,
+		const std::vector<const Creature*>& casters)
+{
+	_isActive.store(snapshot.isActive);
+	_energyInit = snapshot.energyInit;
+	_energy = snapshot.energy;
+	_healthInit = snapshot.healthInit;
+	_health = snapshot.health;
+	_turnsSinceEmptyDeck = snapshot.turnsSinceEmptyDeck;
+	_turnData = snapshot.turnData;
+	_postGameData = snapshot.postGameData;
+	_constraints.load(snapshot.constraints, casters);
+	_teamConstraints.load(snapshot.teamConstraints, casters);
+	_pendingBoardChanges.clear();
+	_cardUse = {nullptr, 0};
+
+	auto card = cards.begin() + static_cast<std::ptrdiff_t>(firstCard);
+	_cardDeck.assign(card, card + snapshot.deckSize);
+	card += snapshot.deckSize;
+	_cardHand.assign(card, card + snapshot.handSize);
+	card += snapshot.handSize;
+	_cardBoard.clear();
+	for(std::size_t i{0}; i < snapshot.boardSize; ++i)
+	{
+		assert((*card)->isCreature());
+		_cardBoard.push_back(static_cast<Creature*>(*card++));
+	}
+	_cardGraveyard.assign(card, card + snapshot.graveyardSize);
 }
 
 void Player::setUpGame(bool isActivePlayer)
@@ -118,7 +359,6 @@ void Player::setUpGame(bool isActivePlayer)
 	printVerbose(std::string("Player::setUpGame(") + (isActivePlayer ? "true" : "false") + ")");
 
 	// post game data
-	_postGameData.opponentInDaClub = _database.getWithInDaClub(_opponent.getId());
 	_postGameData.playerStarted = isActivePlayer;
 
 	// init Player's data
@@ -128,17 +368,31 @@ void Player::setUpGame(bool isActivePlayer)
 	_energy = _energyInit = 0;
 	_health = _healthInit = 20;
 
+	_isActive.store(isActivePlayer); // Player has become active/passive
+	sendGameStarting();
+}
+
+void Player::resumeGame()
+{
+	printVerbose("Player::resumeGame()");
+	sendGameStarting();
+	// the request may have been lost with the previous connection
+	std::vector<int> selectedIndices;
+	if(isAwaitingSelection() and _controller->selectCards(getCardEffects(_cardUse.card).getSelection(), selectedIndices))
+		receiveSelection(selectedIndices);
+}
+
+void Player::sendGameStarting()
+{
 	// log & send
 	logEverything();
-	_socketToClient.send(_pendingBoardChanges);
+	_controller->send(_pendingBoardChanges);
 	_pendingBoardChanges.clear();
 
 	// send GAME_STARTING packet
 	sf::Packet packet;
-	packet << TransferType::GAME_STARTING << (isActivePlayer ? TransferType::GAME_PLAYER_ENTER_TURN : TransferType::GAME_PLAYER_LEAVE_TURN);
-	_socketToClient.send(packet);
-
-	_isActive.store(isActivePlayer); // Player has become active/passive
+	packet << TransferType::GAME_STARTING << (_isActive.load() ? TransferType::GAME_PLAYER_ENTER_TURN : TransferType::GAME_PLAYER_LEAVE_TURN);
+	_controller->send(packet);
 }
 
 void Player::enterTurn(int turn)
@@ -162,9 +416,10 @@ void Player::enterTurn(int turn)
 	if(_cardDeck.empty())
 		changeHealth({_constraints.getConstraint(PC_TURN_HEALTH_CHANGE_DECK_EMPTY)});
 
-	// his Creature's turn-based constraints
-	for(unsigned i = 0; i < _cardBoard.size(); i++)
-		_cardBoard.at(i)->enterTurn();
+	// his Creature's turn-based constraints (they can kill the creatures)
+	for(Creature* creature : getBoardCreatures())
+		if(creature->isOnBoard())
+			creature->enterTurn();
 
 	// log all data, since most things change at the beginning of the turn
 	logEverything(); // also clears previous logs
@@ -173,6 +428,13 @@ void Player::enterTurn(int turn)
 
 void Player::leaveTurn()
 {
+	// the player did not choose the targets in time, the card is not used
+	if(isAwaitingSelection())
+	{
+		_cardUse.card = nullptr;
+		sendValueToClient(TransferType::FAILURE);
+	}
+
 	_isActive.store(false); // Player is no longer active
 
 	// Time out Player's constraints
@@ -190,24 +452,72 @@ void Player::finishGame(bool hasWon, EndGame::Cause cause)
 	_postGameData.playerWon = hasWon;
 	_postGameData.remainingHealth = _health;
 
-	_gameThread.endGame(hasWon ? getId() : _opponent.getId(), cause);
+	_game.endGame(hasWon ? getId() : _opponent.getId(), cause);
 }
 
 
 /*------------------------------ CLIENT INTERFACE */
-sf::Socket::Status Player::tryReceiveClientInput()
+void Player::handleClientInput(sf::Packet& playerActionPacket)
 {
-	sf::Packet playerActionPacket;
-	const sf::Socket::Status status{_socketToClient.receive(playerActionPacket)};
-	// If no data was received
-	if(status != sf::Socket::Done)
-		return status;
+	PlayerAction action{TransferType::FAILURE, 0, 0};
+	playerActionPacket >> action.type;
+	if(action.type == TransferType::GAME_SELECT_CARDS)
+	{
+		std::vector<sf::Uint32> indices;
+		playerActionPacket >> indices;
+		// the turn ended before the selection arrived, the card has not
+		// been used (see leaveTurn) and FAILURE has already been sent
+		if(not isAwaitingSelection())
+		{
+			printVerbose("Player::handleClientInput: late selection dropped");
+			return;
+		}
+		// convert the sf::Uint32 received on the network by implementation-defined integers
+		receiveSelection(std::vector<int>(indices.begin(), indices.end()));
+		return;
+	}
+	// the client is waiting for the result of the card use, it only sends
+	// its selection (or quits)
+	if(isAwaitingSelection() and action.type != TransferType::GAME_QUIT_GAME)
+	{
+		printVerbose("Player::handleClientInput: action dropped, a selection is awaited");
+		return;
+	}
 
-	TransferType type;
-	playerActionPacket >> type;
+	switch(action.type)
+	{
+		case TransferType::GAME_USE_CARD:
+		{
+			sf::Int32 cardIndex;
+			playerActionPacket >> cardIndex;
+			action.first = static_cast<int>(cardIndex);
+			break;
+		}
+
+		case TransferType::GAME_ATTACK_WITH_CREATURE:
+		{
+			sf::Int32 attackerIndex, victimIndex;
+			playerActionPacket >> attackerIndex >> victimIndex;
+			action.first = static_cast<int>(attackerIndex);
+			action.second = static_cast<int>(victimIndex);
+			break;
+		}
+
+		default:
+			// the other actions have no argument
+			break;
+	}
+	handleAction(action);
+}
+
+void Player::handleAction(const PlayerAction& action)
+{
+	GameJournal& journal(_game.getJournal());
+	const TransferType type{action.type};
 
 	if(type == TransferType::GAME_QUIT_GAME)
 	{
+		journal.record(JournalRecordType::QUIT_GAME, _id);
 		_opponent._postGameData.playerWon=true;
 		finishGame(false, EndGame::Cause::QUITTED);
 	}
@@ -217,7 +527,7 @@ sf::Socket::Status Player::tryReceiveClientInput()
 		if (_isActive.load() == false)
 		{
 			std::cout << "Passive player tried to cheat, perma ban ?\n";
-			return status;
+			return;
 		}
 
 		switch(type)
@@ -227,28 +537,22 @@ sf::Socket::Status Player::tryReceiveClientInput()
 				break;
 
 			case TransferType::GAME_USE_CARD:
-			{
-				sf::Int32 cardIndex;
-				playerActionPacket >> cardIndex;
-				useCard(static_cast<int>(cardIndex));
+				journal.record(JournalRecordType::USE_CARD, _id, {action.first});
+				useCard(action.first);
 				break;
-			}
 
 			case TransferType::GAME_ATTACK_WITH_CREATURE:
-			{
-				sf::Int32 attackerIndex, victimIndex;
-				playerActionPacket >> attackerIndex >> victimIndex;
-				attackWithCreature(static_cast<int>(attackerIndex), static_cast<int>(victimIndex));
+				journal.record(JournalRecordType::ATTACK_WITH_CREATURE, _id, {action.first, action.second});
+				attackWithCreature(action.first, action.second);
 				break;
-			}
+
 			// \TODO: add TransferType::GAME_QUIT and send if from client when game is quit ? (different from disconnected player)
 			default:
-				std::cerr << "Player::tryReceiveClientInput error: wrong packet header ("
+				std::cerr << "Player::handleAction error: wrong packet header ("
 				          << static_cast<sf::Uint32>(type) << "), expected in-game action header.\n";
 				break;
 		}
 	}
-	return status;
 }
 
 /// \network sends to client one of the following:
@@ -256,20 +560,23 @@ sf::Socket::Status Player::tryReceiveClientInput()
 ///	 + GAME_CARD_LIMIT_TURN_REACHED if the user cannot play cards for this turn
 ///	 + GAME_NOT_ENOUGH_ENERGY if the user has not enough energy to play this card
 ///	 + FAILURE  if the specialized type of the card (spell/creature) cannot be played anymore for this turn
+///	   or if one of the effects of a spell could not have been applied
+/// preceded by GAME_SELECT_CARDS if the user has to choose the targets of the effects
 void Player::useCard(int handIndex)
 {
 	Card* usedCard;
 	try //check the input
 	{
-		 usedCard = _cardHand.at(handIndex).get();
+		 usedCard = _cardHand.at(handIndex);
 	 }
 	catch(std::out_of_range&)
 	{
 		sendValueToClient(TransferType::FAILURE);
 		return;
 	}
+	const CardTag& usedTag(_cardHand.getTag(handIndex));
 	// check if player has enough energy to use the card
-	if(usedCard->getEnergyCost() > _energy)
+	if(usedTag.cost > _energy)
 	{
 		sendValueToClient(TransferType::GAME_NOT_ENOUGH_ENERGY);
 		return;
@@ -285,7 +592,43 @@ void Player::useCard(int handIndex)
 	_lastCasterCard = usedCard;
 	_opponent._lastCasterCard = usedCard;
 
-	(this->*(usedCard->isCreature() ? &Player::useCreature : &Player::useSpell))(handIndex, usedCard);
+	// check if player is allowed to place a creature or to call a spell
+	if(usedTag.isCreature
+			? _constraints.getConstraint(PC_TEMP_CREATURE_PLACING_LIMIT) == _turnData.creaturesPlaced
+			: _constraints.getConstraint(PC_TEMP_SPELL_CALL_LIMIT) == _turnData.spellCalls)
+	{
+		sendValueToClient(TransferType::FAILURE);
+		logCardUse();
+		return;
+	}
+
+	// the targets of all the effects are chosen at once, before the card is used
+	const std::vector<CardToSelect>& selection(getCardEffects(usedCard).getSelection());
+	std::vector<int> selectedIndices;
+	if(needsSelection(selection) and not _controller->selectCards(selection, selectedIndices))
+	{
+		// the card is used when the selection is received, see receiveSelection
+		_cardUse = {usedCard, handIndex};
+		return;
+	}
+	playCard(handIndex, usedCard, selectedIndices);
+}
+
+void Player::playCard(int handIndex, Card* usedCard, const std::vector<int>& selectedIndices)
+{
+	if(not selectedIndices.empty())
+		_game.getJournal().record(JournalRecordType::SELECTION, _id,
+				std::vector<std::int64_t>(selectedIndices.begin(), selectedIndices.end()));
+	GameStats* stats{_game.getStats()};
+	const auto startTime = stats != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	(this->*(usedCard->isCreature() ? &Player::useCreature : &Player::useSpell))(handIndex, usedCard, selectedIndices);
+	if(stats != nullptr)
+		stats->effectResolution.recordSince(startTime);
+	logCardUse();
+}
+
+void Player::logCardUse()
+{
 	logHandState();
 	_opponent.logOpponentHandState();
 	logCurrentEnergy();
@@ -298,47 +641,34 @@ void Player::useCard(int handIndex)
 
 ////////////////////// specialized card cases
 
-void Player::useCreature(int handIndex, Card* usedCard)
+void Player::useCreature(int handIndex, Card* usedCard, const std::vector<int>& selectedIndices)
 {
 	assert(usedCard->isCreature());
-	// check if player is allowed to place a creature
-	if (_constraints.getConstraint(PC_TEMP_CREATURE_PLACING_LIMIT) == _turnData.creaturesPlaced)
-	{
-		sendValueToClient(TransferType::FAILURE);
-		return;
-	}
-
 	_turnData.cardsUsed++;
 	_turnData.creaturesPlaced++;
 	_energy -= usedCard->getEnergyCost();
 
-	exploitCardEffects(usedCard);
+	// the creature is placed even if one of its effects could not have been applied
+	exploitCardEffects(usedCard, selectedIndices);
 	cardHandToBoard(handIndex);
 	sendValueToClient(TransferType::ACKNOWLEDGE);
 }
 
-void Player::useSpell(int handIndex, Card* usedCard)
+void Player::useSpell(int handIndex, Card* usedCard, const std::vector<int>& selectedIndices)
 {
-	// check if player is allowed to call a spell
-	if (_constraints.getConstraint(PC_TEMP_SPELL_CALL_LIMIT) == _turnData.spellCalls)
-	{
-		sendValueToClient(TransferType::FAILURE);
-		return;
-	}
-
 	_turnData.cardsUsed++;
 	_turnData.spellCalls++;
 	_energy -= usedCard->getEnergyCost();
 
 	// if one of the required effects could not have been applied, then
 	// the spell is not usable for now and so don't use the card
-	if(exploitCardEffects(usedCard))
+	if(exploitCardEffects(usedCard, selectedIndices))
 	{
 		cardHandToGraveyard(handIndex);
 		sendValueToClient(TransferType::ACKNOWLEDGE);
 	}
-	// no need to send FAILURE: exploitCardEffects call applyEffect
-	// which sends FAILURE the function returns false.
+	else
+		sendValueToClient(TransferType::FAILURE);
 }
 
 void Player::attackWithCreature(int attackerIndex, int victimIndex)
@@ -348,9 +678,9 @@ void Player::attackWithCreature(int attackerIndex, int victimIndex)
 	Creature* victim;
 	try //check the input
 	{
-		attacker = _cardBoard.at(attackerIndex).get();
+		attacker = _cardBoard.at(attackerIndex);
 		if(not attackOpponent)
-			victim = _opponent._cardBoard.at(victimIndex).get();
+			victim = _opponent._cardBoard.at(victimIndex);
 	}
 	catch (std::out_of_range&)
 	{
@@ -359,7 +689,8 @@ void Player::attackWithCreature(int attackerIndex, int victimIndex)
 	}
 
 	// check if we have enough energy to use this card
-	if(attacker->getEnergyCost() > _energy)
+	const int cost{_cardBoard.getTag(attackerIndex).cost};
+	if(cost > _energy)
 	{
 		sendValueToClient(TransferType::GAME_NOT_ENOUGH_ENERGY);
 		return;
@@ -373,11 +704,11 @@ void Player::attackWithCreature(int attackerIndex, int victimIndex)
 	}
 
 	_turnData.creatureAttacks++;
-	_energy -= attacker->getEnergyCost();
+	_energy -= cost;
 
 	if(attackOpponent)
 	{
-		_opponent.changeHealth({-attacker->getAttack()});
+		_opponent.changeHealth({-_cardBoard.getStats(attackerIndex).attack});
 		logOpponentHealth();
 		_opponent.logCurrentHealth();
 	}
@@ -396,14 +727,19 @@ void Player::attackWithCreature(int attackerIndex, int victimIndex)
 
 void Player::endTurn()
 {
-	_gameThread.swapTurns();
+	_game.swapTurns();
 }
 
 /*------------------------------ EFFECTS INTERFACE */
-bool Player::applyEffect(Card* usedCard, EffectArgs effect)
+/// \return True if \a index is the index of a creature of \a board
+static bool isBoardIndex(int index, const Player::Board& board)
 {
-	assert(effect.remainingArgs() != 0);
-	int subject{effect.getArg()};  // who the effect applies to
+	return index >= 0 and static_cast<std::size_t>(index) < board.size();
+}
+
+bool Player::applyEffect(Card* usedCard, const CardEffect& effect, int selectedIndex)
+{
+	const EffectSubject subject{effect.subject};  // who the effect applies to
 
 	_lastCasterCard = usedCard;  // remember last used card
 	_opponent._lastCasterCard = usedCard; // same for opponent
@@ -412,72 +748,52 @@ bool Player::applyEffect(Card* usedCard, EffectArgs effect)
 	switch(subject)
 	{
 		case PLAYER_SELF:  //passive player
-			askUserToSelectCards({});
 			applyEffectToSelf(effect);
 			break;
 
 		case PLAYER_OPPO:  //active player
-			askUserToSelectCards({});
 			_opponent.applyEffectToSelf(effect);
 			break;
 
 		case CREATURE_SELF_THIS:  //active player's creature that was used
-		{
-			askUserToSelectCards({});
-			Creature* usedCreature = dynamic_cast<Creature*>(usedCard);
-			applyEffectToCreature(usedCreature, effect);
-		}
+			assert(usedCard->isCreature());
+			applyEffectToCreature(static_cast<Creature*>(usedCard), effect);
 			break;
 
 		case CREATURE_SELF_INDX:  //active player's creature at given index
-			if(not _cardBoard.empty())
-				applyEffectToCreature(effect, askUserToSelectCards({CardToSelect::SELF_BOARD}));
+			// the chosen creature may have died because of a previous effect
+			if(isBoardIndex(selectedIndex, _cardBoard))
+				applyEffectToCreature(effect, selectedIndex);
 			else
-			{
-				sendValueToClient(TransferType::FAILURE);
 				ret = false;
-			}
 			break;
 
 		case CREATURE_SELF_RAND:  //active player's creature at random index
-			askUserToSelectCards({});
 			if(not _cardBoard.empty())
-				applyEffectToCreature(effect, getRandomBoardIndexes({CardToSelect::SELF_BOARD}));
+				applyEffectToCreature(effect, getRandomIndex(_cardBoard));
 			else
-			{
-				sendValueToClient(TransferType::FAILURE);
 				ret = false;
-			}
 			break;
 
 		case CREATURE_SELF_TEAM:  //active player's team of creatures
-			askUserToSelectCards({});
 			applyEffectToCreatureTeam(effect);
 			break;
 
 		case CREATURE_OPPO_INDX:	//passive player's creature at given index
-			if(not _opponent._cardBoard.empty())
-				_opponent.applyEffectToCreature(effect, askUserToSelectCards({CardToSelect::OPPO_BOARD}));
+			if(isBoardIndex(selectedIndex, _opponent._cardBoard))
+				_opponent.applyEffectToCreature(effect, selectedIndex);
 			else
-			{
-				sendValueToClient(TransferType::FAILURE);
 				ret = false;
-			}
 			break;
 
 		case CREATURE_OPPO_RAND:	//passive player's creature at random index
-			askUserToSelectCards({});
 			if(not _opponent._cardBoard.empty())
-				_opponent.applyEffectToCreature(effect, getRandomBoardIndexes({CardToSelect::OPPO_BOARD}));
+				_opponent.applyEffectToCreature(effect, getRandomIndex(_opponent._cardBoard));
 			else
-			{
-				sendValueToClient(TransferType::FAILURE);
 				ret = false;
-			}
 			break;
 
 		case CREATURE_OPPO_TEAM:	//passive player's team of creatures
-			askUserToSelectCards({});
 			_opponent.applyEffectToCreatureTeam(effect);
 			break;
 
@@ -487,33 +803,66 @@ bool Player::applyEffect(Card* usedCard, EffectArgs effect)
 	return ret;
 }
 
-void Player::applyEffectToSelf(EffectArgs effect)
+void Player::applyEffectToSelf(const CardEffect& effect)
 {
-	int method = effect.getArg();
-	_effectMethods.at(method)(*this, effect);  //call method on self
+	// the effect has been checked when the card templates were loaded (see
+	// CardEffects), the calls are direct so that the compiler can inline them
+	switch(effect.method)
+	{
+		case PE_SET_CONSTRAINT:
+			setConstraint(effect.getArgs());
+			break;
+		case PE_PICK_DECK_CARDS:
+			pickDeckCards(effect.getArgs());
+			break;
+		case PE_LOSE_HAND_CARDS:
+			loseHandCards(effect.getArgs());
+			break;
+		case PE_REVIVE_BIN_CARD:
+			reviveGraveyardCard(effect.getArgs());
+			break;
+		case PE_STEAL_HAND_CARD:
+			stealHandCard(effect.getArgs());
+			break;
+		case PE_EXCHG_HAND_CARD:
+			exchgHandCard(effect.getArgs());
+			break;
+		case PE_SET_ENERGY:
+			resetEnergy(effect.getArgs());
+			break;
+		case PE_CHANGE_ENERGY:
+			changeEnergy(effect.getArgs());
+			break;
+		case PE_CHANGE_HEALTH:
+			changeHealth(effect.getArgs());
+			break;
+		default:
+			throw std::runtime_error("Player effect not valid");
+	}
 }
 
-void Player::applyEffectToCreature(Creature* casterAndSubject, EffectArgs effect)
+void Player::applyEffectToCreature(Creature* casterAndSubject, const CardEffect& effect)
 {
 	casterAndSubject->applyEffectToSelf(effect); //call method on effect subject (same as caster)
 }
 
-void Player::applyEffectToCreature(EffectArgs effect, const std::vector<int>& boardIndexes)
+void Player::applyEffectToCreature(const CardEffect& effect, int boardIndex)
 {
-	_cardBoard.at(boardIndexes.at(0))->applyEffectToSelf(effect);
+	_cardBoard.at(boardIndex)->applyEffectToSelf(effect);
 }
 
-void Player::applyEffectToCreatureTeam(EffectArgs effect)
+void Player::applyEffectToCreatureTeam(const CardEffect& effect)
 {
 	//If the effect consists in setting a constraint
-	if(effect.peekArg() == CE_SET_CONSTRAINT)
+	if(effect.method == CE_SET_CONSTRAINT)
+		setTeamConstraint(effect.getArgs()); //set a team constraint instead of individual ones
+	else //other effects just get applied to each creature individually
 	{
-		effect.getArg();
-		setTeamConstraint(effect); //set a team constraint instead of individual ones
+		// the creatures that die leave the board, so it is copied first
+		for(Creature* creature : getBoardCreatures())
+			if(creature->isOnBoard())
+				creature->applyEffectToSelf(effect);
 	}
-	else //other effects just get applied to each creature individually
-		for(auto& card : _cardBoard)
-			card->applyEffectToSelf(effect);
 }
 
 /*------------------------------ GETTERS */
@@ -529,20 +878,33 @@ const Card* Player::getLastCaster() const
 	return _lastCasterCard;
 }
 
-sf::TcpSocket& Player::getSocket()
+const Creature* Player::getLastCasterCreature() const
+{
+	if(_lastCasterCard == nullptr or not _lastCasterCard->isCreature())
+		return nullptr;
+	return static_cast<const Creature*>(_lastCasterCard);
+}
+
+Constraints::CasterVersion& Player::getCasterVersion()
 {
-	return _socketToClient;
+	return _game.getCasterVersion();
 }
 
 void Player::printVerbose(const std::string& message)
 {
-	_gameThread.printVerbose("player " + std::to_string(getId()) + " - "+ message);
+	_game.printVerbose("player " + std::to_string(getId()) + " - "+ message);
+}
+
+void Player::printVerbose(const char* method, const EffectArgs& effect)
+{
+	if(_game.isVerbose())
+		printVerbose(method + effect.toString());
 }
 
 /*------------------------------ EFFECTS (PRIVATE) */
 void Player::setConstraint(EffectArgs effect)
 {
-	printVerbose("Player::setConstraint(" + effect.toString() + ")");
+	printVerbose("Player::setConstraint", effect);
 	int constraintId; //constraint to set
 	int value; //value to give to it
 	int turns; //for how many turns
@@ -563,7 +925,7 @@ void Player::setConstraint(EffectArgs effect)
 	switch(casterOptions)
 	{
 		case IF_CASTER_ALIVE:
-			_constraints.setConstraint(constraintId, value, turns, dynamic_cast<const Creature*>(getLastCaster()));
+			_constraints.setConstraint(constraintId, value, turns, getLastCasterCreature());
 			break;
 
 		default:
@@ -574,7 +936,7 @@ void Player::setConstraint(EffectArgs effect)
 
 void Player::pickDeckCards(EffectArgs effect)
 {
-	printVerbose("Player::pickDeckCards(" + effect.toString() + ")");
+	printVerbose("Player::pickDeckCards", effect);
 	int amount;//amount of cards
 	try //check the input
 	{
@@ -589,7 +951,7 @@ void Player::pickDeckCards(EffectArgs effect)
 
 void Player::loseHandCards(EffectArgs effect)
 {
-	printVerbose("Player::loseHandCards(" + effect.toString() + ")");
+	printVerbose("Player::loseHandCards", effect);
 	try  //check the input
 	{
 		for(int amount{effect.peekArg()}; not _cardHand.empty() and amount > 0; amount--)
@@ -603,7 +965,7 @@ void Player::loseHandCards(EffectArgs effect)
 
 void Player::reviveGraveyardCard(EffectArgs effect)
 {
-	printVerbose("Player::reviveGraveyardCard()");
+	printVerbose("Player::reviveGraveyardCard", effect);
 	int binIndex;  //what card to revive
 	try  //check the input
 	{
@@ -617,52 +979,30 @@ void Player::reviveGraveyardCard(EffectArgs effect)
 	cardGraveyardToHand(binIndex);
 }
 
-void Player::stealHandCard(EffectArgs /* effect */)
+void Player::stealHandCard(EffectArgs effect)
 {
-	printVerbose("Player::stealHandCard()");
+	printVerbose("Player::stealHandCard", effect);
 	//no arguments
 	cardAddToHand(_opponent.cardRemoveFromHand());
 }
 
-/// \network sends to user one of the following:
-///	 + FAILURE if opponent has no card in his hand
-///	 + ACKNOWLEDGE if card has been swapped
-void Player::exchgHandCard(EffectArgs /* effect */)
+/// Nothing is sent, the status of the card use is sent once all its
+/// effects are applied (see useCard)
+void Player::exchgHandCard(EffectArgs effect)
 {
-	printVerbose("Player::exchgHandCard()");
-	int myCardIndex; //card to exchange
-	sf::Packet packet;
-	std::unique_ptr<Card> myCard;
-
-	try //check the input
-	{
-		myCardIndex = getRandomIndex(_cardHand);
-		myCard = std::move(_cardHand.at(myCardIndex));
-	}
-	catch(std::out_of_range&)
-	{
-		throw std::runtime_error("exchgCard error with cards arguments");
-	}
-
-	std::unique_ptr<Card> hisCard(_opponent.cardExchangeFromHand(std::move(myCard)));
-
-	if(hisCard == nullptr)
-	{
-		packet << TransferType::FAILURE;
-		// Remove the card that was given to the opponent from the hand vector
-		_cardHand.erase(_cardHand.begin() + myCardIndex);
-	}
-	else
-	{
-		cardExchangeFromHand(std::move(hisCard), myCardIndex);
-		packet << TransferType::ACKNOWLEDGE;
-	}
-	_socketToClient.send(packet); //Shouldn't this be called before cardExchangeFromHand ?
+	printVerbose("Player::exchgHandCard", effect);
+	//no arguments
+	// there is nothing to exchange
+	if(_cardHand.empty() or _opponent._cardHand.empty())
+		return;
+	const int myCardIndex{getRandomIndex(_cardHand)};
+	Card* hisCard{_opponent.cardExchangeFromHand(_cardHand[myCardIndex])};
+	cardExchangeFromHand(hisCard, myCardIndex);
 }
 
 void Player::resetEnergy(EffectArgs effect)
 {
-	printVerbose("Player::resetEnergy(" + effect.toString() + ")");
+	printVerbose("Player::resetEnergy", effect);
 	try //check the input
 	{
 		_energyInit += effect.getArg();
@@ -681,7 +1021,7 @@ void Player::resetEnergy(EffectArgs effect)
 
 void Player::changeEnergy(EffectArgs effect)
 {
-	printVerbose("Player::changeEnergy(" + effect.toString() + ")");
+	printVerbose("Player::changeEnergy", effect);
 	try //check the input
 	{
 		_energy += effect.getArg();
@@ -699,7 +1039,7 @@ void Player::changeEnergy(EffectArgs effect)
 
 void Player::changeHealth(EffectArgs effect)
 {
-	printVerbose("Player::changeHealth(" + effect.toString() + ")");
+	printVerbose("Player::changeHealth", effect);
 
 	int points;
 	try //check the input
@@ -732,21 +1072,19 @@ void Player::changeHealth(EffectArgs effect)
 
 /*--------------------------- PRIVATE */
 
-bool Player::exploitCardEffects(Card* usedCard)
+bool Player::exploitCardEffects(Card* usedCard, const std::vector<int>& selectedIndices)
 {
-	// Maybe I should have use multiple inheritance to avoid this
-	const std::vector<EffectParamsCollection>& effects(
-		usedCard->isSpell()
-			? static_cast<Spell *>(usedCard)->getEffects()
-			: static_cast<Creature *>(usedCard)->getEffects()
-	);
-	sf::Packet nbOfEffectsPacket;
-	nbOfEffectsPacket << TransferType::GAME_SEND_NB_OF_EFFECTS << static_cast<sf::Uint32>(effects.size());
-	_socketToClient.send(nbOfEffectsPacket);
-
-	for(const auto& effect: effects) //for each effect of the card
-		if(not applyEffect(usedCard, effect)) //apply it
+	// each effect whose subject is chosen takes the next selected index
+	auto selectedIndex = selectedIndices.begin();
+	for(const CardEffect& effect: getCardEffects(usedCard)) //for each effect of the card
+	{
+		int index{-1};
+		if((effect.subject == CREATURE_SELF_INDX or effect.subject == CREATURE_OPPO_INDX)
+		   and selectedIndex != selectedIndices.end())
+			index = *selectedIndex++;
+		if(not applyEffect(usedCard, effect, index)) //apply it
 			return false;
+	}
 	return true;
 }
 
@@ -772,7 +1110,7 @@ void Player::setTeamConstraint(EffectArgs effect)
 	switch(casterOptions)
 	{
 		case IF_CASTER_ALIVE:
-			_teamConstraints.setConstraint(constraintId, value, turns, dynamic_cast<const Creature*>(getLastCaster()));
+			_teamConstraints.setConstraint(constraintId, value, turns, getLastCasterCreature());
 			break;
 
 		default:
@@ -786,8 +1124,8 @@ void Player::cardDeckToHand(int amount)
 	while(not _cardDeck.empty() and amount > 0)
 	{
 		amount--;
-		_cardHand.push_back(std::move(_cardDeck.top()));
-		_cardDeck.pop();
+		_cardHand.push_back(_cardDeck.back());
+		_cardDeck.pop_back();
 	}
 	logHandState();
 	_opponent.logOpponentHandState();
@@ -798,8 +1136,8 @@ void Player::cardHandToBoard(int handIndex)
 {
 	assert(_cardHand.at(handIndex)->isCreature());
 	// Release the ownership of the hand, cast to a Creature pointer and give it to the board
-	_cardBoard.push_back(std::unique_ptr<Creature>(static_cast<Creature*>(_cardHand.at(handIndex).release())));
-	_cardBoard.back()->moveToBoard();
+	_cardBoard.push_back(static_cast<Creature*>(_cardHand.at(handIndex)));
+	_cardBoard.back()->moveToBoard(*this);
 	_cardHand.erase(_cardHand.begin() + handIndex);
 	logHandState();
 	_opponent.logOpponentHandState();
@@ -809,7 +1147,7 @@ void Player::cardHandToBoard(int handIndex)
 
 void Player::cardHandToGraveyard(int handIndex)
 {
-	_cardGraveyard.push_back(std::move(_cardHand.at(handIndex)));
+	_cardGraveyard.push_back(_cardHand.at(handIndex));
 	_cardHand.erase(_cardHand.begin() + handIndex);
 	logHandState();
 	_opponent.logOpponentHandState();
@@ -821,7 +1159,7 @@ void Player::cardBoardToGraveyard(int boardIndex)
 	assert(_cardBoard.at(boardIndex)->isOnBoard());
 	_cardBoard.at(boardIndex)->removeFromBoard();
 	// Release the ownership of the board, cast to a Card pointer and give it to the graveyard
-	_cardGraveyard.push_back(std::unique_ptr<Card>(static_cast<Card*>(_cardBoard.at(boardIndex).release())));
+	_cardGraveyard.push_back(_cardBoard.at(boardIndex));
 	_cardBoard.erase(_cardBoard.begin() + boardIndex);
 	logBoardState();
 	_opponent.logOpponentBoardState();
@@ -830,56 +1168,56 @@ void Player::cardBoardToGraveyard(int boardIndex)
 
 void Player::cardBoardToGraveyard(const Creature *card)
 {
-	const auto& lambdaCheck{[card](const auto& it){return it.get() == card;}};
-	const auto& cardIterator{std::find_if(_cardBoard.begin(), _cardBoard.end(), lambdaCheck)};
+	const auto& cardIterator{std::find(_cardBoard.begin(), _cardBoard.end(), card)};
 	cardBoardToGraveyard(static_cast<int>(cardIterator - _cardBoard.begin()));
 }
 
 void Player::cardGraveyardToHand(int binIndex)
 {
-	_cardHand.push_back(std::move(_cardGraveyard.at(binIndex)));
+	_cardHand.push_back(_cardGraveyard.at(binIndex));
 	_cardGraveyard.erase(_cardGraveyard.begin() + binIndex);
 	logGraveyardState();
 	logHandState();
 	_opponent.logOpponentHandState();
 }
 
-void Player::cardAddToHand(std::unique_ptr<Card> givenCard)
+void Player::cardAddToHand(Card* givenCard)
 {
 	if(givenCard != nullptr)
 	{
-		_cardHand.push_back(std::move(givenCard));
+		_cardHand.push_back(givenCard);
 		logHandState();
 		_opponent.logOpponentHandState();
 	}
 }
 
-std::unique_ptr<Card> Player::cardRemoveFromHand()
+Card* Player::cardRemoveFromHand()
 {
 	if(_cardHand.empty())
 		return nullptr;
 	int handIndex = getRandomIndex(_cardHand);
-	std::unique_ptr<Card> stolenCard(std::move(_cardHand[handIndex]));
+	Card* stolenCard(_cardHand[handIndex]);
 	_cardHand.erase(_cardHand.begin() + handIndex);
 	logHandState();
 	_opponent.logOpponentHandState();
-	return std::move(stolenCard);
+	return stolenCard;
 }
 
-std::unique_ptr<Card> Player::cardExchangeFromHand(std::unique_ptr<Card> givenCard)
+Card* Player::cardExchangeFromHand(Card* givenCard)
 {
 	int handIndex = getRandomIndex(_cardHand);
-	return std::move(cardExchangeFromHand(std::move(givenCard), handIndex));
+	return cardExchangeFromHand(givenCard, handIndex);
 }
 
-std::unique_ptr<Card> Player::cardExchangeFromHand(std::unique_ptr<Card> givenCard, int handIndex)
+Card* Player::cardExchangeFromHand(Card* givenCard, int handIndex)
 {
 	if(_cardHand.empty())
 		return nullptr;
-	std::swap(givenCard, _cardHand[handIndex]);
+	Card* takenCard{_cardHand[handIndex]};
+	_cardHand.set(handIndex, givenCard);
 	logHandState();
 	_opponent.logOpponentHandState();
-	return std::move(givenCard);
+	return takenCard;
 }
 
 
@@ -904,18 +1242,24 @@ void Player::logEverything()
 
 void Player::logCurrentEnergy()
 {
+	if(not _logBoardChanges)
+		return;
 	// cast to be sure that the right amount of bits is sent and received
 	_pendingBoardChanges << TransferType::GAME_PLAYER_ENERGY_UPDATED << static_cast<sf::Uint32>(_energy);
 }
 
 void Player::logCurrentHealth()
 {
+	if(not _logBoardChanges)
+		return;
 	// cast to be sure that the right amount of bits is sent and received
 	_pendingBoardChanges << TransferType::GAME_PLAYER_HEALTH_UPDATED << static_cast<sf::Uint32>(_health);
 }
 
 void Player::logOpponentHealth()
 {
+	if(not _logBoardChanges)
+		return;
 	try
 	{
 		_pendingBoardChanges << TransferType::GAME_OPPONENT_HEALTH_UPDATED << static_cast<sf::Uint32>(_opponent.getHealth());
@@ -928,6 +1272,8 @@ void Player::logOpponentHealth()
 
 void Player::logCurrentDeck()
 {
+	if(not _logBoardChanges)
+		return;
 	_pendingBoardChanges << TransferType::GAME_DECK_UPDATED << static_cast<sf::Uint32>(_cardDeck.size());
 }
 
@@ -938,6 +1284,8 @@ void Player::logHandState()
 
 void Player::logOpponentHandState()
 {
+	if(not _logBoardChanges)
+		return;
 	try
 	{
 		_pendingBoardChanges << TransferType::GAME_OPPONENT_HAND_UPDATED << static_cast<sf::Uint32>(_opponent.getHandSize());
@@ -964,30 +1312,37 @@ void Player::logGraveyardState()
 }
 
 // use a template to handle both Card and Creature pointers
-template <typename CardType>
-void Player::logIdsFromVector(TransferType type, const std::vector<std::unique_ptr<CardType>>& vect)
+template <typename Zone>
+void Player::logIdsFromVector(TransferType type, const Zone& vect)
 {
+	if(not _logBoardChanges)
+		return;
 	std::vector<sf::Uint32> CardIds(vect.size());
 	for(std::size_t i{0}; i < vect.size(); ++i)
-		CardIds[i] = vect[i]->getId();
+		CardIds[i] = vect.getTag(i).id;
 
 	_pendingBoardChanges << type << CardIds;
 }
 
-void Player::logCardDataFromVector(TransferType type, const std::vector<std::unique_ptr<Card>>& vect)
+template <typename Zone>
+void Player::logCardDataFromVector(TransferType type, const Zone& vect)
 {
+	if(not _logBoardChanges)
+		return;
 	std::vector<CardData> cards;
 	for(std::size_t i = 0U; i < vect.size(); ++i)
 	{
 		CardData data;
-		data.id = vect.at(i)->getId();
+		data.id = vect.getTag(i).id;
 		cards.push_back(data);
 	}
 	_pendingBoardChanges << type << cards;
 }
 
-void Player::logBoardCreatureDataFromVector(TransferType type, const std::vector<std::unique_ptr<Creature>>& vect)
+void Player::logBoardCreatureDataFromVector(TransferType type, const Board& vect)
 {
+	if(not _logBoardChanges)
+		return;
 	std::vector<BoardCreatureData> boardCreatures;
 	for(const auto& creature : vect)
 		boardCreatures.push_back(static_cast<BoardCreatureData>(*creature));
@@ -996,68 +1351,41 @@ void Player::logBoardCreatureDataFromVector(TransferType type, const std::vector
 }
 
 
-// TODO: handle the case where the user doesn't give and his turn finishes
-std::vector<int> Player::askUserToSelectCards(const std::vector<CardToSelect>& selection)
+bool Player::isAwaitingSelection() const
 {
-	sf::Packet packet;
-	packet << TransferType::ACKNOWLEDGE << selection;
-	_socketToClient.send(packet);
-	std::vector<sf::Uint32> indices;
-	// have the socket blocking because the answer is expected at this very moment
-	_socketToClient.setBlocking(true);
-	_socketToClient.receive(packet);
-	_socketToClient.setBlocking(false);
-	packet >> indices;
-	assert(indices.size() == selection.size());
-	// convert the sf::Uint32 received on the network by implementation-defined integers
-	std::vector<int> ret(selection.size());
-	for(std::size_t i{0U}; i < indices.size(); ++i)
-		ret[i] = static_cast<int>(indices[i]);
-	return ret;
+	return _cardUse.card != nullptr;
 }
 
-template <typename T>
-inline int Player::getRandomIndex(const std::vector<T>& vector)
+bool Player::needsSelection(const std::vector<CardToSelect>& selection) const
 {
-	if(vector.empty())
-		throw std::out_of_range("Cannot generate a random index for an empty vector.");
-	return _gameThread.getGenerator().next(static_cast<int>(vector.size()));
+	for(CardToSelect zone: selection)
+		if((zone == CardToSelect::SELF_BOARD and _cardBoard.empty())
+		   or (zone == CardToSelect::OPPO_BOARD and _opponent._cardBoard.empty())
+		   or (zone == CardToSelect::SELF_HAND and _cardHand.empty()))
+			return false;
+	return not selection.empty();
 }
 
-std::vector<int> Player::getRandomBoardIndexes(const std::vector<CardToSelect>& selection)
+void Player::receiveSelection(std::vector<int> selectedIndices)
 {
-	std::vector<int> indices(selection.size());
-	for(std::size_t i{0}; i < selection.size(); i++)
-	{
-		switch(selection.at(i))
-		{
-			case CardToSelect::SELF_BOARD:
-				indices[i] = getRandomIndex(_cardBoard);
-				break;
-
-			case CardToSelect::SELF_HAND:
-				indices[i] = getRandomIndex(_cardHand);
-				break;
-
-			case CardToSelect::OPPO_BOARD:
-				indices[i] = getRandomIndex(_opponent._cardBoard);
-				break;
-
-			/*case CardToSelect::OPPO_HAND:
-				indices[i] = getRandomIndex(_opponent._cardHand);
-				break;
+	Card* usedCard{_cardUse.card};
+	_cardUse.card = nullptr;
+	// a missing index makes its effect fail, an extra one is ignored
+	selectedIndices.resize(getCardEffects(usedCard).getSelection().size(), -1);
+	playCard(_cardUse.handIndex, usedCard, selectedIndices);
+}
 
-			case CardToSelect::SELF_GRAVEYARD:
-				indices[i] = getRandomIndex(_cardGraveyard);
-				break;*/
-		}
-	}
-	return indices;
+template <typename Zone>
+inline int Player::getRandomIndex(const Zone& zone)
+{
+	if(zone.empty())
+		throw std::out_of_range("Cannot generate a random index for an empty zone.");
+	return _game.getGenerator().next(static_cast<int>(zone.size()));
 }
 
 void Player::sendValueToClient(TransferType transferType)
 {
 	sf::Packet packet;
 	packet << transferType;
-	_socketToClient.send(packet);
+	_controller->send(packet);
 }
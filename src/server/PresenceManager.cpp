@@ -0,0 +1,73 @@
+// WizardPoker headers
+#include "server/PresenceManager.hpp"
+
+PresenceManager::PresenceManager():
+	_subscribers()
+{
+}
+
+std::vector<std::string> PresenceManager::connect(UserId id, const std::string& name, const FriendsList& friends)
+{
+	Subscriber& subscriber(_subscribers[id]);
+	subscriber.name = name;
+	subscriber.friends.clear();
+	for(const auto& friendUser: friends)
+		subscriber.friends.insert(friendUser.id);
+	return getOnlineFriends(id);
+}
+
+std::vector<std::string> PresenceManager::disconnect(UserId id)
+{
+	if(not isOnline(id))
+		return {};
+	// compute the list before erasing, the subscriber is needed for that
+	std::vector<std::string> toNotify{getOnlineFriends(id)};
+	_subscribers.erase(id);
+	return toNotify;
+}
+
+void PresenceManager::addFriendship(UserId first, UserId second)
+{
+	auto firstIt = _subscribers.find(first);
+	if(firstIt != _subscribers.end())
+		firstIt->second.friends.insert(second);
+	auto secondIt = _subscribers.find(second);
+	if(secondIt != _subscribers.end())
+		secondIt->second.friends.insert(first);
+}
+
+void PresenceManager::removeFriendship(UserId first, UserId second)
+{
+	auto firstIt = _subscribers.find(first);
+	if(firstIt != _subscribers.end())
+		firstIt->second.friends.erase(second);
+	auto secondIt = _subscribers.find(second);
+	if(secondIt != _subscribers.end())
+		secondIt->second.friends.erase(first);
+}
+
+bool PresenceManager::isOnline(UserId id) const
+{
+	return _subscribers.find(id) != _subscribers.end();
+}
+
+bool PresenceManager::areFriend(UserId id, UserId friendId) const
+{
+	auto it = _subscribers.find(id);
+	return it != _subscribers.end() and it->second.friends.count(friendId) > 0;
+}
+
+std::vector<std::string> PresenceManager::getOnlineFriends(UserId id) const
+{
+	std::vector<std::string> onlineFriends;
+	auto it = _subscribers.find(id);
+	if(it == _subscribers.end())
+		return onlineFriends;
+	for(const UserId friendId: it->second.friends)
+	{
+		auto friendIt = _subscribers.find(friendId);
+		if(friendIt != _subscribers.end())
+			onlineFriends.push_back(friendIt->second.name);
+	}
+	return onlineFriends;
+}
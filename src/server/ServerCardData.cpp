@@ -1,14 +1,161 @@
 #include "server/ServerCardData.hpp"
+// std-C++ headers
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+constexpr std::size_t CardEffect::maxArgsCount;
+
+/// Number of arguments read by each method of the players
+static constexpr std::array<std::size_t, P_EFFECTS_COUNT> playerEffectsArgsCount{{
+	4,  // PE_SET_CONSTRAINT
+	1,  // PE_PICK_DECK_CARDS
+	1,  // PE_LOSE_HAND_CARDS
+	1,  // PE_REVIVE_BIN_CARD
+	0,  // PE_STEAL_HAND_CARD
+	0,  // PE_EXCHG_HAND_CARD
+	1,  // PE_SET_ENERGY
+	1,  // PE_CHANGE_ENERGY
+	1   // PE_CHANGE_HEALTH
+}};
+
+/// Number of arguments read by each method of the creatures
+static constexpr std::array<std::size_t, C_EFFECTS_COUNT> creatureEffectsArgsCount{{
+	4,  // CE_SET_CONSTRAINT
+	0,  // CE_RESET_ATTACK
+	0,  // CE_RESET_HEALTH
+	0,  // CE_RESET_SHIELD
+	1,  // CE_CHANGE_ATTACK
+	1,  // CE_CHANGE_HEALTH
+	1   // CE_CHANGE_SHIELD
+}};
+
+/// Compiles an effect of a card template
+/// \param params The parameters of the effect: its subject, its method then its arguments
+/// \param isCreature True if the card is a creature, false for a spell
+/// \return The compiled effect
+/// \throw std::runtime_error if the effect is not valid, with the reason
+static CardEffect compileEffect(const EffectParamsCollection& params, bool isCreature)
+{
+	if(params.size() < 2)
+		throw std::runtime_error("no subject or no method");
+	if(params.size() - 2 > CardEffect::maxArgsCount)
+		throw std::runtime_error("too many arguments");
+	CardEffect effect;
+	effect.subject = static_cast<EffectSubject>(params[0]);
+	effect.method = params[1];
+	effect.args.fill(0);
+	std::copy(params.begin() + 2, params.end(), effect.args.begin());
+	effect.argsCount = static_cast<std::uint8_t>(params.size() - 2);
+
+	bool isPlayerSubject;
+	switch(effect.subject)
+	{
+		case PLAYER_SELF:
+		case PLAYER_OPPO:
+			isPlayerSubject = true;
+			break;
+
+		case CREATURE_SELF_THIS:
+			if(not isCreature)
+				throw std::runtime_error("a spell can not apply an effect to itself");
+			isPlayerSubject = false;
+			break;
+
+		case CREATURE_SELF_INDX:
+		case CREATURE_SELF_RAND:
+		case CREATURE_SELF_TEAM:
+		case CREATURE_OPPO_INDX:
+		case CREATURE_OPPO_RAND:
+		case CREATURE_OPPO_TEAM:
+			isPlayerSubject = false;
+			break;
+
+		default:
+			throw std::runtime_error("unknown subject " + std::to_string(params[0]));
+	}
+
+	const int methodsCount{isPlayerSubject ? static_cast<int>(P_EFFECTS_COUNT) : static_cast<int>(C_EFFECTS_COUNT)};
+	if(effect.method < 0 or effect.method >= methodsCount)
+		throw std::runtime_error("unknown method " + std::to_string(effect.method));
+	const std::size_t argsCount{isPlayerSubject
+			? playerEffectsArgsCount[static_cast<std::size_t>(effect.method)]
+			: creatureEffectsArgsCount[static_cast<std::size_t>(effect.method)]};
+	if(effect.argsCount < argsCount)
+		throw std::runtime_error("missing arguments");
+
+	// PE_SET_CONSTRAINT and CE_SET_CONSTRAINT: constraint, value, turns, condition
+	if(effect.method == (isPlayerSubject ? static_cast<int>(PE_SET_CONSTRAINT) : static_cast<int>(CE_SET_CONSTRAINT)))
+	{
+		const int constraintsCount{isPlayerSubject ? static_cast<int>(P_CONSTRAINTS_COUNT) : static_cast<int>(C_CONSTRAINTS_COUNT)};
+		if(effect.args[0] < 0 or effect.args[0] >= constraintsCount)
+			throw std::runtime_error("unknown constraint " + std::to_string(effect.args[0]));
+		if(effect.args[2] < 0)
+			throw std::runtime_error("negative number of turns");
+		if(effect.args[3] != NO_CASTER_NEEDED and effect.args[3] != IF_CASTER_ALIVE)
+			throw std::runtime_error("unknown constraint condition " + std::to_string(effect.args[3]));
+	}
+	return effect;
+}
+
+// CardEffect
+EffectArgs CardEffect::getArgs() const
+{
+	return EffectArgs(args.data(), argsCount);
+}
+
+// CardEffects
+CardEffects::CardEffects(CardId card, bool isCreature, const std::vector<EffectParamsCollection>& effects):
+	_effects(),
+	_selection()
+{
+	_effects.reserve(effects.size());
+	for(std::size_t i{0}; i < effects.size(); ++i)
+	{
+		try
+		{
+			_effects.push_back(compileEffect(effects[i], isCreature));
+		}
+		catch(const std::runtime_error& e)
+		{
+			throw std::runtime_error("Card " + std::to_string(card) + ", effect " + std::to_string(i) + ": " + e.what());
+		}
+		if(_effects.back().subject == CREATURE_SELF_INDX)
+			_selection.push_back(CardToSelect::SELF_BOARD);
+		else if(_effects.back().subject == CREATURE_OPPO_INDX)
+			_selection.push_back(CardToSelect::OPPO_BOARD);
+	}
+}
+
+std::size_t CardEffects::size() const
+{
+	return _effects.size();
+}
+
+const std::vector<CardToSelect>& CardEffects::getSelection() const
+{
+	return _selection;
+}
+
+std::vector<CardEffect>::const_iterator CardEffects::begin() const
+{
+	return _effects.begin();
+}
+
+std::vector<CardEffect>::const_iterator CardEffects::end() const
+{
+	return _effects.end();
+}
 
 // ServerCreatureData
 ServerCreatureData::ServerCreatureData(CardId id, int cost, const std::vector<EffectParamsCollection>& effects,
                            int attack, int health, int shield, int shieldType) :
 	CommonCreatureData(id, cost, attack, health, shield, shieldType),
-	_effects(effects)
+	_effects(id, true, effects)
 {
 }
 
-const std::vector<EffectParamsCollection>& ServerCreatureData::getEffects() const
+const CardEffects& ServerCreatureData::getEffects() const
 {
 	return _effects;
 }
@@ -16,11 +163,11 @@ const std::vector<EffectParamsCollection>& ServerCreatureData::getEffects() cons
 // SpellCard
 ServerSpellData::ServerSpellData(CardId id, int cost, const std::vector<EffectParamsCollection>& effects) :
 	CommonSpellData(id, cost),
-	_effects(effects)
+	_effects(id, false, effects)
 {
 }
 
-const std::vector<EffectParamsCollection>& ServerSpellData::getEffects() const
+const CardEffects& ServerSpellData::getEffects() const
 {
 	return _effects;
 }
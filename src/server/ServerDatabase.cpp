@@ -5,6 +5,7 @@
 #include "common/Card.hpp"
 #include "server/Spell.hpp"
 #include "server/Creature.hpp"
+#include "server/CardArena.hpp"
 // std-C++
 #include <cassert>
 #include <cstring>
@@ -27,29 +28,37 @@ ServerDatabase::ServerDatabase(const std::string& filename) :
 	createCreatureData();
 }
 
-Card* ServerDatabase::getCard(CardId card, Player& owner)
+Card* ServerDatabase::getCard(CardId card, Player& owner, CardArena& arena)
 {
-	if(_cardData.count(card) == 0)
+	// the cards are created each time a game is loaded, the data is looked up once
+	const auto cardData = _cardData.find(card);
+	if(cardData == _cardData.end())
 		throw std::runtime_error("The requested card (" + std::to_string(card) + ") does not exist.");
 
 	// Do not use ?: operator (http://en.cppreference.com/w/cpp/language/operator_other#Conditional_operator)
-	if(_cardData.at(card)->isCreature())
-		return new Creature(*static_cast<const ServerCreatureData *>(_cardData.at(card).get()), owner);
+	if(cardData->second->isCreature())
+		return arena.createCreature(*static_cast<const ServerCreatureData *>(cardData->second.get()), owner);
 	else
-		return new Spell(*static_cast<const ServerSpellData *>(_cardData.at(card).get()));
+		return arena.createSpell(*static_cast<const ServerSpellData *>(cardData->second.get()));
+}
+
+const CommonCardData* ServerDatabase::getCardData(CardId card)
+{
+	const auto cardData = _cardData.find(card);
+	return cardData == _cardData.end() ? nullptr : cardData->second.get();
 }
 
 CardId ServerDatabase::countCards()
 {
 	sqlite3_reset(_countCardsStmt);
-	assert(sqliteThrowExcept(sqlite3_step(_countCardsStmt)) == SQLITE_ROW);
+	assert(sqliteThrowExcept(step(_countCardsStmt)) == SQLITE_ROW);
 	return sqlite3_column_int(_countCardsStmt, 0);
 }
 
 CardId ServerDatabase::getRandomCardId()
 {
 	sqlite3_reset(_getRandomCardIdStmt);
-	assert(sqliteThrowExcept(sqlite3_step(_getRandomCardIdStmt)) == SQLITE_ROW);
+	assert(sqliteThrowExcept(step(_getRandomCardIdStmt)) == SQLITE_ROW);
 	return sqlite3_column_int(_getRandomCardIdStmt, 0);
 }
 
@@ -59,7 +68,7 @@ UserId ServerDatabase::getUserId(const std::string& login)
 	sqlite3_reset(_UserIdStmt);
 	sqliteThrowExcept(sqlite3_bind_text(_UserIdStmt, 1, login.c_str(), AUTO_QUERY_LENGTH, SQLITE_TRANSIENT));
 
-	if(sqliteThrowExcept(sqlite3_step(_UserIdStmt)) == SQLITE_DONE)
+	if(sqliteThrowExcept(step(_UserIdStmt)) == SQLITE_DONE)
 		throw std::runtime_error("ERROR login not found");
 
 	return sqlite3_column_int64(_UserIdStmt, 0);
@@ -71,7 +80,7 @@ std::string ServerDatabase::getLogin(UserId id)
 	sqlite3_reset(_loginStmt);
 	sqliteThrowExcept(sqlite3_bind_int64(_loginStmt, 1, id));
 
-	if(sqliteThrowExcept(sqlite3_step(_loginStmt)) == SQLITE_DONE)
+	if(sqliteThrowExcept(step(_loginStmt)) == SQLITE_DONE)
 		throw std::runtime_error("ERROR UserId not found");
 
 	return reinterpret_cast<const char *>(sqlite3_column_text(_loginStmt, 0));
@@ -85,7 +94,7 @@ std::vector<Deck> ServerDatabase::getDecks(UserId id)
 
 	std::vector<Deck> decks;
 
-	while(sqliteThrowExcept(sqlite3_step(_decksStmt)) == SQLITE_ROW)
+	while(sqliteThrowExcept(step(_decksStmt)) == SQLITE_ROW)
 	{
 		decks.emplace_back(Deck(reinterpret_cast<const char *>(sqlite3_column_text(_decksStmt, 0))));
 
@@ -104,7 +113,7 @@ CardsCollection ServerDatabase::getCardsCollection(UserId id)
 
 	CardsCollection cards;
 
-	while(sqliteThrowExcept(sqlite3_step(_cardsCollectionStmt)) == SQLITE_ROW)
+	while(sqliteThrowExcept(step(_cardsCollectionStmt)) == SQLITE_ROW)
 	{
 		cards.addCard(sqlite3_column_int64(_cardsCollectionStmt, 0));
 	}
@@ -119,7 +128,7 @@ void ServerDatabase::addCard(UserId id, CardId card)
 	sqliteThrowExcept(sqlite3_bind_int64(_newCardStmt, 1, card));
 	sqliteThrowExcept(sqlite3_bind_int64(_newCardStmt, 2, id));
 
-	assert(sqliteThrowExcept(sqlite3_step(_newCardStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_newCardStmt)) == SQLITE_DONE);
 }
 
 void ServerDatabase::addFriend(UserId UserId1, UserId UserId2)
@@ -129,7 +138,7 @@ void ServerDatabase::addFriend(UserId UserId1, UserId UserId2)
 	sqliteThrowExcept(sqlite3_bind_int64(_addFriendStmt, 1, UserId1));
 	sqliteThrowExcept(sqlite3_bind_int64(_addFriendStmt, 2, UserId2));
 
-	sqliteThrowExcept(sqlite3_step(_addFriendStmt));
+	sqliteThrowExcept(step(_addFriendStmt));
 }
 
 void ServerDatabase::removeFriend(UserId UserId1, UserId UserId2)
@@ -139,8 +148,8 @@ void ServerDatabase::removeFriend(UserId UserId1, UserId UserId2)
 	sqliteThrowExcept(sqlite3_bind_int64(_removeFriendStmt, 1, UserId1 < UserId2 ? UserId1 : UserId2));
 	sqliteThrowExcept(sqlite3_bind_int64(_removeFriendStmt, 2, UserId1 < UserId2 ? UserId2 : UserId1));
 
-	sqliteThrowExcept(sqlite3_step(_removeFriendStmt));
-	assert(sqlite3_step(_removeFriendStmt) == SQLITE_DONE);
+	sqliteThrowExcept(step(_removeFriendStmt));
+	assert(step(_removeFriendStmt) == SQLITE_DONE);
 }
 
 bool ServerDatabase::areFriend(UserId UserId1, UserId UserId2)
@@ -150,7 +159,7 @@ bool ServerDatabase::areFriend(UserId UserId1, UserId UserId2)
 	sqliteThrowExcept(sqlite3_bind_int64(_areFriendStmt, 1, UserId1));
 	sqliteThrowExcept(sqlite3_bind_int64(_areFriendStmt, 2, UserId2));
 
-	return sqliteThrowExcept(sqlite3_step(_areFriendStmt)) == SQLITE_ROW;
+	return sqliteThrowExcept(step(_areFriendStmt)) == SQLITE_ROW;
 }
 
 void ServerDatabase::addFriendshipRequest(UserId from, UserId to)
@@ -160,7 +169,7 @@ void ServerDatabase::addFriendshipRequest(UserId from, UserId to)
 	sqliteThrowExcept(sqlite3_bind_int64(_addFriendshipRequestStmt, 1, from));
 	sqliteThrowExcept(sqlite3_bind_int64(_addFriendshipRequestStmt, 2, to));
 
-	assert(sqliteThrowExcept(sqlite3_step(_addFriendshipRequestStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_addFriendshipRequestStmt)) == SQLITE_DONE);
 }
 
 void ServerDatabase::removeFriendshipRequest(UserId from, UserId to)
@@ -170,7 +179,7 @@ void ServerDatabase::removeFriendshipRequest(UserId from, UserId to)
 	sqliteThrowExcept(sqlite3_bind_int64(_removeFriendshipRequestStmt, 1, from));
 	sqliteThrowExcept(sqlite3_bind_int64(_removeFriendshipRequestStmt, 2, to));
 
-	assert(sqliteThrowExcept(sqlite3_step(_removeFriendshipRequestStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_removeFriendshipRequestStmt)) == SQLITE_DONE);
 }
 
 bool ServerDatabase::isFriendshipRequestSent(UserId from, UserId to)
@@ -180,7 +189,7 @@ bool ServerDatabase::isFriendshipRequestSent(UserId from, UserId to)
 	sqliteThrowExcept(sqlite3_bind_int64(_isFriendshipRequestSentStmt, 1, from));
 	sqliteThrowExcept(sqlite3_bind_int64(_isFriendshipRequestSentStmt, 2, to));
 
-	return sqliteThrowExcept(sqlite3_step(_isFriendshipRequestSentStmt)) == SQLITE_ROW;
+	return sqliteThrowExcept(step(_isFriendshipRequestSentStmt)) == SQLITE_ROW;
 }
 
 Deck ServerDatabase::getDeckByName(UserId id, const std::string& deckName)
@@ -209,7 +218,7 @@ void ServerDatabase::createDeck(UserId id, const Deck& deck)
 		sqliteThrowExcept(sqlite3_bind_int64(_createDeckStmt, card + 3, deck.getCard(card)));
 	}
 
-	assert(sqliteThrowExcept(sqlite3_step(_createDeckStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_createDeckStmt)) == SQLITE_DONE);
 }
 
 std::vector<CardId> ServerDatabase::getFirstCardIds(unsigned count)
@@ -219,7 +228,7 @@ std::vector<CardId> ServerDatabase::getFirstCardIds(unsigned count)
 
 	std::vector<CardId> CardIds;
 
-	while(sqliteThrowExcept(sqlite3_step(_getFirstCardIdsStmt)) == SQLITE_ROW)
+	while(sqliteThrowExcept(step(_getFirstCardIdsStmt)) == SQLITE_ROW)
 	{
 		CardIds.emplace_back(sqlite3_column_int64(_getFirstCardIdsStmt, 0));
 	}
@@ -234,7 +243,7 @@ void ServerDatabase::deleteDeckByName(UserId id, const std::string& deckName)
 	sqliteThrowExcept(sqlite3_bind_int64(_deleteDeckByNameStmt, 1, id));
 	sqliteThrowExcept(sqlite3_bind_text(_deleteDeckByNameStmt, 2, deckName.c_str(), AUTO_QUERY_LENGTH, SQLITE_TRANSIENT));
 
-	assert(sqliteThrowExcept(sqlite3_step(_deleteDeckByNameStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_deleteDeckByNameStmt)) == SQLITE_DONE);
 }
 
 void ServerDatabase::editDeck(UserId id, const Deck& deck)
@@ -248,7 +257,7 @@ void ServerDatabase::editDeck(UserId id, const Deck& deck)
 
 	sqliteThrowExcept(sqlite3_bind_int64(_editDeckByNameStmt, 22, id));
 
-	assert(sqliteThrowExcept(sqlite3_step(_editDeckByNameStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_editDeckByNameStmt)) == SQLITE_DONE);
 }
 
 bool ServerDatabase::areIdentifiersValid(const std::string& login, const std::string& password)
@@ -260,7 +269,7 @@ bool ServerDatabase::areIdentifiersValid(const std::string& login, const std::st
 	sqliteThrowExcept(sqlite3_bind_blob(_areIdentifiersValidStmt, 2, password.c_str(),
 	                                    static_cast<int>(std::strlen(password.c_str())), SQLITE_TRANSIENT));
 
-	return sqliteThrowExcept(sqlite3_step(_areIdentifiersValidStmt)) == SQLITE_ROW;
+	return sqliteThrowExcept(step(_areIdentifiersValidStmt)) == SQLITE_ROW;
 }
 
 bool ServerDatabase::isRegistered(const std::string& login)
@@ -269,7 +278,7 @@ bool ServerDatabase::isRegistered(const std::string& login)
 	sqlite3_reset(_UserIdStmt);
 	sqliteThrowExcept(sqlite3_bind_text(_UserIdStmt, 1, login.c_str(), AUTO_QUERY_LENGTH, SQLITE_TRANSIENT));
 
-	return sqliteThrowExcept(sqlite3_step(_UserIdStmt)) == SQLITE_ROW;
+	return sqliteThrowExcept(step(_UserIdStmt)) == SQLITE_ROW;
 }
 
 void ServerDatabase::registerUser(const std::string& login, const std::string& password)
@@ -280,7 +289,7 @@ void ServerDatabase::registerUser(const std::string& login, const std::string& p
 	sqliteThrowExcept(sqlite3_bind_blob(_registerUserStmt, 2, password.c_str(),
 	                                    static_cast<int>(std::strlen(password.c_str())), SQLITE_TRANSIENT));
 
-	assert(sqliteThrowExcept(sqlite3_step(_registerUserStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_registerUserStmt)) == SQLITE_DONE);
 }
 
 FriendsList ServerDatabase::getAnyFriendsList(UserId user, sqlite3_stmt * stmt)
@@ -291,7 +300,7 @@ FriendsList ServerDatabase::getAnyFriendsList(UserId user, sqlite3_stmt * stmt)
 
 	FriendsList friends;
 
-	while(sqliteThrowExcept(sqlite3_step(stmt)) == SQLITE_ROW)
+	while(sqliteThrowExcept(step(stmt)) == SQLITE_ROW)
 	{
 		friends.emplace_back(Friend {sqlite3_column_int64(stmt, 0), // id
 		                             reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)) // name
@@ -306,7 +315,7 @@ void ServerDatabase::createSpellData()
 	std::unique_lock<std::mutex> lock {_dbAccess};
 	sqlite3_reset(_getSpellCardsStmt);
 
-	while(sqliteThrowExcept(sqlite3_step(_getSpellCardsStmt)) == SQLITE_ROW)
+	while(sqliteThrowExcept(step(_getSpellCardsStmt)) == SQLITE_ROW)
 	{
 		CardId id(sqlite3_column_int64(_getSpellCardsStmt, 0));
 
@@ -330,7 +339,7 @@ void ServerDatabase::createCreatureData()
 	std::unique_lock<std::mutex> lock {_dbAccess};
 	sqlite3_reset(_getCreatureCardsStmt);
 
-	while(sqliteThrowExcept(sqlite3_step(_getCreatureCardsStmt)) == SQLITE_ROW)
+	while(sqliteThrowExcept(step(_getCreatureCardsStmt)) == SQLITE_ROW)
 	{
 		CardId id(sqlite3_column_int64(_getCreatureCardsStmt, 0));
 
@@ -360,18 +369,15 @@ std::vector<EffectParamsCollection> ServerDatabase::createCardEffects(CardId id)
 
 	std::vector<EffectParamsCollection> effects;
 
-	while(sqliteThrowExcept(sqlite3_step(_getCardEffectsStmt)) == SQLITE_ROW)
+	while(sqliteThrowExcept(step(_getCardEffectsStmt)) == SQLITE_ROW)
 	{
-		effects.push_back(EffectParamsCollection
-		{
-			sqlite3_column_int(_getCardEffectsStmt, 0),
-			sqlite3_column_int(_getCardEffectsStmt, 1),
-			sqlite3_column_int(_getCardEffectsStmt, 2),
-			sqlite3_column_int(_getCardEffectsStmt, 3),
-			sqlite3_column_int(_getCardEffectsStmt, 4),
-			sqlite3_column_int(_getCardEffectsStmt, 5),
-			sqlite3_column_int(_getCardEffectsStmt, 6),
-		});
+		// the unused parameters of an effect are NULL, they are not
+		// arguments (a missing argument must be detected, see CardEffects)
+		EffectParamsCollection params;
+		const int columnsCount{sqlite3_column_count(_getCardEffectsStmt)};
+		for(int column{0}; column < columnsCount and sqlite3_column_type(_getCardEffectsStmt, column) != SQLITE_NULL; ++column)
+			params.push_back(sqlite3_column_int(_getCardEffectsStmt, column));
+		effects.push_back(std::move(params));
 	}
 
 	return effects;
@@ -380,7 +386,7 @@ std::vector<EffectParamsCollection> ServerDatabase::createCardEffects(CardId id)
 unsigned ServerDatabase::countAccounts()
 {
 	sqlite3_reset(_countAccountsStmt);
-	assert(sqliteThrowExcept(sqlite3_step(_countAccountsStmt)) == SQLITE_ROW);
+	assert(sqliteThrowExcept(step(_countAccountsStmt)) == SQLITE_ROW);
 	return sqlite3_column_int(_countAccountsStmt, 0);
 }
 
@@ -395,7 +401,7 @@ AchievementList ServerDatabase::newAchievements(const PostGameData& postGame, Us
 	sqlite3_reset(_updateLastDayPlayedStmt);
 	sqliteThrowExcept(sqlite3_bind_int64(_updateLastDayPlayedStmt, 1, user));
 
-	assert(sqliteThrowExcept(sqlite3_step(_updateLastDayPlayedStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_updateLastDayPlayedStmt)) == SQLITE_DONE);
 
 	// unlock other achievements (unlock a card is a special achievement)
 	return _achievementManager.newAchievements(postGame, user);
@@ -413,7 +419,7 @@ Ladder ServerDatabase::getLadder()
 
 	Ladder ladder(countAccounts());
 
-	for(size_t i = 0; i < ladder.size() && sqliteThrowExcept(sqlite3_step(_ladderStmt)) == SQLITE_ROW; ++i)
+	for(size_t i = 0; i < ladder.size() && sqliteThrowExcept(step(_ladderStmt)) == SQLITE_ROW; ++i)
 	{
 		ladder.at(i).name = reinterpret_cast<const char *>(sqlite3_column_text(_ladderStmt, 0));
 		ladder.at(i).victories = sqlite3_column_int(_ladderStmt, 1);
@@ -427,7 +433,7 @@ int ServerDatabase::getRequired(AchievementId achievement)
 	sqlite3_reset(_getRequiredStmt);
 	sqliteThrowExcept(sqlite3_bind_int64(_getRequiredStmt, 1, achievement));
 
-	assert(sqliteThrowExcept(sqlite3_step(_getRequiredStmt)) == SQLITE_ROW);
+	assert(sqliteThrowExcept(step(_getRequiredStmt)) == SQLITE_ROW);
 
 	return sqlite3_column_int(_getRequiredStmt, 0);
 }
@@ -438,7 +444,7 @@ bool ServerDatabase::wasNotified(UserId user, AchievementId achievement)
 	sqliteThrowExcept(sqlite3_bind_int64(_wasNotifiedStmt, 1, user));
 	sqliteThrowExcept(sqlite3_bind_int64(_wasNotifiedStmt, 2, achievement));
 
-	return sqliteThrowExcept(sqlite3_step(_wasNotifiedStmt)) == SQLITE_ROW;
+	return sqliteThrowExcept(step(_wasNotifiedStmt)) == SQLITE_ROW;
 }
 
 void ServerDatabase::setNotified(UserId user, AchievementId achievement)
@@ -447,7 +453,7 @@ void ServerDatabase::setNotified(UserId user, AchievementId achievement)
 	sqliteThrowExcept(sqlite3_bind_int64(_setNotifiedStmt, 1, user));
 	sqliteThrowExcept(sqlite3_bind_int64(_setNotifiedStmt, 2, achievement));
 
-	assert(sqliteThrowExcept(sqlite3_step(_setNotifiedStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_setNotifiedStmt)) == SQLITE_DONE);
 }
 
 int ServerDatabase::getTimeSpent(UserId user)
@@ -481,7 +487,7 @@ void ServerDatabase::addVictoriesInTheCurrentRow(UserId user, int victories)
 	sqliteThrowExcept(sqlite3_bind_int(_addVictoriesInTheCurrentRowStmt, 1, victories));
 	sqliteThrowExcept(sqlite3_bind_int64(_addVictoriesInTheCurrentRowStmt, 2, user));
 
-	assert(sqliteThrowExcept(sqlite3_step(_addVictoriesInTheCurrentRowStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_addVictoriesInTheCurrentRowStmt)) == SQLITE_DONE);
 }
 
 int ServerDatabase::getWithInDaClub(UserId user)
@@ -569,7 +575,7 @@ void ServerDatabase::addStartsInTheCurrentRow(UserId user, int starts)
 	sqliteThrowExcept(sqlite3_bind_int(_addStartsInTheCurrentRowStmt, 1, starts));
 	sqliteThrowExcept(sqlite3_bind_int64(_addStartsInTheCurrentRowStmt, 2, user));
 
-	assert(sqliteThrowExcept(sqlite3_step(_addStartsInTheCurrentRowStmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(_addStartsInTheCurrentRowStmt)) == SQLITE_DONE);
 }
 
 int ServerDatabase::getDaysInARow(UserId user)
@@ -605,7 +611,7 @@ int ServerDatabase::getAchievementProgress(UserId user, sqlite3_stmt* stmt)
 	sqlite3_reset(stmt);
 	sqliteThrowExcept(sqlite3_bind_int64(stmt, 1, user));
 
-	if(sqliteThrowExcept(sqlite3_step(stmt)) != SQLITE_ROW)
+	if(sqliteThrowExcept(step(stmt)) != SQLITE_ROW)
 		// Should use dedicated error class
 		throw std::runtime_error(std::string("getAchievementProgress: no data retreived - user: ")
 		                         + std::to_string(user));
@@ -619,7 +625,7 @@ void ServerDatabase::addToAchievementProgress(UserId user, int value, sqlite3_st
 	sqliteThrowExcept(sqlite3_bind_int(stmt, 1, value));
 	sqliteThrowExcept(sqlite3_bind_int64(stmt, 2, user));
 
-	assert(sqliteThrowExcept(sqlite3_step(stmt)) == SQLITE_DONE);
+	assert(sqliteThrowExcept(step(stmt)) == SQLITE_DONE);
 }
 
 ServerDatabase::~ServerDatabase()
@@ -0,0 +1,74 @@
+// WizardPoker headers
+#include "server/ServerSettings.hpp"
+#include "common/constants.hpp"
+#include "common/ErrorCode.hpp"
+// std-C++ headers
+#include <string>
+#include <stdexcept>
+
+/// Reads a strictly positive duration (in the unit of \a Duration) if \a key is present
+/// \return False if the value is not valid
+template <class Duration>
+static bool readDuration(IniFile& config, const std::string& key, Duration& value)
+{
+	if(config.find(key) == config.end())
+		return true;
+	try
+	{
+		const long count{std::stol(config[key], nullptr, AUTO_BASE)};
+		if(count <= 0)
+			return false;
+		value = Duration(count);
+	}
+	catch(const std::logic_error&)  // std::invalid_argument or std::out_of_range
+	{
+		return false;
+	}
+	return true;
+}
+
+/// Reads a strictly positive size in bytes if \a key is present
+/// \return False if the value is not valid
+static bool readSize(IniFile& config, const std::string& key, std::size_t& value)
+{
+	if(config.find(key) == config.end())
+		return true;
+	try
+	{
+		const unsigned long long size{std::stoull(config[key], nullptr, AUTO_BASE)};
+		if(size == 0 or config[key].find('-') != std::string::npos)
+			return false;
+		value = static_cast<std::size_t>(size);
+	}
+	catch(const std::logic_error&)  // std::invalid_argument or std::out_of_range
+	{
+		return false;
+	}
+	return true;
+}
+
+int ServerSettings::readFromIni(IniFile& config)
+{
+	if(config.find("GAME_JOURNAL_DIRECTORY") != config.end())
+		journalDirectory = config["GAME_JOURNAL_DIRECTORY"];
+	if(config.find("CHECKPOINT_FILE") != config.end())
+		checkpointFile = config["CHECKPOINT_FILE"];
+	if(not readDuration(config, "HEARTBEAT_INTERVAL", heartbeatInterval)
+	   or not readDuration(config, "IDLE_TIMEOUT", idleTimeout)
+	   or not readDuration(config, "HANDSHAKE_TIMEOUT", handshakeTimeout)
+	   or not readSize(config, "SEND_QUEUE_LIMIT", sendQueueLimit)
+	   or not readDuration(config, "RECONNECTION_GRACE", reconnectionGrace)
+	   or not readDuration(config, "BOT_OPPONENT_DELAY", botOpponentDelay)
+	   or not readDuration(config, "BOT_MOVE_BUDGET", botMoveBudget)
+	   or not readSize(config, "BOT_THREADS", botThreadsCount)
+	   or not readSize(config, "MAX_SPECTATORS", maxSpectators)
+	   or not readDuration(config, "SPECTATOR_TIMEOUT", spectatorTimeout)
+	   or not readDuration(config, "GAME_STATS_INTERVAL", gameStatsInterval)
+	   or idleTimeout <= heartbeatInterval)
+		return WRONG_FORMAT_CONFIG_FILE;
+	std::size_t port{metricsPort};
+	if(not readSize(config, "METRICS_PORT", port) or port > 0xFFFF)
+		return WRONG_FORMAT_CONFIG_FILE;
+	metricsPort = static_cast<sf::Uint16>(port);
+	return SUCCESS;
+}
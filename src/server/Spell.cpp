@@ -5,7 +5,7 @@ Spell::Spell(const ServerSpellData& cardData):
 {
 }
 
-std::vector<EffectParamsCollection> Spell::getEffects()
+const CardEffects& Spell::getEffects() const
 {
 	return prototype().getEffects();
 }
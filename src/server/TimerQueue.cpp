@@ -0,0 +1,76 @@
+// WizardPoker headers
+#include "server/TimerQueue.hpp"
+// std-C++ headers
+#include <algorithm>
+
+TimerQueue::TimerQueue():
+	_timers(),
+	_cancelled(),
+	_nextId(0)
+{
+}
+
+TimerQueue::TimerId TimerQueue::schedule(Clock::duration delay, Callback callback)
+{
+	return push(delay, Clock::duration::zero(), std::move(callback));
+}
+
+TimerQueue::TimerId TimerQueue::scheduleEvery(Clock::duration period, Callback callback)
+{
+	return push(period, period, std::move(callback));
+}
+
+void TimerQueue::cancel(TimerId id)
+{
+	// the timer is lazily removed when its deadline is reached
+	const auto isCancelledTimer = [id](const Timer& timer)
+	{
+		return timer.id == id;
+	};
+	if(std::any_of(_timers.begin(), _timers.end(), isCancelledTimer))
+		_cancelled.insert(id);
+}
+
+std::size_t TimerQueue::runExpired()
+{
+	const Clock::time_point now{Clock::now()};
+	std::size_t called{0};
+	while(not _timers.empty() and _timers.front().deadline <= now)
+	{
+		std::pop_heap(_timers.begin(), _timers.end(), &TimerQueue::isLater);
+		Timer timer{std::move(_timers.back())};
+		_timers.pop_back();
+
+		if(_cancelled.erase(timer.id) > 0)
+			continue;
+
+		// re-arm before calling, so that the callback can cancel its own timer
+		if(timer.period != Clock::duration::zero())
+		{
+			_timers.push_back({now + timer.period, timer.id, timer.period, timer.callback});
+			std::push_heap(_timers.begin(), _timers.end(), &TimerQueue::isLater);
+		}
+		timer.callback();
+		++called;
+	}
+	return called;
+}
+
+void TimerQueue::clear()
+{
+	_timers.clear();
+	_cancelled.clear();
+}
+
+bool TimerQueue::isLater(const Timer& lhs, const Timer& rhs)
+{
+	return lhs.deadline > rhs.deadline;
+}
+
+TimerQueue::TimerId TimerQueue::push(Clock::duration delay, Clock::duration period, Callback callback)
+{
+	const TimerId id{_nextId++};
+	_timers.push_back({Clock::now() + delay, id, period, std::move(callback)});
+	std::push_heap(_timers.begin(), _timers.end(), &TimerQueue::isLater);
+	return id;
+}
@@ -0,0 +1,146 @@
+/**
+	card balance simulator entry point: plays batches of games between random
+	decks and reports how much each card helps to win
+**/
+
+// WizardPoker headers
+#include "server/BalanceSimulator.hpp"
+#include "server/ServerDatabase.hpp"
+// std-C++ headers
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cmath>
+#include <memory>
+
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [-g GAMES] [-s SEED] [-t THREADS] [-d DATABASE]\n"
+	          << "Plays GAMES (default 100000) games between random decks on THREADS threads\n"
+	          << "(default: all the cores) and reports the win rate of the decks that contain\n"
+	          << "each card. The same SEED (default 0) gives the same report.\n"
+	          << "The cards are read from DATABASE (default: the database of the server).\n";
+}
+
+/// \return The number of turns under which \a ratio of the games ended
+static std::size_t getPercentile(const BalanceReport& report, double ratio)
+{
+	const std::uint64_t finishedGames{report.gamesCount - report.errors};
+	const std::uint64_t target{static_cast<std::uint64_t>(std::ceil(ratio * static_cast<double>(finishedGames)))};
+	std::uint64_t count{0};
+	for(std::size_t turns{0}; turns < report.gameLengths.size(); ++turns)
+		if((count += report.gameLengths[turns]) >= target and count > 0)
+			return turns;
+	return report.gameLengths.size();
+}
+
+static void printGameLengths(const BalanceReport& report)
+{
+	std::cout << "Game length (turns of both players): median " << getPercentile(report, 0.5)
+	          << ", 10% " << getPercentile(report, 0.1) << ", 90% " << getPercentile(report, 0.9)
+	          << ", 99% " << getPercentile(report, 0.99) << "\n";
+	const std::uint64_t maxCount{*std::max_element(report.gameLengths.begin(), report.gameLengths.end())};
+	static constexpr std::uint64_t barWidth{50};
+	for(std::size_t turns{0}; turns < report.gameLengths.size(); ++turns)
+	{
+		const std::uint64_t count{report.gameLengths[turns]};
+		if(count == 0)
+			continue;
+		std::cout << std::setw(5) << turns << " " << std::setw(10) << count << " "
+		          << std::string(static_cast<std::size_t>(count * barWidth / maxCount), '#') << "\n";
+	}
+}
+
+static void printCards(const BalanceReport& report)
+{
+	// a deck wins half of the games that have a winner
+	const std::uint64_t finishedGames{report.gamesCount - report.errors};
+	const double averageWinRate{static_cast<double>(finishedGames - report.draws) / static_cast<double>(2 * finishedGames)};
+	std::vector<CardBalance> cards(report.cards);
+	auto winRate = [](const CardBalance& card)
+	{
+		return card.decks == 0 ? 0. : static_cast<double>(card.wins) / static_cast<double>(card.decks);
+	};
+	std::sort(cards.begin(), cards.end(), [&winRate](const CardBalance& lhs, const CardBalance& rhs)
+	{
+		return winRate(lhs) > winRate(rhs);
+	});
+	std::cout << "Card    Decks     Win rate  Contribution  (+/- standard error)\n";
+	for(const CardBalance& card: cards)
+	{
+		const double rate{winRate(card)};
+		const double error{card.decks == 0 ? 0. : std::sqrt(rate * (1 - rate) / static_cast<double>(card.decks))};
+		std::cout << std::setw(4) << card.card << " " << std::setw(10) << card.decks << "  "
+		          << std::fixed << std::setprecision(2) << std::setw(7) << 100 * rate << "%  "
+		          << std::showpos << std::setw(10) << 100 * (rate - averageWinRate) << "%" << std::noshowpos
+		          << "  (+/- " << 100 * error << "%)\n";
+	}
+	std::cout.unsetf(std::ios::fixed);
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t gamesCount{100000};
+	std::uint64_t seed{0};
+	unsigned threadsCount{std::max(std::thread::hardware_concurrency(), 1U)};
+	std::string databaseFile;
+	try
+	{
+		for(int i{1}; i < argc; i += 2)
+		{
+			const std::string option{argv[i]};
+			if(i + 1 == argc)
+				throw std::invalid_argument(option);
+			if(option == "-g")
+				gamesCount = std::stoull(argv[i + 1]);
+			else if(option == "-s")
+				seed = std::stoull(argv[i + 1], nullptr, 0);
+			else if(option == "-t")
+				threadsCount = static_cast<unsigned>(std::stoul(argv[i + 1]));
+			else if(option == "-d")
+				databaseFile = argv[i + 1];
+			else
+				throw std::invalid_argument(option);
+		}
+	}
+	catch(const std::logic_error&)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(gamesCount == 0 or threadsCount == 0)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		std::unique_ptr<ServerDatabase> database{databaseFile.empty() ? new ServerDatabase() : new ServerDatabase(databaseFile)};
+		BalanceSimulator simulator(*database, seed);
+		const auto start = std::chrono::steady_clock::now();
+		const BalanceReport report{simulator.run(gamesCount, threadsCount)};
+		const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+		std::cout << report.gamesCount << " games (seed " << seed << ", " << report.draws << " without winner, "
+		          << report.errors << " interrupted by an error) in "
+		          << seconds << " s on " << threadsCount << " threads ("
+		          << static_cast<double>(report.gamesCount) / seconds << " games/s)\n\n";
+		if(report.errors == report.gamesCount)
+			return EXIT_FAILURE;
+		printGameLengths(report);
+		std::cout << "\n";
+		printCards(report);
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
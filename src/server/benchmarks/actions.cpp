@@ -0,0 +1,112 @@
+/**
+	benchmark of the actions: plays games between random policies and
+	reports the number of actions played per second
+**/
+
+// WizardPoker headers
+#include "server/GameSimulation.hpp"
+#include "server/GamePolicy.hpp"
+#include "server/ServerDatabase.hpp"
+// std-C++ headers
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstddef>
+#include <memory>
+
+/// Random policy that counts the actions it plays
+class CountingPolicy final : public GamePolicy
+{
+public:
+	CountingPolicy(RandomInteger::Seed seed, std::size_t& actionsCount):
+		_policy(seed),
+		_actionsCount(actionsCount)
+	{
+	}
+
+	PlayerAction nextAction(const Player& self, const Player& opponent) override
+	{
+		++_actionsCount;
+		return _policy.nextAction(self, opponent);
+	}
+
+	std::vector<int> selectCards(const Player& self, const Player& opponent, const std::vector<CardToSelect>& selection) override
+	{
+		return _policy.selectCards(self, opponent, selection);
+	}
+
+private:
+	RandomPolicy _policy;
+	std::size_t& _actionsCount;
+};
+
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [-g GAMES] [-d DATABASE]\n"
+	          << "Plays GAMES (default 2000) games between random policies with the default\n"
+	          << "decks and reports the number of actions (cards used, attacks and turns\n"
+	          << "ended) played per second. The games are the same from a run to another.\n"
+	          << "The cards are read from DATABASE (default: the database of the server).\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t gamesCount{2000};
+	std::string databaseFile;
+	try
+	{
+		for(int i{1}; i < argc; i += 2)
+		{
+			const std::string option{argv[i]};
+			if(i + 1 == argc)
+				throw std::invalid_argument(option);
+			if(option == "-g")
+				gamesCount = std::stoull(argv[i + 1]);
+			else if(option == "-d")
+				databaseFile = argv[i + 1];
+			else
+				throw std::invalid_argument(option);
+		}
+	}
+	catch(const std::logic_error&)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(gamesCount == 0)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		std::unique_ptr<ServerDatabase> database{databaseFile.empty() ? new ServerDatabase() : new ServerDatabase(databaseFile)};
+		std::size_t actionsCount{0};
+		std::size_t winsCount{0};
+		const auto start = std::chrono::steady_clock::now();
+		for(std::size_t i{0}; i < gamesCount; ++i)
+		{
+			GameSimulation game(*database, static_cast<RandomInteger::Seed>(100 + i));
+			CountingPolicy policy1(static_cast<RandomInteger::Seed>(i), actionsCount);
+			CountingPolicy policy2(static_cast<RandomInteger::Seed>(i + 1), actionsCount);
+			if(game.play(Deck(), policy1, Deck(), policy2) == 1)
+				++winsCount;
+		}
+		const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+		// the wins tell whether the games are still the same
+		std::cout << gamesCount << " games in " << seconds << " s, " << winsCount << " won by the player 1\n"
+		          << actionsCount << " actions (" << static_cast<double>(actionsCount) / seconds << " actions/s, "
+		          << static_cast<double>(actionsCount) / static_cast<double>(gamesCount) << " per game)\n";
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
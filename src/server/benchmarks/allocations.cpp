@@ -0,0 +1,108 @@
+/**
+	benchmark of the allocations of a game: plays games between random
+	policies and counts the calls to operator new per game
+**/
+
+// WizardPoker headers
+#include "server/GameSimulation.hpp"
+#include "server/GamePolicy.hpp"
+#include "server/ServerDatabase.hpp"
+// std-C++ headers
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstddef>
+#include <memory>
+
+/// Number of calls to operator new, the benchmark is single-threaded
+static std::size_t allocationsCount{0};
+
+void* operator new(std::size_t size)
+{
+	++allocationsCount;
+	if(void* memory = std::malloc(size == 0 ? 1 : size))
+		return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [-g GAMES] [-d DATABASE]\n"
+	          << "Plays GAMES (default 2000) games between random policies with the default\n"
+	          << "decks and reports the number of allocations per game. The games are the\n"
+	          << "same from a run to another.\n"
+	          << "The cards are read from DATABASE (default: the database of the server).\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t gamesCount{2000};
+	std::string databaseFile;
+	try
+	{
+		for(int i{1}; i < argc; i += 2)
+		{
+			const std::string option{argv[i]};
+			if(i + 1 == argc)
+				throw std::invalid_argument(option);
+			if(option == "-g")
+				gamesCount = std::stoull(argv[i + 1]);
+			else if(option == "-d")
+				databaseFile = argv[i + 1];
+			else
+				throw std::invalid_argument(option);
+		}
+	}
+	catch(const std::logic_error&)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(gamesCount == 0)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		std::unique_ptr<ServerDatabase> database{databaseFile.empty() ? new ServerDatabase() : new ServerDatabase(databaseFile)};
+		std::size_t turnsCount{0};
+		// the allocations of the database are not counted
+		const std::size_t firstAllocation{allocationsCount};
+		const auto start = std::chrono::steady_clock::now();
+		for(std::size_t i{0}; i < gamesCount; ++i)
+		{
+			GameSimulation game(*database, static_cast<RandomInteger::Seed>(100 + i));
+			RandomPolicy policy1(static_cast<RandomInteger::Seed>(i));
+			RandomPolicy policy2(static_cast<RandomInteger::Seed>(i + 1));
+			game.play(Deck(), policy1, Deck(), policy2);
+			turnsCount += static_cast<std::size_t>(game.getTurnsCount());
+		}
+		const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+		const double games{static_cast<double>(gamesCount)};
+
+		std::cout << gamesCount << " games in " << seconds << " s (" << games / seconds << " games/s, "
+		          << static_cast<double>(turnsCount) / games << " turns per game)\n"
+		          << "Allocations per game: " << static_cast<double>(allocationsCount - firstAllocation) / games << "\n";
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,256 @@
+/**
+	benchmark of a connect storm: opens many connections to a running server,
+	some of them sending their first packet a byte at a time, and measures
+	meanwhile how long a logged user waits for the answers of the server
+**/
+
+// WizardPoker headers
+#include "common/sockets/TransferType.hpp"
+#include "common/sockets/PacketOverload.hpp"
+#include "common/Identifiers.hpp"
+// SFML headers
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+// std-C++ headers
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstddef>
+
+typedef std::chrono::steady_clock Clock;
+
+/// \return The bytes sent on the socket for \a packet (its size, in network
+/// order, then its data), as sf::TcpSocket::send(sf::Packet&) frames it
+static std::vector<char> frame(const sf::Packet& packet)
+{
+	const std::size_t size{packet.getDataSize()};
+	std::vector<char> bytes{static_cast<char>(size >> 24), static_cast<char>(size >> 16),
+			static_cast<char>(size >> 8), static_cast<char>(size)};
+	const char* data{static_cast<const char*>(packet.getData())};
+	bytes.insert(bytes.end(), data, data + size);
+	return bytes;
+}
+
+/// \return The first packet of a connection with unknown identifiers, the
+/// server answers it with WRONG_IDENTIFIERS
+static sf::Packet makeStormPacket(std::size_t index)
+{
+	sf::Packet packet;
+	packet << TransferType::CONNECTION << "storm" + std::to_string(index) << std::string("password") << sf::Uint16{0};
+	return packet;
+}
+
+/// Connection that sends its first packet a byte at a time, as a slow (or
+/// malicious) client would do
+struct SlowConnection
+{
+	std::unique_ptr<sf::TcpSocket> socket;
+	std::vector<char> bytes;
+	std::size_t sent;
+};
+
+/// Counts of the storm, written by the thread of the storm
+struct StormResult
+{
+	std::size_t answered{0};  ///< Connections that got the answer of the server
+	std::size_t failed{0};    ///< Connections refused or closed before the answer
+	double seconds{0.};
+};
+
+/// Opens \a connectionsCount connections in batches of \a batchSize, each
+/// sending its first packet at once and waiting for the answer, while
+/// \a slowCount other connections send theirs a byte at a time
+static void runStorm(const sf::IpAddress& address, sf::Uint16 port, std::size_t connectionsCount,
+		std::size_t batchSize, std::size_t slowCount, StormResult& result)
+{
+	const auto start = Clock::now();
+	std::vector<SlowConnection> slowConnections;
+	for(std::size_t i{0}; i < slowCount; ++i)
+	{
+		std::unique_ptr<sf::TcpSocket> socket{new sf::TcpSocket()};
+		if(socket->connect(address, port, sf::seconds(5)) != sf::Socket::Done)
+		{
+			++result.failed;
+			continue;
+		}
+		slowConnections.push_back({std::move(socket), frame(makeStormPacket(connectionsCount + i)), 0});
+	}
+
+	for(std::size_t first{0}; first < connectionsCount; first += batchSize)
+	{
+		// a byte of each slow connection goes with each batch
+		for(SlowConnection& slow : slowConnections)
+			if(slow.sent + 1 < slow.bytes.size() and slow.socket->send(&slow.bytes[slow.sent], 1) == sf::Socket::Done)
+				++slow.sent;
+
+		const std::size_t last{std::min(first + batchSize, connectionsCount)};
+		std::vector<std::unique_ptr<sf::TcpSocket>> batch;
+		for(std::size_t i{first}; i < last; ++i)
+		{
+			std::unique_ptr<sf::TcpSocket> socket{new sf::TcpSocket()};
+			sf::Packet packet{makeStormPacket(i)};
+			if(socket->connect(address, port, sf::seconds(5)) != sf::Socket::Done or socket->send(packet) != sf::Socket::Done)
+			{
+				++result.failed;
+				continue;
+			}
+			batch.push_back(std::move(socket));
+		}
+		for(auto& socket : batch)
+		{
+			sf::Packet answer;
+			TransferType type;
+			if(socket->receive(answer) == sf::Socket::Done and answer >> type and type == TransferType::WRONG_IDENTIFIERS)
+				++result.answered;
+			else
+				++result.failed;
+		}
+	}
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// \return The logged connection of a new user, which measures the latency of the server
+static std::unique_ptr<sf::TcpSocket> logIn(const sf::IpAddress& address, sf::Uint16 port)
+{
+	const std::string name{"probe" + std::to_string(Clock::now().time_since_epoch().count() % 1000000000)};
+	const std::string password{"password"};
+	sf::Packet packet;
+	TransferType type;
+	{
+		sf::TcpSocket registering;
+		packet << TransferType::REGISTERING << name << password;
+		if(registering.connect(address, port, sf::seconds(5)) != sf::Socket::Done or registering.send(packet) != sf::Socket::Done
+		   or registering.receive(packet) != sf::Socket::Done or not (packet >> type) or type != TransferType::ACKNOWLEDGE)
+			throw std::runtime_error("Unable to register the user " + name);
+	}
+	std::unique_ptr<sf::TcpSocket> socket{new sf::TcpSocket()};
+	packet.clear();
+	packet << TransferType::CONNECTION << name << password << sf::Uint16{0};
+	if(socket->connect(address, port, sf::seconds(5)) != sf::Socket::Done or socket->send(packet) != sf::Socket::Done
+	   or socket->receive(packet) != sf::Socket::Done or not (packet >> type) or type != TransferType::ACKNOWLEDGE)
+		throw std::runtime_error("Unable to connect the user " + name);
+	return socket;
+}
+
+/// Asks the ladder to the server
+/// \return The time the answer took
+static Clock::duration measureRequest(sf::TcpSocket& socket)
+{
+	const auto start = Clock::now();
+	sf::Packet packet;
+	packet << TransferType::ASK_LADDER;
+	if(socket.send(packet) != sf::Socket::Done)
+		throw std::runtime_error("The server closed the connection of the user");
+	TransferType type;
+	// the presence notifications are not the answer
+	do
+	{
+		if(socket.receive(packet) != sf::Socket::Done)
+			throw std::runtime_error("The server closed the connection of the user");
+	}
+	while(not (packet >> type) or (type != TransferType::ACKNOWLEDGE and type != TransferType::FAILURE));
+	return Clock::now() - start;
+}
+
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [-a ADDRESS] [-p PORT] [-c CONNECTIONS] [-b BATCH] [-s SLOW]\n"
+	          << "Opens CONNECTIONS (default 2000) connections to the server listening on\n"
+	          << "ADDRESS:PORT (default localhost:0x4000), BATCH (default 100) at a time,\n"
+	          << "while SLOW (default 100) other connections send their first packet a byte\n"
+	          << "at a time. A logged user asks the ladder meanwhile, and the benchmark\n"
+	          << "reports the answered connections per second and the latency of the user.\n"
+	          << "The server must be running, and the sockets it holds at once are bounded\n"
+	          << "by FD_SETSIZE (see sf::SocketSelector).\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::string address{"localhost"};
+	sf::Uint16 port{0x4000};
+	std::size_t connectionsCount{2000};
+	std::size_t batchSize{100};
+	std::size_t slowCount{100};
+	try
+	{
+		for(int i{1}; i < argc; i += 2)
+		{
+			const std::string option{argv[i]};
+			if(i + 1 == argc)
+				throw std::invalid_argument(option);
+			if(option == "-a")
+				address = argv[i + 1];
+			else if(option == "-p")
+				port = static_cast<sf::Uint16>(std::stoul(argv[i + 1], nullptr, 0));
+			else if(option == "-c")
+				connectionsCount = std::stoull(argv[i + 1]);
+			else if(option == "-b")
+				batchSize = std::stoull(argv[i + 1]);
+			else if(option == "-s")
+				slowCount = std::stoull(argv[i + 1]);
+			else
+				throw std::invalid_argument(option);
+		}
+	}
+	catch(const std::logic_error&)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(connectionsCount == 0 or batchSize == 0)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		const sf::IpAddress serverAddress{address};
+		std::unique_ptr<sf::TcpSocket> user{logIn(serverAddress, port)};
+		const Clock::duration idleLatency{measureRequest(*user)};
+
+		StormResult result;
+		std::atomic_bool isStormOver{false};
+		std::thread storm([&]()
+		{
+			runStorm(serverAddress, port, connectionsCount, batchSize, slowCount, result);
+			isStormOver.store(true);
+		});
+		std::size_t requestsCount{0};
+		Clock::duration totalLatency{0};
+		Clock::duration maxLatency{0};
+		while(not isStormOver.load())
+		{
+			const Clock::duration latency{measureRequest(*user)};
+			++requestsCount;
+			totalLatency += latency;
+			maxLatency = std::max(maxLatency, latency);
+		}
+		storm.join();
+
+		const auto toMilliseconds = [](Clock::duration duration)
+		{
+			return std::chrono::duration<double, std::milli>(duration).count();
+		};
+		std::cout << result.answered << " connections answered in " << result.seconds << " s ("
+		          << static_cast<double>(result.answered) / result.seconds << "/s), " << result.failed << " failed\n"
+		          << "Latency of the logged user: " << toMilliseconds(idleLatency) << " ms before the storm, "
+		          << (requestsCount == 0 ? 0. : toMilliseconds(totalLatency) / static_cast<double>(requestsCount))
+		          << " ms on average and " << toMilliseconds(maxLatency) << " ms at most during it ("
+		          << requestsCount << " requests)\n";
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/**
+	benchmark of the card effects: applies effects to a creature through
+	Creature::applyEffectToSelf and reports the effects applied per second
+**/
+
+// WizardPoker headers
+#include "server/GameSimulation.hpp"
+#include "server/ServerDatabase.hpp"
+#include "server/ServerCardData.hpp"
+#include "server/CardArena.hpp"
+#include "server/Creature.hpp"
+#include "server/Player.hpp"
+#include "server/PostGameData.hpp"
+// std-C++ headers
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>
+#include <memory>
+
+/// Two players out of any game, to own the creature
+struct BenchmarkPlayers
+{
+	PostGameData postGameData1;
+	PostGameData postGameData2;
+	CardArena cards;
+	Player player1;
+	Player player2;
+
+	BenchmarkPlayers(GameContext& game, ServerDatabase& database):
+		postGameData1(),
+		postGameData2(),
+		cards(1),
+		player1(game, database, cards, 1, player2, postGameData1),
+		player2(game, database, cards, 2, player1, postGameData2)
+	{
+	}
+};
+
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [-n EFFECTS] [-d DATABASE]\n"
+	          << "Applies EFFECTS (default 20000000) effects that change the attack and the\n"
+	          << "shield of a creature, and reports the number of effects per second.\n"
+	          << "The creature is the first one of DATABASE (default: the database of the server).\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::size_t effectsCount{20000000};
+	std::string databaseFile;
+	try
+	{
+		for(int i{1}; i < argc; i += 2)
+		{
+			const std::string option{argv[i]};
+			if(i + 1 == argc)
+				throw std::invalid_argument(option);
+			if(option == "-n")
+				effectsCount = std::stoull(argv[i + 1]);
+			else if(option == "-d")
+				databaseFile = argv[i + 1];
+			else
+				throw std::invalid_argument(option);
+		}
+	}
+	catch(const std::logic_error&)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(effectsCount == 0)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		std::unique_ptr<ServerDatabase> database{databaseFile.empty() ? new ServerDatabase() : new ServerDatabase(databaseFile)};
+		GameSimulation game(*database, 0);
+		BenchmarkPlayers players(game, *database);
+		Creature* creature{nullptr};
+		for(CardId id{1}; id <= database->countCards() and creature == nullptr; ++id)
+		{
+			Card* card{database->getCard(id, players.player1, players.cards)};
+			if(card->isCreature())
+				creature = static_cast<Creature*>(card);
+		}
+		if(creature == nullptr)
+			throw std::runtime_error("There is no creature in the database");
+
+		// the attack and the shield come back to their value after each round
+		const CardEffects effects(0, true, {
+			{CREATURE_SELF_THIS, CE_CHANGE_ATTACK, 1},
+			{CREATURE_SELF_THIS, CE_CHANGE_ATTACK, -1},
+			{CREATURE_SELF_THIS, CE_CHANGE_SHIELD, 1},
+			{CREATURE_SELF_THIS, CE_CHANGE_SHIELD, -1}});
+		std::size_t appliedCount{0};
+		const auto start = std::chrono::steady_clock::now();
+		while(appliedCount < effectsCount)
+			for(const CardEffect& effect: effects)
+			{
+				creature->applyEffectToSelf(effect);
+				++appliedCount;
+			}
+		const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+		std::cout << appliedCount << " effects in " << seconds << " s ("
+		          << static_cast<double>(appliedCount) / seconds / 1e6 << "M effects/s, creature "
+		          << creature->getId() << " ends with attack " << creature->getAttack() << ")\n";
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
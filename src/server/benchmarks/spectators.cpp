@@ -0,0 +1,261 @@
+/**
+	benchmark of the spectators: watches the game of a player with many
+	connections to a running server, some of them never reading, and
+	measures how long the server takes to send each state of the game to
+	all the spectators that read
+**/
+
+// WizardPoker headers
+#include "common/sockets/TransferType.hpp"
+#include "common/sockets/PacketOverload.hpp"
+#include "common/Identifiers.hpp"
+// SFML headers
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/Packet.hpp>
+#include <SFML/System/Sleep.hpp>
+// std-C++ headers
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstddef>
+
+typedef std::chrono::steady_clock Clock;
+
+/// Connection of a spectator to the game
+struct Spectator
+{
+	std::unique_ptr<sf::TcpSocket> socket;
+	bool isSlow;      ///< Never reads, the server must drop it without slowing the others
+	bool isWatching;  ///< Received a state of the game
+	bool isClosed;    ///< Refused, or closed by the server
+};
+
+/// Times at which the spectators received a state of the game
+struct StateArrivals
+{
+	Clock::time_point first;
+	Clock::time_point last;
+	std::size_t count;
+};
+
+/// \return The logged connection of a new user, the spectators of the game
+/// are its other connections
+/// \param name Set to the name of the user
+/// \param sessionToken Set to the session token of the user
+static std::unique_ptr<sf::TcpSocket> logIn(const sf::IpAddress& address, sf::Uint16 port, std::string& name,
+		SessionToken& sessionToken)
+{
+	name = "watcher" + std::to_string(Clock::now().time_since_epoch().count() % 1000000000);
+	const std::string password{"password"};
+	sf::Packet packet;
+	TransferType type;
+	{
+		sf::TcpSocket registering;
+		packet << TransferType::REGISTERING << name << password;
+		if(registering.connect(address, port, sf::seconds(5)) != sf::Socket::Done or registering.send(packet) != sf::Socket::Done
+		   or registering.receive(packet) != sf::Socket::Done or not (packet >> type) or type != TransferType::ACKNOWLEDGE)
+			throw std::runtime_error("Unable to register the user " + name);
+	}
+	std::unique_ptr<sf::TcpSocket> socket{new sf::TcpSocket()};
+	packet.clear();
+	packet << TransferType::CONNECTION << name << password << sf::Uint16{0};
+	sf::Uint32 heartbeatSeconds;
+	if(socket->connect(address, port, sf::seconds(5)) != sf::Socket::Done or socket->send(packet) != sf::Socket::Done
+	   or socket->receive(packet) != sf::Socket::Done or not (packet >> type) or type != TransferType::ACKNOWLEDGE
+	   or not (packet >> heartbeatSeconds >> sessionToken))
+		throw std::runtime_error("Unable to connect the user " + name);
+	return socket;
+}
+
+/// Opens the connections of \a spectatorsCount spectators of the game of
+/// \a playerName, the first \a slowCount ones never read
+static std::vector<Spectator> openSpectators(const sf::IpAddress& address, sf::Uint16 port, const std::string& name,
+		SessionToken sessionToken, const std::string& playerName, std::size_t spectatorsCount, std::size_t slowCount)
+{
+	std::vector<Spectator> spectators;
+	for(std::size_t i{0}; i < spectatorsCount; ++i)
+	{
+		std::unique_ptr<sf::TcpSocket> socket{new sf::TcpSocket()};
+		sf::Packet packet;
+		packet << TransferType::GAME_SPECTATE << name << sessionToken << playerName;
+		if(socket->connect(address, port, sf::seconds(5)) != sf::Socket::Done or socket->send(packet) != sf::Socket::Done)
+			throw std::runtime_error("Unable to open the connection of the spectator " + std::to_string(i));
+		// the spectators are read in turn, none of them must block the others
+		socket->setBlocking(false);
+		spectators.push_back({std::move(socket), i < slowCount, false, false});
+	}
+	return spectators;
+}
+
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " -w PLAYER [-a ADDRESS] [-p PORT] [-n SPECTATORS] [-s SLOW] [-t SECONDS]\n"
+	          << "Watches during SECONDS (default 30) the game that PLAYER is playing on the\n"
+	          << "server listening on ADDRESS:PORT (default localhost:0x4000), with SPECTATORS\n"
+	          << "(default 1000) connections, SLOW (default 100) of them never reading. The\n"
+	          << "benchmark reports how long each state of the game took to reach all the\n"
+	          << "spectators that read, and how many of the slow ones the server dropped\n"
+	          << "(after SPECTATOR_TIMEOUT, see server.ini). MAX_SPECTATORS bounds the\n"
+	          << "spectators of a game.\n";
+}
+
+int main(int argc, char** argv)
+{
+	std::string address{"localhost"};
+	sf::Uint16 port{0x4000};
+	std::string playerName;
+	std::size_t spectatorsCount{1000};
+	std::size_t slowCount{100};
+	std::chrono::seconds duration{30};
+	try
+	{
+		for(int i{1}; i < argc; i += 2)
+		{
+			const std::string option{argv[i]};
+			if(i + 1 == argc)
+				throw std::invalid_argument(option);
+			if(option == "-w")
+				playerName = argv[i + 1];
+			else if(option == "-a")
+				address = argv[i + 1];
+			else if(option == "-p")
+				port = static_cast<sf::Uint16>(std::stoul(argv[i + 1], nullptr, 0));
+			else if(option == "-n")
+				spectatorsCount = std::stoull(argv[i + 1]);
+			else if(option == "-s")
+				slowCount = std::stoull(argv[i + 1]);
+			else if(option == "-t")
+				duration = std::chrono::seconds(std::stoll(argv[i + 1]));
+			else
+				throw std::invalid_argument(option);
+		}
+	}
+	catch(const std::logic_error&)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(playerName.empty() or spectatorsCount == 0 or slowCount > spectatorsCount)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		const sf::IpAddress serverAddress{address};
+		std::string name;
+		SessionToken sessionToken;
+		// the lobby connection is kept, the spectators are checked against it
+		std::unique_ptr<sf::TcpSocket> user{logIn(serverAddress, port, name, sessionToken)};
+		const auto openingStart = Clock::now();
+		std::vector<Spectator> spectators{openSpectators(serverAddress, port, name, sessionToken, playerName,
+				spectatorsCount, slowCount)};
+		const double openingSeconds{std::chrono::duration<double>(Clock::now() - openingStart).count()};
+
+		std::unordered_map<std::string, StateArrivals> states;
+		std::size_t refusedCount{0};
+		bool isGameOver{false};
+		const auto deadline = Clock::now() + duration;
+		while(Clock::now() < deadline and not isGameOver)
+		{
+			bool hasReceived{false};
+			for(Spectator& spectator : spectators)
+			{
+				if(spectator.isSlow or spectator.isClosed)
+					continue;
+				sf::Packet packet;
+				sf::Socket::Status status;
+				while((status = spectator.socket->receive(packet)) == sf::Socket::Done)
+				{
+					hasReceived = true;
+					const auto now = Clock::now();
+					// the spectators get the same frame for the same state
+					const std::string frame(static_cast<const char*>(packet.getData()), packet.getDataSize());
+					TransferType type;
+					packet >> type;
+					if(type == TransferType::GAME_STATE)
+					{
+						StateArrivals& arrivals(states[frame]);
+						if(arrivals.count == 0)
+							arrivals.first = now;
+						arrivals.last = now;
+						++arrivals.count;
+						spectator.isWatching = true;
+					}
+					else if(type == TransferType::FAILURE)
+					{
+						++refusedCount;
+						spectator.isClosed = true;
+						break;
+					}
+					else if(type == TransferType::GAME_OVER)
+						isGameOver = true;
+				}
+				if(status == sf::Socket::Disconnected or status == sf::Socket::Error)
+					spectator.isClosed = true;
+			}
+			if(not hasReceived)
+				sf::sleep(sf::milliseconds(1));
+		}
+
+		// the connections of the dropped slow spectators are closed after the
+		// data that the server could send before
+		std::size_t droppedCount{0};
+		for(Spectator& spectator : spectators)
+		{
+			if(not spectator.isSlow)
+				continue;
+			sf::Packet packet;
+			sf::Socket::Status status;
+			while((status = spectator.socket->receive(packet)) == sf::Socket::Done)
+				continue;
+			if(status == sf::Socket::Disconnected or status == sf::Socket::Error)
+				++droppedCount;
+		}
+
+		const std::size_t watchingCount{static_cast<std::size_t>(std::count_if(spectators.begin(), spectators.end(),
+				[](const Spectator& spectator)
+				{
+					return spectator.isWatching;
+				}))};
+		std::size_t spreadCount{0};
+		Clock::duration totalSpread{0};
+		Clock::duration maxSpread{0};
+		for(const auto& state : states)
+		{
+			// the spread of the states received by a single spectator is meaningless
+			if(state.second.count < 2)
+				continue;
+			const Clock::duration spread{state.second.last - state.second.first};
+			++spreadCount;
+			totalSpread += spread;
+			maxSpread = std::max(maxSpread, spread);
+		}
+		const auto toMilliseconds = [](Clock::duration spread)
+		{
+			return std::chrono::duration<double, std::milli>(spread).count();
+		};
+		std::cout << spectatorsCount << " spectators connected in " << openingSeconds << " s, "
+		          << watchingCount << " of the " << spectatorsCount - slowCount << " that read got the game, "
+		          << refusedCount << " refused\n"
+		          << states.size() << " states, " << spreadCount << " received by several spectators, all of them within "
+		          << (spreadCount == 0 ? 0. : toMilliseconds(totalSpread) / static_cast<double>(spreadCount))
+		          << " ms on average and " << toMilliseconds(maxSpread) << " ms at most\n"
+		          << droppedCount << " of the " << slowCount << " slow spectators dropped by the server"
+		          << (isGameOver ? ", the game is over\n" : "\n");
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+/**
+	game journal replayer entry point: plays again the games recorded by the
+	server (see GAME_JOURNAL_DIRECTORY in server.ini) and checks that they end
+	as recorded
+**/
+
+// WizardPoker headers
+#include "server/GameSimulation.hpp"
+#include "server/GameJournal.hpp"
+#include "server/ServerDatabase.hpp"
+// std-C++ headers
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+	if(argc < 2)
+	{
+		std::cerr << "Usage: " << argv[0] << " JOURNAL...\n"
+		          << "Replays the given game journals and checks that the games end as recorded\n";
+		return EXIT_FAILURE;
+	}
+	ServerDatabase database;
+	std::size_t diverged{0}, records{0};
+	std::chrono::steady_clock::duration replayTime{std::chrono::steady_clock::duration::zero()};
+	for(int i{1}; i < argc; ++i)
+	{
+		try
+		{
+			GameJournalReader journal(argv[i]);
+			const JournalHeader& header(journal.getHeader());
+			GameSimulation game(database, header.seed, header.player1Id, header.player2Id);
+			const auto start = std::chrono::steady_clock::now();
+			const UserId winnerId{game.replay(journal)};
+			replayTime += std::chrono::steady_clock::now() - start;
+			records += journal.getRecordsCount();
+			std::cout << argv[i] << ": " << journal.getRecordsCount() << " records, winner " << winnerId << "\n";
+		}
+		catch(const std::runtime_error& e)
+		{
+			++diverged;
+			std::cerr << argv[i] << ": " << e.what() << "\n";
+		}
+	}
+	const double seconds{std::chrono::duration<double>(replayTime).count()};
+	std::cout << argc - 1 << " games replayed (" << diverged << " diverged), "
+	          << records << " records in " << seconds << " s";
+	if(seconds > 0)
+		std::cout << " (" << static_cast<double>(records) / seconds << " records/s)";
+	std::cout << std::endl;
+	return diverged == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -5,6 +5,7 @@
 // WizardPoker headers
 #include "common/constants.hpp"
 #include "server/Server.hpp"
+#include "server/ServerSettings.hpp"
 #include "server/ErrorCode.hpp"
 #include "common/ini/IniFile.hpp"
 // std-C++ headers
@@ -27,7 +28,10 @@ int main()
 	int status = config.readFromFile(SERVER_CONFIG_FILE_PATH);
 	if(status != SUCCESS)
 		return status;
-	Server server;
+	ServerSettings settings;
+	if((status = settings.readFromIni(config)) != SUCCESS)
+		return status;
+	Server server(settings);
 	if(config.find("SERVER_PORT") == config.end())
 		return WRONG_FORMAT_CONFIG_FILE;
 	sf::Uint16 serverPort{static_cast<sf::Uint16>(std::stoi(config["SERVER_PORT"], nullptr, AUTO_BASE))};
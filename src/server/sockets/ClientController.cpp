@@ -0,0 +1,41 @@
+// WizardPoker headers
+#include "server/ClientController.hpp"
+#include "common/sockets/PacketOverload.hpp"
+
+ClientController::ClientController():
+	_socketToClient()
+{
+	// Input sockets are non-blocking, this is easier since the sockets of the
+	// two players are read by the same thread. So that as soon as a packet is
+	// received, the packet is handled, rather than waiting that the other
+	// client sends a packet.
+	_socketToClient.setBlocking(false);
+}
+
+void ClientController::send(sf::Packet& packet)
+{
+	_socketToClient.queue(packet);
+}
+
+bool ClientController::selectCards(const std::vector<CardToSelect>& selection, std::vector<int>& /* indices */)
+{
+	// the request is flushed with the other packets of the tick, the game
+	// goes on (e.g. the turn can time out) while the user chooses the cards
+	sf::Packet packet;
+	packet << TransferType::GAME_SELECT_CARDS << selection;
+	_socketToClient.queue(packet);
+	return false;
+}
+
+sf::Socket::Status ClientController::receiveBlocking(sf::Packet& packet)
+{
+	_socketToClient.setBlocking(true);
+	const sf::Socket::Status status{_socketToClient.receive(packet)};
+	_socketToClient.setBlocking(false);
+	return status;
+}
+
+TcpConnection& ClientController::getSocket()
+{
+	return _socketToClient;
+}
@@ -14,6 +14,9 @@
 #include <chrono>
 #include <cassert>
 #include <sstream>
+#include <cstring>
+#include <random>
+#include <functional>
 
 constexpr std::chrono::seconds GameThread::_turnTime;
 
@@ -22,10 +25,12 @@ GameThread::GameThread(ServerDatabase& database, UserId player1Id, UserId player
 	_player1Id(player1Id),
 	_player2Id(player2Id),
 	_running(false),
-	_player1(*this, database, _player1Id, _player2, _postGameDataPlayer1),
-	_player2(*this, database, _player2Id, _player1, _postGameDataPlayer2),
+	_cards(GameSnapshot::cardsCount),
+	_player1(*this, database, _cards, _player1Id, _player2, _postGameDataPlayer1),
+	_player2(*this, database, _cards, _player2Id, _player1, _postGameDataPlayer2),
 	_database(database),
 	_winnerId{0},
+	_endGameCause(EndGame::Cause::ENDING_SERVER),
 	_turn(0),
 	_turnSwap{false}
 {
@@ -34,14 +39,20 @@ GameThread::GameThread(ServerDatabase& database, UserId player1Id, UserId player
 
 void GameThread::createPlayers()
 {
+	_player1.setController(_clientPlayer1);
+	_player2.setController(_clientPlayer2);
 	_activePlayer = &_player1;
 	_passivePlayer = &_player2;
 	_activeSpecialSocket = &_specialOutputSocketPlayer1;
 	_passiveSpecialSocket = &_specialOutputSocketPlayer2;
-	std::random_device device;
-	// probability of 1/2 to swap the active and passive players
-	if(std::bernoulli_distribution(0.5)(device))
+	// probability of 1/2 to swap the active and passive players (the seeded
+	// generator is used so that the whole game is given by the seed)
+	if(_intGenerator.next(2) == 1)
 		swapData();
+	// the tokens must not be guessed, they do not come from the seeded generator
+	std::random_device device;
+	for(Session* session : {&_sessionPlayer1, &_sessionPlayer2})
+		session->token = (static_cast<SessionToken>(device()) << 32) | static_cast<SessionToken>(device());
 }
 
 RandomInteger& GameThread::getGenerator()
@@ -49,6 +60,123 @@ RandomInteger& GameThread::getGenerator()
 	return _intGenerator;
 }
 
+GameJournal& GameThread::getJournal()
+{
+	return _journal;
+}
+
+Constraints::CasterVersion& GameThread::getCasterVersion()
+{
+	return _casterVersion;
+}
+
+GameStats* GameThread::getStats()
+{
+	return &_stats;
+}
+
+void GameThread::setVerbose(bool verbose)
+{
+	_verbose = verbose;
+}
+
+void GameThread::setStatsInterval(std::chrono::seconds interval)
+{
+	_statsInterval = interval;
+}
+
+void GameThread::setCheckpoints(GameCheckpoints& checkpoints)
+{
+	_checkpoints = &checkpoints;
+}
+
+void GameThread::resume(const GameSnapshot& snapshot)
+{
+	_resumedGame.reset(new GameSnapshot(snapshot));
+}
+
+bool GameThread::isResumed() const
+{
+	return _resumedGame != nullptr;
+}
+
+void GameThread::openJournal(const std::string& directory)
+{
+	const std::int64_t startTime{std::chrono::duration_cast<std::chrono::seconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count()};
+	const std::string filename{directory + "/game-" + std::to_string(startTime) + "-"
+			+ std::to_string(_player1Id) + "-" + std::to_string(_player2Id) + ".journal"};
+	if(not _journal.open(filename, makeJournalHeader(startTime)))
+		std::cerr << "Unable to create the game journal " << filename << ", the game is not recorded\n";
+}
+
+JournalHeader GameThread::makeJournalHeader(std::int64_t startTime) const
+{
+	return {_intGenerator.getSeed(), _player1Id, _player2Id, _activePlayer->getId(), startTime};
+}
+
+void GameThread::setBotOpponent(BotPool& pool, std::chrono::milliseconds moveBudget)
+{
+	_bot.reset(new BotController(pool, _database, moveBudget, _player2, _player1));
+	_player2.setController(*_bot);
+	// nobody displays the board of the bot
+	_player2.setBoardChangesLogged(false);
+	// the bot searches its actions from the history of the game
+	const std::int64_t startTime{std::chrono::duration_cast<std::chrono::seconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count()};
+	_journal.keepRecords(makeJournalHeader(startTime));
+}
+
+bool GameThread::hasBotOpponent() const
+{
+	return _bot != nullptr;
+}
+
+void GameThread::allowSpectators(std::size_t maxSpectators, std::chrono::seconds timeout)
+{
+	std::lock_guard<std::mutex> lockSpectators{_spectatorsMutex};
+	_maxSpectators = maxSpectators;
+	_spectatorTimeout = timeout;
+}
+
+bool GameThread::addSpectator(std::unique_ptr<TcpConnection>& spectator)
+{
+	std::lock_guard<std::mutex> lockSpectators{_spectatorsMutex};
+	if(_isSpectatingOver or _spectatorsCount + _newSpectators.size() >= _maxSpectators)
+		return false;
+	// the game adopts it at its next tick
+	_newSpectators.push_back(std::move(spectator));
+	return true;
+}
+
+void GameThread::allowReconnection(std::chrono::seconds grace)
+{
+	_reconnectionGrace = grace;
+}
+
+bool GameThread::reattach(SessionToken token, const sf::IpAddress& address, sf::Uint16 listeningPort)
+{
+	std::lock_guard<std::mutex> lockSessions{_sessionsMutex};
+	if(not _running.load() or _reconnectionGrace.count() == 0)
+		return false;
+	for(Session* session : {&_sessionPlayer1, &_sessionPlayer2})
+	{
+		if(session->token != token)
+			continue;
+		// the game connects to the client at its next tick
+		session->isReattaching = true;
+		session->address = address;
+		session->listeningPort = listeningPort;
+		return true;
+	}
+	return false;
+}
+
+bool GameThread::isBot(const Player& player) const
+{
+	return _bot != nullptr and &player == &_player2;
+}
+
 void GameThread::printVerbose(const std::string& message)
 {
 	if (not _verbose)
@@ -60,24 +188,75 @@ void GameThread::printVerbose(const std::string& message)
 		std::cout << "\t" << line << std::endl;  //print each line with indentation
 }
 
+bool GameThread::isVerbose() const
+{
+	return _verbose;
+}
+
 UserId GameThread::playGame(const ClientInformations& player1, const ClientInformations& player2)
 {
-	setSocket(_player1.getSocket(), _specialOutputSocketPlayer1, player1);
-	setSocket(_player2.getSocket(), _specialOutputSocketPlayer2, player2);
+	setSocket(_clientPlayer1.getSocket(), _specialOutputSocketPlayer1, player1);
+	setSocket(_clientPlayer2.getSocket(), _specialOutputSocketPlayer2, player2);
+	return play();
+}
+
+UserId GameThread::playGameAgainstBot(const ClientInformations& player1)
+{
+	assert(_bot != nullptr);
+	setSocket(_clientPlayer1.getSocket(), _specialOutputSocketPlayer1, player1);
+	return play();
+}
+
+UserId GameThread::play()
+{
+	// the whole game can be replayed from the seed (see GameSimulation::replay)
+	printVerbose("seed " + std::to_string(_intGenerator.getSeed()));
 
 	// ask the clients to choose their decks
-	_activePlayer->receiveDeck();
-	_passivePlayer->receiveDeck();
+	receiveDeck(*_activePlayer);
+	receiveDeck(*_passivePlayer);
+
+	// a resumed game goes on from its checkpoint, the bot searches from it too
+	if(isResumed())
+	{
+		load(*_resumedGame);
+		// the journal of the game starts from its checkpoint too
+		_journal.record(JournalRecordType::CHECKPOINT, _player1Id, GameJournal::encodeSnapshot(*_resumedGame));
+		if(_bot != nullptr)
+			_bot->setStartingState(*_resumedGame);
+	}
+
+	// post game data
+	_postGameDataPlayer1.opponentInDaClub = isBot(_player2) ? false : _database.getWithInDaClub(_player2Id);
+	_postGameDataPlayer2.opponentInDaClub = _database.getWithInDaClub(_player1Id);
 
 	// initialize player's data and send "game starting" signal
-	_activePlayer->setUpGame(true);
-	_passivePlayer->setUpGame(false);
+	if(isResumed())
+	{
+		_activePlayer->resumeGame();
+		_passivePlayer->resumeGame();
+	}
+	else
+	{
+		_activePlayer->setUpGame(true);
+		_passivePlayer->setUpGame(false);
+	}
 
 	// start the thread that times out slow players
 	_timerThread = std::thread(&GameThread::makeTimer, this);
 
 	// run and time the game
 	runGame();
+	// the final messages are sent on the sockets of the connectors
+	joinConnectors();
+	// a game suspended by the end of the server is resumed at the next start
+	// (unless it was over already)
+	if(_checkpoints != nullptr and not (isSuspended() and _endGameCause == EndGame::Cause::ENDING_SERVER))
+		_checkpoints->finish(_player1Id, _player2Id);
+	_journal.record(JournalRecordType::GAME_OVER, _player1Id, {_winnerId, static_cast<std::int64_t>(_endGameCause),
+			_player1.getHealth(), _player2.getHealth()});
+	_journal.close();
+	closeSpectators();
 
 	// unlock a random new card
 	CardId earnedCardId{_database.getRandomCardId()};
@@ -90,90 +269,318 @@ UserId GameThread::playGame(const ClientInformations& player1, const ClientInfor
 
 	// send postGameData to database, receive new unlocked achievements
 	AchievementList newAchievementsPlayer1 = _database.newAchievements(_postGameDataPlayer1, _player1Id);
-	AchievementList newAchievementsPlayer2 = _database.newAchievements(_postGameDataPlayer2, _player2Id);
-
-	// send last message to both players
 	sendFinalMessage(_specialOutputSocketPlayer1, _postGameDataPlayer1, earnedCardId, newAchievementsPlayer1);
+	// the bot is not in the database
+	if(isBot(_player2))
+		return _winnerId;
+
+	// send last message to the second player too
+	AchievementList newAchievementsPlayer2 = _database.newAchievements(_postGameDataPlayer2, _player2Id);
 	sendFinalMessage(_specialOutputSocketPlayer2, _postGameDataPlayer2, earnedCardId, newAchievementsPlayer2);
 
 	return _winnerId;
 }
 
-void GameThread::setSocket(sf::TcpSocket& socket, sf::TcpSocket& specialSocket, const ClientInformations& player)
+void GameThread::setSocket(TcpConnection& socket, TcpConnection& specialSocket, const ClientInformations& player)
+{
+	connectSockets(socket, specialSocket, player.socket->getRemoteAddress(), player.listeningPort, sf::Time::Zero);
+}
+
+bool GameThread::connectSockets(TcpConnection& socket, TcpConnection& specialSocket, const sf::IpAddress& address,
+		sf::Uint16 listeningPort, sf::Time timeout)
 {
 	sf::TcpSocket tmpSocket;
-	tmpSocket.connect(player.socket->getRemoteAddress(), player.listeningPort);
+	if(tmpSocket.connect(address, listeningPort, timeout) != sf::Socket::Done)
+	{
+		std::cerr << "Unable to connect to the client of a player\n";
+		return false;
+	}
 	sf::TcpListener listener;
 	listener.listen(sf::Socket::AnyPort);
 	sf::Packet packet;
 	packet << TransferType::NEW_GAME_SERVER_CONNECTION << listener.getLocalPort();
 	tmpSocket.send(packet);
+	sf::SocketSelector selector;
+	selector.add(listener);
+	// the sockets of a previous connection are closed, SFML does not accept on an open socket
+	socket.disconnect();
+	socket.clearQueue();
+	specialSocket.disconnect();
+	specialSocket.clearQueue();
 	// Here, the client connects itself
-	if(listener.accept(socket) != sf::Socket::Done)
+	if(not selector.wait(timeout) or listener.accept(socket) != sf::Socket::Done)
+	{
 		std::cerr << "Error while creating game thread socket\n";
+		return false;
+	}
 	// and the "specialSocket" used to send important data which are
 	// not blocking the main client thread (eg: END_OF_TURN, BOARD_UPDATE, etc.)
-	if(listener.accept(specialSocket) != sf::Socket::Done)
+	if(not selector.wait(timeout) or listener.accept(specialSocket) != sf::Socket::Done)
+	{
 		std::cerr << "Error while creating game thread special socket\n";
+		return false;
+	}
+	// the packets of a tick are gathered before being sent, do not delay them more
+	socket.setNoDelay(true);
+	specialSocket.setNoDelay(true);
+	return true;
+}
+
+void GameThread::receiveDeck(Player& player)
+{
+	if(isBot(player))
+	{
+		if(not isResumed())
+			player.setDeck(Deck());
+		return;
+	}
+	sf::Packet deckPacket;
+	TransferType type;
+	std::string deckName;
+
+	// the data is needed to go further
+	getClient(player).receiveBlocking(deckPacket);
+	deckPacket >> type;
+	if(type != TransferType::GAME_PLAYER_GIVE_DECK_NAMES)
+		throw std::runtime_error("Unable to get player " + std::to_string(player.getId()) + " deck");
+	deckPacket >> deckName;
+
+	// the cards of a resumed game are already known
+	if(not isResumed())
+		player.setDeck(_database.getDeckByName(player.getId(), deckName));
+}
+
+ClientController& GameThread::getClient(const Player& player)
+{
+	return &player == &_player1 ? _clientPlayer1 : _clientPlayer2;
+}
+
+TcpConnection& GameThread::getSpecialSocket(const Player& player)
+{
+	return &player == &_player1 ? _specialOutputSocketPlayer1 : _specialOutputSocketPlayer2;
+}
+
+GameThread::Session& GameThread::getSession(const Player& player)
+{
+	return &player == &_player1 ? _sessionPlayer1 : _sessionPlayer2;
+}
+
+void GameThread::detach(Player& player)
+{
+	if(_reconnectionGrace.count() == 0)
+	{
+		loseConnection(player);
+		return;
+	}
+	Session& session(getSession(player));
+	session.isDetached = true;
+	session.deadline = std::chrono::steady_clock::now() + _reconnectionGrace;
+	// the client is sent the whole state when it reconnects
+	getClient(player).getSocket().clearQueue();
+	getSpecialSocket(player).clearQueue();
+	pauseTimer(true);
+}
+
+bool GameThread::updateSession(Player& player)
+{
+	Session& session(getSession(player));
+	// the game goes on while the connector runs (paused, as the player is detached)
+	if(session.connector.joinable() and not session.isConnecting.load())
+	{
+		session.connector.join();
+		if(session.isConnected)
+		{
+			session.isDetached = false;
+			const Player& otherPlayer{&player == &_player1 ? _player2 : _player1};
+			if(isBot(otherPlayer) or not getSession(otherPlayer).isDetached)
+				pauseTimer(false);
+			// the changes that were not sent are in the state anyway
+			if(player.thereAreBoardChanges())
+				player.getBoardChanges();
+			player.resumeGame();
+			sf::Packet token;
+			token << TransferType::GAME_SESSION_TOKEN << session.token;
+			getSpecialSocket(player).queue(token);
+			std::cout << "A player reconnected to its game\n";
+		}
+	}
+	// a new reattach waits for the running connector
+	bool isReattaching{false};
+	sf::IpAddress address;
+	sf::Uint16 listeningPort;
+	if(not session.connector.joinable())
+	{
+		std::lock_guard<std::mutex> lockSessions{_sessionsMutex};
+		isReattaching = session.isReattaching;
+		address = session.address;
+		listeningPort = session.listeningPort;
+		session.isReattaching = false;
+	}
+	if(isReattaching)
+	{
+		// the client has given up its previous connection, and the game
+		// does not use the sockets while the connector does
+		if(not session.isDetached)
+			detach(player);
+		session.isConnecting.store(true);
+		session.connector = std::thread(&GameThread::connectSession, this, std::ref(player), address, listeningPort);
+	}
+	if(session.isDetached and std::chrono::steady_clock::now() > session.deadline)
+	{
+		std::cerr << "A player did not reconnect to its game in time\n";
+		loseConnection(player);
+	}
+	return not session.isDetached;
+}
+
+void GameThread::connectSession(Player& player, sf::IpAddress address, sf::Uint16 listeningPort)
+{
+	// a client that does not answer must not keep the connector for long
+	static const sf::Time connectionTimeout{sf::seconds(5)};
+	Session& session(getSession(player));
+	session.isConnected = connectSockets(getClient(player).getSocket(), getSpecialSocket(player), address, listeningPort, connectionTimeout);
+	session.isConnecting.store(false);
+}
+
+void GameThread::joinConnectors()
+{
+	for(Session* session : {&_sessionPlayer1, &_sessionPlayer2})
+		if(session->connector.joinable())
+			session->connector.join();
+}
+
+bool GameThread::updateSessions()
+{
+	bool isPaused{false};
+	for(Player* player : {&_player1, &_player2})
+		if(not isBot(*player) and _running.load() and not updateSession(*player))
+			isPaused = true;
+	return isPaused;
+}
+
+void GameThread::pauseTimer(bool paused)
+{
+	if(_isTimerPaused.load() == paused)
+		return;
+	// the timer thread does not read the time of the turn while it is paused
+	if(paused)
+	{
+		_pauseStartTime = std::chrono::high_resolution_clock::now();
+		_isTimerPaused.store(true);
+	}
+	else
+	{
+		_startOfTurnTime += std::chrono::high_resolution_clock::now() - _pauseStartTime;
+		_isTimerPaused.store(false);
+	}
 }
 
 void GameThread::runGame()
 {
 	// used to calculate time duration of the game
 	std::chrono::steady_clock::time_point startOfGame = std::chrono::steady_clock::now();
+	_lastStatsPrint = startOfGame;
 
 	// call explicitely enterTurn for the first player because this method
 	// is only called when there is a turn swapping. So first turn is never
-	// **officially** started
-	_activePlayer->enterTurn(1);
+	// **officially** started (a resumed game is already in its turn)
+	if(not isResumed())
+	{
+		_activePlayer->enterTurn(1);
+		saveCheckpoint();
+	}
 	//no need to call leaveTurn for passive Player
 
+	// the clients need their token to reconnect to the game
+	if(_reconnectionGrace.count() > 0)
+		for(auto player : {&_player1, &_player2})
+		{
+			if(isBot(*player))
+				continue;
+			sf::Packet token;
+			token << TransferType::GAME_SESSION_TOKEN << getSession(*player).token;
+			getSpecialSocket(*player).queue(token);
+		}
+
 	while(_running.load())
 	{
-		if (_turnSwap.load())
+		// the state of the game does not change while a client is
+		// disconnected, its player gets it as it was when it reconnects
+		bool isPaused{updateSessions()};
+		if(not _running.load())
+			break;
+
+		if (not isPaused and _turnSwap.load())
 			endTurn();
 
 		for(auto player : {_activePlayer, _passivePlayer})
 		{
-			auto otherPlayer{ player == _activePlayer ? _passivePlayer : _activePlayer };
+			TcpConnection& specialSocket{player == _activePlayer ? *_activeSpecialSocket : *_passiveSpecialSocket};
 
-			sf::TcpSocket& specialSocket{player == _activePlayer ? *_activeSpecialSocket : *_passiveSpecialSocket};
+			if(isBot(*player))
+			{
+				// the search runs on the bot pool, the game does not wait for it
+				PlayerAction action;
+				if(not isPaused and player == _activePlayer and not _turnSwap.load() and _bot->pollAction(_journal, action))
+					player->handleAction(action);
+				// nobody reads the special socket of the bot
+				specialSocket.clearQueue();
+				if(_running.load() == false)
+					break;
+				continue;
+			}
 
-			auto status{player->tryReceiveClientInput()}; // get input
+			// a disconnected client is waited for until it reconnects
+			if(getSession(*player).isDetached)
+				continue;
+
+			// get input, the inputs wait in the socket while the game is paused
+			sf::Packet input;
+			auto status{isPaused ? sf::Socket::NotReady : getClient(*player).getSocket().receive(input)};
+			const auto inputTime = std::chrono::steady_clock::now();
+			if(status == sf::Socket::Done)
+				player->handleClientInput(input);
+			// Send the changes to the client
+			if(status != sf::Socket::Disconnected and status != sf::Socket::Error and player->thereAreBoardChanges())
+			{
+				sf::Packet boardChanges{player->getBoardChanges()};
+				_stats.boardChangeBytes.record(boardChanges.getDataSize());
+				specialSocket.queue(boardChanges);
+			}
+			// everything produced for this player is sent at once
+			if(status != sf::Socket::Disconnected)
+			{
+				// the ticks without anything to send are not measured
+				const bool hasPendingData{getClient(*player).getSocket().hasPendingData() or specialSocket.hasPendingData()};
+				const auto flushTime = std::chrono::steady_clock::now();
+				if(not flushSockets(*player, specialSocket))
+					status = sf::Socket::Disconnected;
+				else if(hasPendingData)
+					_stats.socketSendTime.recordSince(flushTime);
+			}
+			if(status == sf::Socket::Done)
+				_stats.actionToUpdate.recordSince(inputTime);
 			// player has disconnected
 			if(status == sf::Socket::Disconnected)
 			{
 				std::cerr << "Lost connection with a player\n";
-				//winner is the player who's still connected
-				otherPlayer->_postGameData.playerWon = true;
-				player->_postGameData.playerRageQuit = true;
-
-				UserId winnerId = player == _activePlayer ? _passivePlayer->getId() : _activePlayer->getId();
-				endGame(winnerId, EndGame::Cause::LOST_CONNECTION);
-				break;
+				detach(*player);
+				isPaused = true;
 			}
 
 			// error while transmitting
 			if(status == sf::Socket::Error)
 				std::cerr << "Error while transmitting, ignoring block\n";
 
-			// received some valid input from the client
-			else  // if status == sf::Socket::Done or if status == sf::Socket::NotReady
-			{
-				// Send the changes to the client
-				if(player->thereAreBoardChanges())
-				{
-					sf::Packet boardChanges{player->getBoardChanges()};
-					specialSocket.send(boardChanges);
-				}
-			}
-
 			// the game has been won/interrupted
 			if (_running.load() == false)
 				break;
 		}
+		updateSpectators();
+		printStats(false);
 		sf::sleep(sf::milliseconds(50));
 	}
+	printStats(true);
 
 	// calculate duration of the game
 	std::chrono::steady_clock::time_point endOfGame = std::chrono::steady_clock::now();
@@ -183,6 +590,16 @@ void GameThread::runGame()
 	assert((_winnerId != 0) xor (_endGameCause == EndGame::Cause::ENDING_SERVER));
 }
 
+void GameThread::loseConnection(Player& player)
+{
+	_journal.record(JournalRecordType::LOST_CONNECTION, player.getId());
+	Player& otherPlayer{&player == &_player1 ? _player2 : _player1};
+	//winner is the player who's still connected
+	otherPlayer._postGameData.playerWon = true;
+	player._postGameData.playerRageQuit = true;
+	endGame(otherPlayer.getId(), EndGame::Cause::LOST_CONNECTION);
+}
+
 void GameThread::endGame(UserId winnerId, EndGame::Cause cause)
 {
 	std::cout << "Game is asked to end\n";
@@ -199,6 +616,17 @@ void GameThread::interruptGame()
 		endGame(0, EndGame::Cause::ENDING_SERVER);
 }
 
+void GameThread::suspendGame()
+{
+	_suspended.store(true);
+	interruptGame();
+}
+
+bool GameThread::isSuspended() const
+{
+	return _suspended.load();
+}
+
 void GameThread::swapTurns()
 {
 	_turnSwap.store(true);
@@ -213,14 +641,21 @@ void GameThread::swapData()
 
 void GameThread::endTurn()
 {
+	_journal.record(JournalRecordType::TURN_SWAP, _activePlayer->getId());
 	// send to both players their turn swapped
 	sf::Packet endOfTurn;
 	endOfTurn << TransferType::GAME_PLAYER_LEAVE_TURN;
-	_activeSpecialSocket->send(endOfTurn);
+	_activeSpecialSocket->queue(endOfTurn);
 
 	sf::Packet startOfTurn;
 	startOfTurn << TransferType::GAME_PLAYER_ENTER_TURN;
-	_passiveSpecialSocket->send(startOfTurn);
+	_passiveSpecialSocket->queue(startOfTurn);
+
+	// the timer swaps the turns, and the game ends them, a bit late
+	const auto turnDuration = std::chrono::high_resolution_clock::now() - _startOfTurnTime;
+	if(not _isTimerPaused.load() and turnDuration >= _turnTime)
+		_stats.turnTimerDrift.record(static_cast<std::uint64_t>(
+				std::chrono::duration_cast<std::chrono::nanoseconds>(turnDuration - _turnTime).count()));
 
 	_turn++;  // turn counter (for both players)
 	_activePlayer->leaveTurn();
@@ -228,7 +663,11 @@ void GameThread::endTurn()
 	_activePlayer->enterTurn(_turn/2 +1);  // ALWAYS call active player
 
 	_startOfTurnTime = std::chrono::high_resolution_clock::now();
+	// the new turn starts when the timer is resumed
+	if(_isTimerPaused.load())
+		_pauseStartTime = _startOfTurnTime;
 	_turnSwap.store(false);
+	saveCheckpoint();
 }
 
 // Function only called by a new thread
@@ -241,6 +680,10 @@ void GameThread::makeTimer()
 	{
 		std::this_thread::sleep_for(sleepingTime);
 
+		// the turn does not time out while a client is disconnected
+		if(_isTimerPaused.load())
+			continue;
+
 		// if the current player didn't finished his turn and he still has got time to play, wait
 		if(!_turnSwap.load() && std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - _startOfTurnTime) < _turnTime)
 			continue;
@@ -249,7 +692,74 @@ void GameThread::makeTimer()
 	}
 }
 
-void GameThread::sendFinalMessage(sf::TcpSocket& specialSocket, PostGameData& postGameData, CardId earnedCardId, AchievementList& newAchievements)
+void GameThread::save(GameSnapshot& snapshot) const
+{
+	Player::saveGame(_player1, _player2, snapshot);
+	snapshot.activePlayer = _activePlayer == &_player1 ? 0 : 1;
+	snapshot.turn = _turn;
+	snapshot.running = _running.load();
+	snapshot.turnSwap = _turnSwap.load();
+	snapshot.winnerId = _winnerId;
+	snapshot.endGameCause = _endGameCause;
+	snapshot.generator = _intGenerator;
+}
+
+void GameThread::load(const GameSnapshot& snapshot)
+{
+	Player::loadGame(_player1, _player2, snapshot);
+	_activePlayer = &_player1;
+	_passivePlayer = &_player2;
+	_activeSpecialSocket = &_specialOutputSocketPlayer1;
+	_passiveSpecialSocket = &_specialOutputSocketPlayer2;
+	if(snapshot.activePlayer != 0)
+		swapData();
+	_turn = snapshot.turn;
+	_turnSwap.store(snapshot.turnSwap);
+	_intGenerator = snapshot.generator;
+	// the end of the game is kept: the server may be ending meanwhile
+}
+
+void GameThread::saveCheckpoint()
+{
+	// the turn has just begun, no card awaits a selection
+	if(_checkpoints == nullptr or not _running.load())
+		return;
+	GameSnapshot snapshot;
+	try
+	{
+		save(snapshot);
+	}
+	catch(const std::runtime_error& e)
+	{
+		// an older state must not be resumed
+		std::cerr << "The game is not saved anymore: " << e.what() << "\n";
+		_checkpoints->finish(_player1Id, _player2Id);
+		return;
+	}
+	_checkpoints->save(snapshot);
+}
+
+void GameThread::printStats(bool force)
+{
+	const auto now = std::chrono::steady_clock::now();
+	if(_statsInterval.count() == 0 or (not force and now - _lastStatsPrint < _statsInterval))
+		return;
+	_lastStatsPrint = now;
+	std::cout << _stats.display("game " + std::to_string(_player1Id) + "-" + std::to_string(_player2Id) + " ");
+}
+
+bool GameThread::flushSockets(Player& player, TcpConnection& specialSocket)
+{
+	for(TcpConnection* socket : {&getClient(player).getSocket(), &specialSocket})
+	{
+		const sf::Socket::Status status{socket->flush()};
+		if(status == sf::Socket::Disconnected or status == sf::Socket::Error or socket->isOverloaded())
+			return false;
+	}
+	return true;
+}
+
+void GameThread::sendFinalMessage(TcpConnection& specialSocket, PostGameData& postGameData, CardId earnedCardId, AchievementList& newAchievements)
 {
 	sf::Packet packet;
 
@@ -258,7 +768,103 @@ void GameThread::sendFinalMessage(sf::TcpSocket& specialSocket, PostGameData& po
 		packet << TransferType::GAME_OVER << EndGame{_endGameCause, false} << earnedCardId << newAchievements;
 	else // if player lost : send message + new achievements
 		packet << TransferType::GAME_OVER << EndGame{_endGameCause, true} << newAchievements;
-	specialSocket.send(packet);
+	// this is the last message, wait for the data of the previous ticks to be
+	// sent too, but not for a client that does not read them
+	static const sf::Time finalMessageTimeout{sf::seconds(2)};
+	specialSocket.queue(packet);
+	if(specialSocket.flushAll(finalMessageTimeout) != sf::Socket::Done)
+		printVerbose("Unable to send the end of the game to a player");
+}
+
+/// \return True if \a frame holds the data of \a packet (see TcpConnection::makeFrame)
+static bool isFrameOf(const std::vector<char>& frame, const sf::Packet& packet)
+{
+	const std::size_t headerSize{sizeof(sf::Uint32)};
+	return frame.size() == headerSize + packet.getDataSize()
+	       and std::memcmp(frame.data() + headerSize, packet.getData(), packet.getDataSize()) == 0;
+}
+
+void GameThread::adoptSpectators()
+{
+	std::lock_guard<std::mutex> lockSpectators{_spectatorsMutex};
+	const auto now = std::chrono::steady_clock::now();
+	for(auto& socket : _newSpectators)
+		_spectators.push_back({std::move(socket), now});
+	_newSpectators.clear();
+	_spectatorsCount = _spectators.size();
+}
+
+void GameThread::updateSpectators()
+{
+	const std::size_t previousCount{_spectators.size()};
+	adoptSpectators();
+	if(_spectators.empty())
+		return;
+	sf::Packet state;
+	state << TransferType::GAME_STATE << _activePlayer->getId() << static_cast<sf::Uint32>(_turn);
+	_player1.appendPublicState(state);
+	_player2.appendPublicState(state);
+	// the state is framed once, the queues of all the spectators share it
+	const bool hasChanged{_stateFrame == nullptr or not isFrameOf(*_stateFrame, state)};
+	if(hasChanged)
+		_stateFrame = TcpConnection::makeFrame(state);
+	for(std::size_t i{0}; i < _spectators.size(); ++i)
+	{
+		TcpConnection& socket(*_spectators[i].socket);
+		// each state replaces the previous ones, a late spectator only needs the last one
+		if(hasChanged)
+			socket.dropUnsentFrames();
+		if(hasChanged or i >= previousCount)
+			socket.queue(_stateFrame);
+	}
+	flushSpectators();
+}
+
+void GameThread::flushSpectators()
+{
+	const auto now = std::chrono::steady_clock::now();
+	for(std::size_t i{0}; i < _spectators.size();)
+	{
+		Spectator& spectator(_spectators[i]);
+		sf::Socket::Status status{sf::Socket::Done};
+		if(spectator.socket->hasPendingData())
+			status = spectator.socket->flush();
+		if(not spectator.socket->hasPendingData())
+			spectator.lastCaughtUp = now;
+		if(status == sf::Socket::Disconnected or status == sf::Socket::Error
+		   or now - spectator.lastCaughtUp > _spectatorTimeout)
+		{
+			// the order of the spectators does not matter
+			std::swap(spectator, _spectators.back());
+			_spectators.pop_back();
+		}
+		else
+			++i;
+	}
+	std::lock_guard<std::mutex> lockSpectators{_spectatorsMutex};
+	_spectatorsCount = _spectators.size();
+}
+
+void GameThread::closeSpectators()
+{
+	{
+		std::lock_guard<std::mutex> lockSpectators{_spectatorsMutex};
+		_isSpectatingOver = true;
+	}
+	// the last spectators get the final state too
+	updateSpectators();
+	sf::Packet gameOver;
+	gameOver << TransferType::GAME_OVER << _winnerId << static_cast<sf::Int32>(_endGameCause);
+	const TcpConnection::Frame gameOverFrame{TcpConnection::makeFrame(gameOver)};
+	for(Spectator& spectator : _spectators)
+	{
+		spectator.socket->queue(gameOverFrame);
+		// do not wait for the late spectators, their connection is closed anyway
+		spectator.socket->flush();
+	}
+	_spectators.clear();
+	std::lock_guard<std::mutex> lockSpectators{_spectatorsMutex};
+	_spectatorsCount = 0;
 }
 
 GameThread::~GameThread()
@@ -266,4 +872,5 @@ GameThread::~GameThread()
 	interruptGame();
 	if(_timerThread.joinable())
 		_timerThread.join();
+	joinConnectors();
 }
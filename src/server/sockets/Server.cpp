@@ -8,11 +8,18 @@
 #include "server/ErrorCode.hpp"
 #include "common/sockets/TransferType.hpp"
 #include "common/sockets/PacketOverload.hpp"
+#include "server/BotController.hpp"
+#include "server/Player.hpp"
+#include "common/Database.hpp"
 // std-C++ headers
 #include <iostream>
 #include <algorithm>
+#include <random>
+#include <vector>
+#include <utility>
 
-Server::Server():
+Server::Server(const ServerSettings& settings):
+	_settings(settings),
 	_clients(),
 	_socketSelector(),
 	_done(false),
@@ -20,8 +27,17 @@ Server::Server():
 	_quitThread(),
 	_waitingPlayer(),
 	_isAPlayerWaiting(false),
+	_botOpponentTimer(0),
+	_isBotOpponentTimerSet(false),
 	_quitPrompt(":QUIT"),
-	_database()
+	_database(),
+	_presence(),
+	_metrics(),
+	_bots(settings.botOpponentDelay.count() > 0 ? new BotPool(static_cast<unsigned>(settings.botThreadsCount)) : nullptr),
+	_checkpoints(settings.checkpointFile.empty() ? nullptr : new GameCheckpoints(settings.checkpointFile)),
+	_playersWaitingForResume(),
+	_timers(),
+	_pendingConnections()
 {
 }
 
@@ -39,46 +55,164 @@ int Server::start(const sf::Uint16 listenerPort)
 
 	_threadRunning.store(true);
 	sf::sleep(SOCKET_TIME_SLEEP);
+	// the listener is non-blocking so that all incoming connections can be
+	// accepted at once when it is ready
+	listener.setBlocking(false);
 	_socketSelector.add(listener);
+	_timers.scheduleEvery(_settings.heartbeatInterval, [this]()
+	{
+		evictIdleClients();
+	});
+	if(_settings.metricsPort != 0)
+	{
+		if(not _metrics.startExporter(_settings.metricsPort))
+			std::cerr << "Unable to serve the metrics on port " << _settings.metricsPort << ".\n";
+		// the gauges are sampled rather than updated by each operation
+		_timers.scheduleEvery(std::chrono::seconds(1), [this]()
+		{
+			updateGauges();
+		});
+	}
 	while(!_done.load())
 	{
-		// if no socket is ready, wait again
-		if(!_socketSelector.wait(sf::milliseconds(50)))
-			continue;
-		// if listener is ready, then a new connection is incoming
-		if(_socketSelector.isReady(listener))
-			takeConnection(listener);
-		else  // one of the client sockets has received something
+		// the timers are run even if no socket is ready
+		const bool isASocketReady{_socketSelector.wait(sf::milliseconds(50))};
+		_timers.runExpired();
+		if(isASocketReady)
+		{
+			// the logged users are served first, whatever the new connections
+			// do, and before the sockets added below can be taken for ready ones
 			receiveData();
+			// if listener is ready, then a new connection is incoming
+			if(_socketSelector.isReady(listener))
+				takeConnection(listener);
+			// then, the pending connections may have sent (a part of) their first packet
+			advanceHandshakes();
+		}
+		// everything produced by this iteration (timers included) is sent at once
+		flushClients();
 	}
+	_timers.clear();
+	for(auto& pending: _pendingConnections)
+		_socketSelector.remove(*pending.socket);
+	_pendingConnections.clear();
 	return SUCCESS;
 }
 
 void Server::takeConnection(sf::TcpListener& listener)
 {
-	std::unique_ptr<sf::TcpSocket> newClient{new sf::TcpSocket()};
-	// if listener can't accept correctly, free the allocated socket
-	if(listener.accept(*newClient) != sf::Socket::Done)
+	while(true)
 	{
-		std::cout << "Error when trying to accept a new client.\n";
-		return;
+		std::unique_ptr<TcpConnection> newClient{new TcpConnection(_settings.sendQueueLimit)};
+		// if listener can't accept correctly, free the allocated socket
+		const sf::Socket::Status status{listener.accept(*newClient)};
+		if(status == sf::Socket::NotReady)  // all incoming connections are accepted
+			return;
+		if(status != sf::Socket::Done)
+		{
+			std::cout << "Error when trying to accept a new client.\n";
+			return;
+		}
+		// Let the system detect half-open connections, in addition of the
+		// heartbeats (which do not work if the client is stuck but not dead)
+		static constexpr int keepAliveProbes{3};
+		if(not newClient->enableKeepAlive(static_cast<int>(_settings.idleTimeout.count()),
+		                                  static_cast<int>(_settings.heartbeatInterval.count()), keepAliveProbes))
+			std::cerr << "Unable to enable TCP keepalive on a new client.\n";
+		// The responses are gathered by the send queues, do not delay them more
+		if(not newClient->setNoDelay(true))
+			std::cerr << "Unable to disable Nagle's algorithm on a new client.\n";
+
+		// Do not wait for the first packet here: the socket is handled by the
+		// main loop like the others, until the packet is complete or the deadline
+		// is reached
+		newClient->setBlocking(false);
+		_socketSelector.add(*newClient);
+		const TcpConnection* clientAddress{newClient.get()};
+		const TimerQueue::TimerId deadline{_timers.schedule(_settings.handshakeTimeout, [this, clientAddress]()
+		{
+			dropPendingConnection(clientAddress);
+		})};
+		_pendingConnections.push_back({std::move(newClient), deadline});
 	}
-	// receive username
-	sf::Packet packet;
-	newClient->receive(packet);
+}
+
+std::size_t Server::advanceHandshakes()
+{
+	std::size_t dispatchedCount{0};
+	for(std::size_t i{0}; i < _pendingConnections.size();)
+	{
+		TcpConnection& client(*_pendingConnections[i].socket);
+		if(not _socketSelector.isReady(client))
+		{
+			++i;
+			continue;
+		}
+		// The socket is non-blocking: SFML keeps the bytes of an incomplete
+		// packet and returns Partial or NotReady until it is complete
+		sf::Packet packet;
+		const sf::Socket::Status status{client.receive(packet)};
+		if(status == sf::Socket::Partial or status == sf::Socket::NotReady)
+		{
+			++i;
+			continue;
+		}
+
+		_timers.cancel(_pendingConnections[i].deadline);
+		_socketSelector.remove(client);
+		std::unique_ptr<TcpConnection> socket{std::move(_pendingConnections[i].socket)};
+		_pendingConnections.erase(_pendingConnections.begin() + static_cast<std::ptrdiff_t>(i));
+		if(status == sf::Socket::Done)
+		{
+			dispatchHandshake(packet, std::move(socket));
+			++dispatchedCount;
+		}
+		else
+			std::cerr << "Connection lost before its first packet.\n";
+	}
+	return dispatchedCount;
+}
+
+void Server::dispatchHandshake(sf::Packet& packet, std::unique_ptr<TcpConnection> client)
+{
 	TransferType type;
 	packet >> type;
+	// The rest of the server works with blocking sockets, except the games
+	// that must not wait for their spectators (see GameThread::addSpectator)
+	if(type != TransferType::GAME_SPECTATE)
+		client->setBlocking(true);
+	const auto startTime = std::chrono::steady_clock::now();
+	const auto databaseStartTime = Database::getStepTime();
 	if(type == TransferType::CONNECTION)
-		connectUser(packet, std::move(newClient));
+		connectUser(packet, std::move(client));
 	else if(type == TransferType::REGISTERING)
-		registerUser(packet, std::move(newClient));
+		registerUser(packet, std::move(client));
 	else if(type == TransferType::CHAT_PLAYER_IP)
-		handleChatRequest(packet, std::move(newClient));
+		handleChatRequest(packet, std::move(client));
+	else if(type == TransferType::GAME_SPECTATE)
+		handleSpectateRequest(packet, std::move(client));
+	else if(type == TransferType::GAME_RECONNECT)
+		handleReconnectRequest(packet, std::move(client));
 	else
 		std::cout << "Error: wrong code!" << std::endl;
+	_metrics.recordOperation(type, std::chrono::steady_clock::now() - startTime, Database::getStepTime() - databaseStartTime);
 }
 
-void Server::connectUser(sf::Packet& connectionPacket, std::unique_ptr<sf::TcpSocket> client)
+void Server::dropPendingConnection(const TcpConnection* client)
+{
+	const auto isDropped = [client](const PendingConnection& pending)
+	{
+		return pending.socket.get() == client;
+	};
+	auto it = std::find_if(_pendingConnections.begin(), _pendingConnections.end(), isDropped);
+	if(it == _pendingConnections.end())
+		return;
+	std::cerr << "A new connection did not identify itself in time: connection closed.\n";
+	_socketSelector.remove(*(it->socket));
+	_pendingConnections.erase(it);
+}
+
+void Server::connectUser(sf::Packet& connectionPacket, std::unique_ptr<TcpConnection> client)
 {
 	std::string playerName, password;
 	sf::Uint16 clientPort;
@@ -100,17 +234,31 @@ void Server::connectUser(sf::Packet& connectionPacket, std::unique_ptr<sf::TcpSo
 			throw std::runtime_error(playerName + " gives wrong identifiers when trying to connect.");
 		}
 		std::cout << "New player connected: " << playerName << std::endl;
-		connectionPacket << TransferType::ACKNOWLEDGE;
-		// Send a response,
-		client->send(connectionPacket);
+		// the token must not be guessed, it proves that the other connections
+		// of the client come from him (see handleSpectateRequest)
+		std::random_device device;
+		const SessionToken sessionToken{(static_cast<SessionToken>(device()) << 32) | static_cast<SessionToken>(device())};
+		// the client needs to know how often it must send heartbeats
+		connectionPacket << TransferType::ACKNOWLEDGE << static_cast<sf::Uint32>(_settings.heartbeatInterval.count())
+		                 << sessionToken;
+		// Send a response (with the presence updates below, in a single write),
+		client->queue(connectionPacket);
 		// add this client to the selector so that its receivals are handled properly
 		// (be sure that this line is before the next, otherwise we get a segfault),
 		_socketSelector.add(*client);
 		// ask the database for the ID of the user (may throw, so keep it in
 		// a separate line from the insertion in the map),
 		const UserId id{_database.getUserId(playerName)};
-		// and add the new socket to the clients
-		_clients[playerName] = {std::move(client), clientPort, id};
+		// load the friends list once for the whole session,
+		const FriendsList friends{_database.getFriendsList(id)};
+		// add the new socket to the clients
+		TcpConnection& socket(*client);
+		_clients[playerName] = {std::move(client), clientPort, id, sessionToken, std::chrono::steady_clock::now()};
+		// and finally tell the user which friends are here, and tell them he is here
+		const std::vector<std::string> onlineFriends{_presence.connect(id, playerName, friends)};
+		for(const auto& friendName: onlineFriends)
+			sendPresence(socket, friendName, true);
+		notifyPresence(onlineFriends, playerName, true);
 	}
 	catch(const std::runtime_error& e)
 	{
@@ -154,28 +302,43 @@ void Server::registerUser(sf::Packet& registeringPacket, std::unique_ptr<sf::Tcp
 
 void Server::receiveData()
 {
-	// first find which socket it is
-	auto it = std::find_if(_clients.begin(), _clients.end(), [this](const auto& pair)
+	// the handlers may remove clients (a game takes its players), so the
+	// ready ones are listed first
+	std::vector<std::pair<std::string, const TcpConnection*>> readyClients;
+	for(const auto& pair : _clients)
+		if(_socketSelector.isReady(*pair.second.socket))
+			readyClients.emplace_back(pair.first, pair.second.socket.get());
+	for(const auto& readyClient : readyClients)
 	{
-		return _socketSelector.isReady(*(pair.second.socket));
-	});
-	if(it == _clients.end())
-	{
-		std::cerr << "Unable to find which socket is ready" << std::endl;
-		return;
+		const auto it = _clients.find(readyClient.first);
+		if(it != _clients.end() and it->second.socket.get() == readyClient.second)
+			receiveData(it);
 	}
+}
 
+void Server::receiveData(const _iterator& it)
+{
 	sf::Packet packet;
 	sf::TcpSocket& client(*(it->second.socket));
+	const auto receiveStartTime = std::chrono::steady_clock::now();
 	sf::Socket::Status receivalStatus = client.receive(packet);
-	std::cout << "Data received from " + userToString(it) + "\n";
+	_metrics.recordReceive(receiveStartTime, receivalStatus == sf::Socket::Done);
 
 	if(receivalStatus == sf::Socket::Done)
 	{
+		it->second.lastActivity = std::chrono::steady_clock::now();
 		TransferType type;
 		packet >> type;
+		const auto startTime = it->second.lastActivity;
+		const auto databaseStartTime = Database::getStepTime();
+		// do not flood the output with the heartbeats
+		if(type != TransferType::HEARTBEAT)
+			std::cout << "Data received from " + userToString(it) + "\n";
 		switch(type)
 		{
+		case TransferType::HEARTBEAT:
+			// nothing to do: receiving it is enough to know the client is alive
+			break;
 		case TransferType::DISCONNECTION:
 			std::cout << "Player " + userToString(it) + " quits the game!" << std::endl;
 			removeClient(it);
@@ -233,6 +396,7 @@ void Server::receiveData()
 			std::cerr << "Error: unknown code " << static_cast<sf::Uint32>(type) << std::endl;
 			break;
 		}
+		_metrics.recordOperation(type, std::chrono::steady_clock::now() - startTime, Database::getStepTime() - databaseStartTime);
 	}
 	else if(receivalStatus == sf::Socket::Disconnected)
 	{
@@ -245,30 +409,114 @@ void Server::receiveData()
 
 void Server::removeClient(const _iterator& it)
 {
+	// his game can still be resumed if he comes back
+	{
+		std::lock_guard<std::mutex> lockLobby{_lobbyMutex};
+		_playersWaitingForResume.erase(it->second.id);
+	}
+	// tell the friends that the user left
+	notifyPresence(_presence.disconnect(it->second.id), it->first, false);
 	// remove from the selector so it won't receive data anymore
 	_socketSelector.remove(*(it->second.socket));
 	// remove from the map
 	_clients.erase(it);
 }
 
+void Server::flushClients()
+{
+	const auto startTime = std::chrono::steady_clock::now();
+	bool hasSent{false};
+	auto it = _clients.begin();
+	while(it != _clients.end())
+	{
+		// removeClient invalidates the iterator, so take the next one before
+		auto current = it++;
+		TcpConnection& client(*(current->second.socket));
+		if(not client.hasPendingData())
+			continue;
+		hasSent = true;
+		const sf::Socket::Status status{client.flush()};
+		if(status == sf::Socket::Disconnected or status == sf::Socket::Error)
+		{
+			std::cerr << "Unable to send data to player " + userToString(current) + ": forced disconnection from server.\n";
+			removeClient(current);
+		}
+		else if(client.isOverloaded())
+		{
+			std::cerr << "Player " + userToString(current) + " does not read its data: forced disconnection from server.\n";
+			removeClient(current);
+		}
+	}
+	// the loops without anything to send are not measured
+	if(hasSent)
+		_metrics.recordSend(startTime);
+}
+
+void Server::evictIdleClients()
+{
+	const auto now = std::chrono::steady_clock::now();
+	auto it = _clients.begin();
+	while(it != _clients.end())
+	{
+		// removeClient invalidates the iterator, so take the next one before
+		auto current = it++;
+		if(now - current->second.lastActivity > _settings.idleTimeout)
+		{
+			std::cerr << "Player " + userToString(current) + " is idle for too long: forced disconnection from server.\n";
+			removeClient(current);
+		}
+	}
+}
+
+void Server::updateGauges()
+{
+	_metrics.connectedClients.store(_clients.size());
+	_metrics.pendingHandshakes.store(_pendingConnections.size());
+	std::lock_guard<std::mutex> lockLobby{_lobbyMutex};
+	_metrics.lobbyDepth.store((_isAPlayerWaiting ? 1 : 0) + _playersWaitingForResume.size());
+}
+
 void Server::checkPresence(const _iterator& it, sf::Packet& transmission)
 {
 	sf::Packet packet;
 	std::string nameToCheck;
 	transmission >> nameToCheck;
-	if(_database.areFriend(it->second.id, _clients[nameToCheck].id))
-		packet << TransferType::ACKNOWLEDGE << (_clients.find(nameToCheck) != _clients.end());
+	// Only the in-memory friends graph is used: if the checked user is not
+	// connected, asking the database whether they are friends is not needed
+	// since the answer is "not present" in both cases
+	const auto checked = _clients.find(nameToCheck);
+	if(checked == _clients.end())
+		packet << TransferType::ACKNOWLEDGE << false;
+	else if(_presence.areFriend(it->second.id, checked->second.id))
+		packet << TransferType::ACKNOWLEDGE << true;
 	else
 		packet << TransferType::FAILURE;
-	it->second.socket->send(packet);
+	it->second.socket->queue(packet);
+}
+
+void Server::notifyPresence(const std::vector<std::string>& subscribers, const std::string& name, bool isOnline)
+{
+	for(const auto& subscriberName: subscribers)
+	{
+		auto subscriber = _clients.find(subscriberName);
+		if(subscriber != _clients.end())
+			sendPresence(*(subscriber->second.socket), name, isOnline);
+	}
+}
+
+void Server::sendPresence(TcpConnection& client, const std::string& name, bool isOnline)
+{
+	sf::Packet packet;
+	packet << TransferType::FRIEND_PRESENCE_UPDATE << name << isOnline;
+	client.queue(packet);
 }
 
 void Server::quit()
 {
-	// End game threads
+	// End game threads, their games are resumed at the next start
 	for(auto& gameThread: _runningGames)
 	{
-		gameThread->interruptGame();
+		gameThread->suspendGame();
 		// Avoid to throw an exception if not joinable, just in case
 		if(gameThread->joinable())
 			gameThread->join();
@@ -312,6 +560,9 @@ std::string Server::userToString(const _iterator& it)
 void Server::findOpponent(const _iterator& it)
 {
 	std::lock_guard<std::mutex> lockLobby{_lobbyMutex};
+	if(resumeGame(it))
+		return;
+	cancelBotOpponentTimer();
 	if(!_isAPlayerWaiting)
 	{
 		_isAPlayerWaiting = true;
@@ -326,26 +577,123 @@ void Server::findOpponent(const _iterator& it)
 		else
 		{
 			sf::Packet toFirst, toSecond;
-			toFirst << it->first;
-			toSecond << _waitingPlayer;
-			it->second.socket->send(toSecond);
-			waitingPlayer->second.socket->send(toFirst);
+			// The header allows the client to tell this answer apart from
+			// the notifications pushed by the server (e.g. presence updates)
+			toFirst << TransferType::ACKNOWLEDGE << it->first;
+			toSecond << TransferType::ACKNOWLEDGE << _waitingPlayer;
+			it->second.socket->queue(toSecond);
+			waitingPlayer->second.socket->queue(toFirst);
 			_isAPlayerWaiting = false;
 			createGame(waitingPlayer->second.id, it->second.id);
 		}
 	}
+	// if nobody comes in time, the new waiting player plays against a bot
+	if(_isAPlayerWaiting and _bots != nullptr)
+	{
+		const std::string playerName{_waitingPlayer};
+		_botOpponentTimer = _timers.schedule(_settings.botOpponentDelay, [this, playerName]()
+		{
+			matchWithBot(playerName);
+		});
+		_isBotOpponentTimerSet = true;
+	}
 	// _lobbyMutex is unlocked when lockLobby is destructed
 }
 
 void Server::clearLobby(const _iterator& it)
 {
 	std::lock_guard<std::mutex> lockLobby{_lobbyMutex};
+	// a player who gives up his game to resume ends it for both players
+	if(_playersWaitingForResume.erase(it->second.id) > 0)
+	{
+		_checkpoints->abandonGame(it->second.id);
+		return;
+	}
 	if(not _isAPlayerWaiting or _waitingPlayer != it->first)
 		throw std::runtime_error("Trying to remove another player from lobby; ignored\n");
 	_isAPlayerWaiting = false;
+	cancelBotOpponentTimer();
+	// _lobbyMutex is unlocked when lockLobby is destructed
+}
+
+void Server::matchWithBot(const std::string& playerName)
+{
+	std::lock_guard<std::mutex> lockLobby{_lobbyMutex};
+	_isBotOpponentTimerSet = false;
+	if(not _isAPlayerWaiting or _waitingPlayer != playerName)
+		return;
+	const auto& waitingPlayer = _clients.find(_waitingPlayer);
+	if(waitingPlayer == _clients.end())
+		return;
+	sf::Packet toPlayer;
+	toPlayer << TransferType::ACKNOWLEDGE << BotController::botName;
+	waitingPlayer->second.socket->queue(toPlayer);
+	_isAPlayerWaiting = false;
+	createBotGame(waitingPlayer->second.id);
 	// _lobbyMutex is unlocked when lockLobby is destructed
 }
 
+bool Server::resumeGame(const _iterator& it)
+{
+	GameSnapshot snapshot;
+	if(_checkpoints == nullptr or not _checkpoints->findGame(it->second.id, snapshot))
+		return false;
+	// a checkpoint that can't be loaded (e.g. written with another database) is dropped
+	try
+	{
+		Player::checkSnapshot(_database, snapshot);
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << "The game of " << it->first << " can't be resumed: " << e.what() << "\n";
+		_checkpoints->abandonGame(it->second.id);
+		return false;
+	}
+	const UserId opponentId{snapshot.players[0].id == it->second.id ? snapshot.players[1].id : snapshot.players[0].id};
+	std::string opponentName;
+	if(opponentId == BotController::botId)
+	{
+		// the game is lost if the bots are not enabled anymore
+		if(_bots == nullptr)
+		{
+			_checkpoints->abandonGame(it->second.id);
+			return false;
+		}
+		opponentName = BotController::botName;
+	}
+	else
+	{
+		const auto opponent = _playersWaitingForResume.find(opponentId);
+		// the opponent must be connected and looking for a game too
+		if(opponent == _playersWaitingForResume.end() or _clients.find(opponent->second) == _clients.end())
+		{
+			std::cout << it->first << " waits for his opponent to resume their game\n";
+			_playersWaitingForResume[it->second.id] = it->first;
+			return true;
+		}
+		opponentName = opponent->second;
+		_playersWaitingForResume.erase(opponent);
+		sf::Packet toOpponent;
+		toOpponent << TransferType::ACKNOWLEDGE << it->first;
+		_clients.at(opponentName).socket->queue(toOpponent);
+	}
+	sf::Packet toPlayer;
+	toPlayer << TransferType::ACKNOWLEDGE << opponentName;
+	it->second.socket->queue(toPlayer);
+	std::cout << it->first << " and " << opponentName << " resume their game at turn " << snapshot.turn << "\n";
+	_checkpoints->takeGame(it->second.id, snapshot);
+	createResumedGame(snapshot);
+	return true;
+}
+
+void Server::cancelBotOpponentTimer()
+{
+	if(not _isBotOpponentTimerSet)
+		return;
+	_timers.cancel(_botOpponentTimer);
+	_isBotOpponentTimerSet = false;
+}
+
 void Server::startGame(std::size_t idx)
 {
 	// A unique lock also releases the mutex at destruction (just like
@@ -368,23 +716,39 @@ void Server::startGame(std::size_t idx)
 
 	const auto& player1{std::find_if(_clients.begin(), _clients.end(), finderById(player1Id))};
 	const auto& player2{std::find_if(_clients.begin(), _clients.end(), finderById(player2Id))};
+	const bool isAgainstBot{selfThread->hasBotOpponent()};
 
 	std::string player1Name = userToString(player1);
-	std::string player2Name = userToString(player2);
+	std::string player2Name = isAgainstBot ? BotController::botName : userToString(player2);
 
 	// start the game
-	std::cout << "Game " << idx << " is starting: " + userToString(player1) + " vs. " + userToString(player2) + "\n";
+	std::cout << "Game " << idx << " is starting: " + player1Name + " vs. " + player2Name + "\n";
+	// the journal of a resumed game starts from its checkpoint
+	if(not _settings.journalDirectory.empty())
+		selfThread->openJournal(_settings.journalDirectory);
 	UserId winnerId;
+	++_metrics.runningGames;
 	try
 	{
-		winnerId = selfThread->playGame(player1->second, player2->second);
+		if(isAgainstBot)
+			winnerId = selfThread->playGameAgainstBot(player1->second);
+		else
+			winnerId = selfThread->playGame(player1->second, player2->second);
 		assert((winnerId == player1Id) xor (winnerId == player2Id) xor (winnerId == 0));
 	}
 	catch(std::runtime_error& e)
 	{
+		--_metrics.runningGames;
 		std::cerr << "Game " << idx << " aborted:\n\t" << e.what();
+		// the spectators are told that the game is over
+		selfThread->interruptGame();
+		selfThread->closeSpectators();
+		// an aborted game is not resumed, unless it failed because the server ends
+		if(_checkpoints != nullptr and not selfThread->isSuspended())
+			_checkpoints->finish(player1Id, player2Id);
 		return;
 	}
+	--_metrics.runningGames;
 
 	// display which players won, if any
 	if (winnerId == player1Id)
@@ -399,9 +763,101 @@ void Server::createGame(UserId Id1, UserId Id2)
 {
 	std::lock_guard<std::mutex> lockRunningGames{_accessRunningGames};
 	_runningGames.emplace_back(new GameThread(_database, Id1, Id2, &Server::startGame, this, _runningGames.size()));
+	setUpGame(*_runningGames.back());
+	// _accessRunningGames is unlocked when lockRunningGames is destructed
+}
+
+void Server::createBotGame(UserId playerId)
+{
+	std::lock_guard<std::mutex> lockRunningGames{_accessRunningGames};
+	_runningGames.emplace_back(new GameThread(_database, playerId, BotController::botId, &Server::startGame, this, _runningGames.size()));
+	// startGame waits for _accessRunningGames, so the bot is set before the game starts
+	_runningGames.back()->setBotOpponent(*_bots, _settings.botMoveBudget);
+	setUpGame(*_runningGames.back());
 	// _accessRunningGames is unlocked when lockRunningGames is destructed
 }
 
+void Server::createResumedGame(const GameSnapshot& snapshot)
+{
+	std::lock_guard<std::mutex> lockRunningGames{_accessRunningGames};
+	_runningGames.emplace_back(new GameThread(_database, snapshot.players[0].id, snapshot.players[1].id,
+			&Server::startGame, this, _runningGames.size()));
+	// startGame waits for _accessRunningGames, so the game is set before it starts
+	if(snapshot.players[1].id == BotController::botId)
+		_runningGames.back()->setBotOpponent(*_bots, _settings.botMoveBudget);
+	_runningGames.back()->resume(snapshot);
+	setUpGame(*_runningGames.back());
+	// _accessRunningGames is unlocked when lockRunningGames is destructed
+}
+
+void Server::setUpGame(GameThread& game)
+{
+	game.allowSpectators(_settings.maxSpectators, _settings.spectatorTimeout);
+	game.allowReconnection(_settings.reconnectionGrace);
+	game.setStatsInterval(_settings.gameStatsInterval);
+	if(_checkpoints != nullptr)
+		game.setCheckpoints(*_checkpoints);
+}
+
+void Server::handleSpectateRequest(sf::Packet& packet, std::unique_ptr<TcpConnection> client)
+{
+	std::string spectatorName, playerName;
+	SessionToken sessionToken;
+	packet >> spectatorName >> sessionToken >> playerName;
+	// only the connected users can watch the games of the connected players,
+	// the token tells that the spectator is the one connected to the lobby
+	const auto spectator = _clients.find(spectatorName);
+	const auto player = _clients.find(playerName);
+	if(spectator != _clients.end() and spectator->second.sessionToken == sessionToken and player != _clients.end())
+	{
+		std::lock_guard<std::mutex> lockRunningGames{_accessRunningGames};
+		// the last game of the player is the one he may be playing
+		const auto isPlayedBy = [&player](const std::unique_ptr<GameThread>& game)
+		{
+			return game->_player1Id == player->second.id or game->_player2Id == player->second.id;
+		};
+		const auto game = std::find_if(_runningGames.rbegin(), _runningGames.rend(), isPlayedBy);
+		if(game != _runningGames.rend() and (*game)->addSpectator(client))
+		{
+			std::cout << spectatorName << " is watching the game of " << playerName << "\n";
+			return;
+		}
+		// _accessRunningGames is unlocked when lockRunningGames is destructed
+	}
+	std::cout << spectatorName << " is unable to watch the game of " << playerName << "\n";
+	sf::Packet response;
+	response << TransferType::FAILURE;
+	// the socket is non-blocking, the answer is not waited for since the
+	// connection is closed anyway
+	client->queue(response);
+	client->flush();
+}
+
+void Server::handleReconnectRequest(sf::Packet& packet, std::unique_ptr<TcpConnection> client)
+{
+	SessionToken token;
+	sf::Uint16 listeningPort;
+	packet >> token >> listeningPort;
+	bool isReattached{false};
+	{
+		std::lock_guard<std::mutex> lockRunningGames{_accessRunningGames};
+		// the token tells the game and the player
+		for(auto& game : _runningGames)
+			if(game->reattach(token, client->getRemoteAddress(), listeningPort))
+			{
+				isReattached = true;
+				break;
+			}
+		// _accessRunningGames is unlocked when lockRunningGames is destructed
+	}
+	if(not isReattached)
+		std::cout << "A client is unable to reconnect to its game\n";
+	// the game connects to the client, this connection is not used anymore
+	sf::Packet response;
+	response << (isReattached ? TransferType::ACKNOWLEDGE : TransferType::FAILURE);
+	client->send(response);
+}
+
 ///////////////////////// Friends management
 
 void Server::handleChatRequest(sf::Packet& packet, std::unique_ptr<sf::TcpSocket> client)
@@ -464,7 +920,7 @@ void Server::handleFriendshipRequest(const _iterator& it, sf::Packet& transmissi
 		// Send an error to the user
 		response << TransferType::NOT_EXISTING_FRIEND;
 	}
-	it->second.socket->send(response);
+	it->second.socket->queue(response);
 }
 
 void Server::handleFriendshipRequestResponse(const _iterator& it, sf::Packet& transmission)
@@ -483,7 +939,17 @@ void Server::handleFriendshipRequestResponse(const _iterator& it, sf::Packet& tr
 			throw std::runtime_error(userToString(it) + " responded to a friend request of an unexisting player.");
 		}
 		if(accepted)
+		{
 			_database.addFriend(askerId, askedId);
+			_presence.addFriendship(askerId, askedId);
+			// both users may now see each other
+			auto asker = _clients.find(askerName);
+			if(asker != _clients.end())
+			{
+				sendPresence(*(asker->second.socket), it->first, true);
+				sendPresence(*(it->second.socket), askerName, true);
+			}
+		}
 		else
 			_database.removeFriendshipRequest(askerId, askedId);
 
@@ -497,7 +963,7 @@ void Server::handleFriendshipRequestResponse(const _iterator& it, sf::Packet& tr
 			transmission << TransferType::FAILURE;
 		std::cout << "handleFriendshipRequestResponse error: " << e.what() << "\n";
 	}
-	it->second.socket->send(transmission);
+	it->second.socket->queue(transmission);
 }
 
 void Server::sendFriendshipRequests(const _iterator& it)
@@ -518,7 +984,7 @@ void Server::sendFriendshipRequests(const _iterator& it)
 		std::cout << "sendFriendshipRequests error: " << e.what() << "\n";
 		response << TransferType::FAILURE;
 	}
-	it->second.socket->send(response);
+	it->second.socket->queue(response);
 }
 
 void Server::sendFriends(const _iterator& it)
@@ -536,7 +1002,7 @@ void Server::sendFriends(const _iterator& it)
 		std::cout << "sendFriends error: " << e.what() << "\n";
 		response << TransferType::FAILURE;
 	}
-	it->second.socket->send(response);
+	it->second.socket->queue(response);
 }
 
 void Server::handleRemoveFriend(const _iterator& it, sf::Packet& transmission)
@@ -549,6 +1015,11 @@ void Server::handleRemoveFriend(const _iterator& it, sf::Packet& transmission)
 		const UserId unfriendlyUserId{_database.getUserId(it->first)};
 		const UserId removedFriendId{_database.getUserId(removedFriend)};
 		_database.removeFriend(unfriendlyUserId, removedFriendId);
+		_presence.removeFriendship(unfriendlyUserId, removedFriendId);
+		// the removed friend must not see the user as a present friend anymore
+		auto removed = _clients.find(removedFriend);
+		if(removed != _clients.end())
+			sendPresence(*(removed->second.socket), it->first, false);
 
 		// acknowledge to client
 		transmission << TransferType::ACKNOWLEDGE;
@@ -558,7 +1029,7 @@ void Server::handleRemoveFriend(const _iterator& it, sf::Packet& transmission)
 		transmission << TransferType::NOT_EXISTING_FRIEND;
 		std::cout << "handleRemoveFriend error: " << e.what() << "\n";
 	}
-	it->second.socket->send(transmission);
+	it->second.socket->queue(transmission);
 }
 
 // Cards management
@@ -578,7 +1049,7 @@ void Server::sendDecks(const _iterator& it)
 		std::cout << "sendDecks error: " << e.what() << "\n";
 		response << TransferType::FAILURE;
 	}
-	it->second.socket->send(response);
+	it->second.socket->queue(response);
 }
 
 void Server::handleDeckEditing(const _iterator& it, sf::Packet& transmission)
@@ -597,7 +1068,7 @@ void Server::handleDeckEditing(const _iterator& it, sf::Packet& transmission)
 		std::cout << "handleDeckEditing error: " << e.what() << "\n";
 		transmission << TransferType::FAILURE;
 	}
-	it->second.socket->send(transmission);
+	it->second.socket->queue(transmission);
 }
 
 void Server::handleDeckCreation(const _iterator& it, sf::Packet& transmission)
@@ -616,7 +1087,7 @@ void Server::handleDeckCreation(const _iterator& it, sf::Packet& transmission)
 		std::cout << "handleDeckCreation error: " << e.what() << "\n";
 		transmission << TransferType::FAILURE;
 	}
-	it->second.socket->send(transmission);
+	it->second.socket->queue(transmission);
 }
 
 void Server::handleDeckDeletion(const _iterator& it, sf::Packet& transmission)
@@ -635,7 +1106,7 @@ void Server::handleDeckDeletion(const _iterator& it, sf::Packet& transmission)
 		std::cout << "handleDeckCreation error: " << e.what() << "\n";
 		transmission << TransferType::FAILURE;
 	}
-	it->second.socket->send(transmission);
+	it->second.socket->queue(transmission);
 }
 
 void Server::sendCardsCollection(const _iterator& it)
@@ -653,7 +1124,7 @@ void Server::sendCardsCollection(const _iterator& it)
 		std::cout << "sendCardsCollection error: " << e.what() << "\n";
 		response << TransferType::FAILURE;
 	}
-	it->second.socket->send(response);
+	it->second.socket->queue(response);
 }
 
 // Others
@@ -671,7 +1142,7 @@ void Server::sendLadder(const _iterator& it)
 		std::cout << "sendLadder error: " << e.what() << "\n";
 		response << TransferType::FAILURE;
 	}
-	it->second.socket->send(response);
+	it->second.socket->queue(response);
 }
 
 void Server::sendAchievements(const _iterator& it)
@@ -688,5 +1159,5 @@ void Server::sendAchievements(const _iterator& it)
 		std::cout << "sendAchievements error: " << e.what() << "\n";
 		response << TransferType::FAILURE;
 	}
-	it->second.socket->send(response);
+	it->second.socket->queue(response);
 }
@@ -0,0 +1,231 @@
+// WizardPoker headers
+#include "server/ServerMetrics.hpp"
+// SFML headers
+#include <SFML/Network/TcpSocket.hpp>
+#include <SFML/Network/IpAddress.hpp>
+#include <SFML/Network/SocketSelector.hpp>
+// std-C++ headers
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+constexpr std::size_t ServerMetrics::operationsCount;
+
+/// An operation of the lobby, and its name in the metrics
+struct MeasuredOperation
+{
+	TransferType type;
+	const char* name;
+};
+
+/// The operations of the lobby, the last one stands for the unknown packets
+static const MeasuredOperation operations[]{
+	{TransferType::HEARTBEAT, "HEARTBEAT"},
+	{TransferType::DISCONNECTION, "DISCONNECTION"},
+	{TransferType::CHECK_PRESENCE, "CHECK_PRESENCE"},
+	{TransferType::ASK_FRIENDS, "ASK_FRIENDS"},
+	{TransferType::NEW_FRIEND, "NEW_FRIEND"},
+	{TransferType::REMOVE_FRIEND, "REMOVE_FRIEND"},
+	{TransferType::RESPONSE_FRIEND_REQUEST, "RESPONSE_FRIEND_REQUEST"},
+	{TransferType::GET_FRIEND_REQUESTS, "GET_FRIEND_REQUESTS"},
+	{TransferType::GAME_REQUEST, "GAME_REQUEST"},
+	{TransferType::GAME_CANCEL_REQUEST, "GAME_CANCEL_REQUEST"},
+	{TransferType::GAME_SPECTATE, "GAME_SPECTATE"},
+	{TransferType::GAME_RECONNECT, "GAME_RECONNECT"},
+	{TransferType::ASK_DECKS_LIST, "ASK_DECKS_LIST"},
+	{TransferType::EDIT_DECK, "EDIT_DECK"},
+	{TransferType::CREATE_DECK, "CREATE_DECK"},
+	{TransferType::DELETE_DECK, "DELETE_DECK"},
+	{TransferType::ASK_CARDS_COLLECTION, "ASK_CARDS_COLLECTION"},
+	{TransferType::ASK_LADDER, "ASK_LADDER"},
+	{TransferType::ASK_ACHIEVEMENTS, "ASK_ACHIEVEMENTS"},
+	{TransferType::CONNECTION, "CONNECTION"},
+	{TransferType::REGISTERING, "REGISTERING"},
+	{TransferType::CHAT_PLAYER_IP, "CHAT_PLAYER_IP"},
+	{TransferType::FAILURE, "UNKNOWN"},
+};
+
+static_assert(sizeof(operations) / sizeof(operations[0]) == ServerMetrics::operationsCount,
+		"Each measured operation must have a name");
+
+/// Upper bounds of the buckets of the exported histograms, in seconds
+static const double exportedBounds[]{0.00001, 0.000025, 0.00005, 0.0001, 0.00025, 0.0005, 0.001, 0.0025,
+		0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1., 2.5, 5., 10.};
+
+/// \return The index of \a type in operations, the unknown operation if it is not measured
+static std::size_t findOperation(TransferType type)
+{
+	std::size_t index{0};
+	while(index < ServerMetrics::operationsCount - 1 and operations[index].type != type)
+		++index;
+	return index;
+}
+
+/// Adds one to a counter that a single thread writes
+static void increment(std::atomic<std::uint64_t>& counter)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/// Writes the header of a metric
+static void displayHeader(std::ostream& stream, const std::string& name, const char* type, const char* help)
+{
+	stream << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+}
+
+/// Writes \a histogram of nanoseconds as a Prometheus histogram of seconds
+/// \param labels The labels of the metric, separated by commas
+static void displayHistogram(std::ostream& stream, const std::string& name, const std::string& labels,
+		const Histogram& histogram)
+{
+	const std::string separator{labels.empty() ? "" : ","};
+	// the buckets of the histogram are summed up to the exported bounds, a
+	// bucket that spans a bound is counted in the next one
+	std::uint64_t cumulatedCount{0};
+	std::size_t bucket{0};
+	for(double bound : exportedBounds)
+	{
+		const std::uint64_t boundNanoseconds{static_cast<std::uint64_t>(bound * 1e9)};
+		for(; bucket < Histogram::bucketsCount and Histogram::getBucketUpperBound(bucket) <= boundNanoseconds; ++bucket)
+			cumulatedCount += histogram.getBucketCount(bucket);
+		stream << name << "_bucket{" << labels << separator << "le=\"" << bound << "\"} " << cumulatedCount << "\n";
+	}
+	// the total is the sum of the buckets, so that it is consistent with
+	// them even if a value is being recorded
+	for(; bucket < Histogram::bucketsCount; ++bucket)
+		cumulatedCount += histogram.getBucketCount(bucket);
+	stream << name << "_bucket{" << labels << separator << "le=\"+Inf\"} " << cumulatedCount << "\n";
+	stream << name << "_sum" << (labels.empty() ? "" : "{" + labels + "}") << " "
+	       << static_cast<double>(histogram.getSum()) / 1e9 << "\n";
+	stream << name << "_count" << (labels.empty() ? "" : "{" + labels + "}") << " " << cumulatedCount << "\n";
+}
+
+ServerMetrics::ServerMetrics():
+	connectedClients{0},
+	lobbyDepth{0},
+	pendingHandshakes{0},
+	runningGames{0},
+	_requests(),
+	_durations(),
+	_databaseTimes(),
+	_receiveErrors{0},
+	_receiveTimes(),
+	_sendTimes(),
+	_listener(),
+	_stopping{false},
+	_exporter()
+{
+}
+
+bool ServerMetrics::startExporter(sf::Uint16 port)
+{
+	if(_listener.listen(port, sf::IpAddress::LocalHost) != sf::Socket::Done)
+		return false;
+	_exporter = std::thread(&ServerMetrics::serve, this);
+	return true;
+}
+
+void ServerMetrics::recordOperation(TransferType type, std::chrono::nanoseconds duration, std::chrono::nanoseconds databaseTime)
+{
+	const std::size_t index{findOperation(type)};
+	increment(_requests[index]);
+	_durations[index].record(static_cast<std::uint64_t>(std::max<std::int64_t>(0, duration.count())));
+	_databaseTimes[index].record(static_cast<std::uint64_t>(std::max<std::int64_t>(0, databaseTime.count())));
+}
+
+void ServerMetrics::recordReceive(std::chrono::steady_clock::time_point start, bool isDone)
+{
+	if(isDone)
+		_receiveTimes.recordSince(start);
+	else
+		increment(_receiveErrors);
+}
+
+void ServerMetrics::recordSend(std::chrono::steady_clock::time_point start)
+{
+	_sendTimes.recordSince(start);
+}
+
+std::string ServerMetrics::display() const
+{
+	std::ostringstream stream;
+	stream.precision(9);
+
+	displayHeader(stream, "wizardpoker_lobby_requests_total", "counter", "Operations handled by the lobby.");
+	for(std::size_t i{0}; i < operationsCount; ++i)
+		stream << "wizardpoker_lobby_requests_total{operation=\"" << operations[i].name << "\"} "
+		       << _requests[i].load(std::memory_order_relaxed) << "\n";
+
+	// the operations that never happened are not exported, most clients never send some of them
+	displayHeader(stream, "wizardpoker_lobby_request_duration_seconds", "histogram",
+			"Time taken by the lobby to handle an operation, database included.");
+	for(std::size_t i{0}; i < operationsCount; ++i)
+		if(_requests[i].load(std::memory_order_relaxed) > 0)
+			displayHistogram(stream, "wizardpoker_lobby_request_duration_seconds",
+					std::string("operation=\"") + operations[i].name + "\"", _durations[i]);
+
+	displayHeader(stream, "wizardpoker_lobby_database_duration_seconds", "histogram",
+			"Time spent in the database to handle an operation.");
+	for(std::size_t i{0}; i < operationsCount; ++i)
+		if(_requests[i].load(std::memory_order_relaxed) > 0)
+			displayHistogram(stream, "wizardpoker_lobby_database_duration_seconds",
+					std::string("operation=\"") + operations[i].name + "\"", _databaseTimes[i]);
+
+	displayHeader(stream, "wizardpoker_lobby_receive_duration_seconds", "histogram",
+			"Time taken to receive the packet of an operation.");
+	displayHistogram(stream, "wizardpoker_lobby_receive_duration_seconds", "", _receiveTimes);
+	displayHeader(stream, "wizardpoker_lobby_receive_errors_total", "counter",
+			"Packets of the clients that could not be received.");
+	stream << "wizardpoker_lobby_receive_errors_total " << _receiveErrors.load(std::memory_order_relaxed) << "\n";
+	displayHeader(stream, "wizardpoker_lobby_send_duration_seconds", "histogram",
+			"Time taken to send what a loop of the server produced.");
+	displayHistogram(stream, "wizardpoker_lobby_send_duration_seconds", "", _sendTimes);
+
+	displayHeader(stream, "wizardpoker_connected_clients", "gauge", "Connected clients.");
+	stream << "wizardpoker_connected_clients " << connectedClients.load() << "\n";
+	displayHeader(stream, "wizardpoker_lobby_depth", "gauge", "Players waiting for an opponent.");
+	stream << "wizardpoker_lobby_depth " << lobbyDepth.load() << "\n";
+	displayHeader(stream, "wizardpoker_pending_handshakes", "gauge", "Connections that did not identify themselves yet.");
+	stream << "wizardpoker_pending_handshakes " << pendingHandshakes.load() << "\n";
+	displayHeader(stream, "wizardpoker_running_games", "gauge", "Games being played.");
+	stream << "wizardpoker_running_games " << runningGames.load() << "\n";
+	return stream.str();
+}
+
+ServerMetrics::~ServerMetrics()
+{
+	_stopping.store(true);
+	if(_exporter.joinable())
+		_exporter.join();
+}
+
+void ServerMetrics::serve()
+{
+	// the selectors wake up regularly so that the thread can be stopped
+	static const sf::Time pollingTime{sf::milliseconds(200)};
+	static const sf::Time requestTimeout{sf::seconds(1)};
+	sf::SocketSelector listenerSelector;
+	listenerSelector.add(_listener);
+	while(not _stopping.load())
+	{
+		sf::TcpSocket client;
+		if(not listenerSelector.wait(pollingTime) or _listener.accept(client) != sf::Socket::Done)
+			continue;
+		// the request is read (but not parsed), closing a socket with unread
+		// data would reset the connection before the response is read
+		sf::SocketSelector clientSelector;
+		clientSelector.add(client);
+		std::string request;
+		char buffer[1024];
+		std::size_t received;
+		while(request.find("\r\n\r\n") == std::string::npos and request.size() < 16 * sizeof(buffer)
+		      and clientSelector.wait(requestTimeout)
+		      and client.receive(buffer, sizeof(buffer), received) == sf::Socket::Done)
+			request.append(buffer, received);
+		const std::string body{display()};
+		const std::string response{"HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+				+ std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body};
+		if(client.send(response.data(), response.size()) != sf::Socket::Done)
+			std::cerr << "Unable to send the metrics\n";
+	}
+}
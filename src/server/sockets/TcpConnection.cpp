@@ -0,0 +1,215 @@
+// WizardPoker headers
+#include "server/TcpConnection.hpp"
+// std-C++ headers
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+// system headers
+#ifdef __linux__
+extern "C"
+{
+# include <sys/socket.h>
+# include <sys/uio.h>
+# include <netinet/in.h>
+# include <netinet/tcp.h>
+# include <arpa/inet.h>
+# include <poll.h>
+# include <limits.h>
+# include <errno.h>
+}
+#else
+# include <SFML/System/Sleep.hpp>
+#endif
+
+constexpr std::size_t TcpConnection::defaultSendQueueLimit;
+
+TcpConnection::TcpConnection(std::size_t sendQueueLimit):
+	sf::TcpSocket(),
+	_sendQueue(),
+	_frontOffset(0),
+	_pendingBytes(0),
+	_sendQueueLimit(sendQueueLimit)
+{
+}
+
+bool TcpConnection::enableKeepAlive(int idleSeconds, int intervalSeconds, int probes)
+{
+#ifdef __linux__
+	const int handle{getHandle()};
+	const int enabled{1};
+	return setsockopt(handle, SOL_SOCKET, SO_KEEPALIVE, &enabled, sizeof(enabled)) == 0
+	       and setsockopt(handle, IPPROTO_TCP, TCP_KEEPIDLE, &idleSeconds, sizeof(idleSeconds)) == 0
+	       and setsockopt(handle, IPPROTO_TCP, TCP_KEEPINTVL, &intervalSeconds, sizeof(intervalSeconds)) == 0
+	       and setsockopt(handle, IPPROTO_TCP, TCP_KEEPCNT, &probes, sizeof(probes)) == 0;
+#else
+	// The tuning options are not portable, let the system use its defaults
+	static_cast<void>(idleSeconds);
+	static_cast<void>(intervalSeconds);
+	static_cast<void>(probes);
+	return false;
+#endif
+}
+
+bool TcpConnection::setNoDelay(bool noDelay)
+{
+#ifdef __linux__
+	const int value{noDelay ? 1 : 0};
+	return setsockopt(getHandle(), IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) == 0;
+#else
+	static_cast<void>(noDelay);
+	return false;
+#endif
+}
+
+TcpConnection::Frame TcpConnection::makeFrame(const sf::Packet& packet)
+{
+	// Same framing as sf::TcpSocket: the size of the data in network byte order, then the data
+	const sf::Uint32 dataSize{static_cast<sf::Uint32>(packet.getDataSize())};
+	const unsigned char header[sizeof(sf::Uint32)] =
+	{
+		static_cast<unsigned char>((dataSize >> 24) & 0xFF),
+		static_cast<unsigned char>((dataSize >> 16) & 0xFF),
+		static_cast<unsigned char>((dataSize >> 8) & 0xFF),
+		static_cast<unsigned char>(dataSize & 0xFF)
+	};
+	std::shared_ptr<std::vector<char>> frame{std::make_shared<std::vector<char>>(sizeof(header) + dataSize)};
+	std::memcpy(frame->data(), header, sizeof(header));
+	if(dataSize > 0)
+		std::memcpy(frame->data() + sizeof(header), packet.getData(), dataSize);
+	return frame;
+}
+
+bool TcpConnection::queue(sf::Packet& packet)
+{
+	return queue(makeFrame(packet));
+}
+
+bool TcpConnection::queue(const Frame& frame)
+{
+	_pendingBytes += frame->size();
+	_sendQueue.push_back(frame);
+	return not isOverloaded();
+}
+
+void TcpConnection::dropUnsentFrames()
+{
+	const std::size_t keptFrames{_frontOffset > 0 ? 1U : 0U};
+	while(_sendQueue.size() > keptFrames)
+	{
+		_pendingBytes -= _sendQueue.back()->size();
+		_sendQueue.pop_back();
+	}
+}
+
+sf::Socket::Status TcpConnection::flush()
+{
+#ifdef __linux__
+	// The size of the stack array is known at compile time, IOV_MAX is 1024 on Linux
+	static constexpr std::size_t maxFramesPerCall{64};
+	static_assert(maxFramesPerCall <= IOV_MAX, "Too many frames for a single system call");
+	while(not _sendQueue.empty())
+	{
+		// gather the waiting frames to send them with one system call
+		iovec buffers[maxFramesPerCall];
+		std::size_t buffersCount{0};
+		for(auto it = _sendQueue.begin(); it != _sendQueue.end() and buffersCount < maxFramesPerCall; ++it, ++buffersCount)
+		{
+			const std::size_t offset{buffersCount == 0 ? _frontOffset : 0};
+			// sendmsg does not write in the buffers
+			buffers[buffersCount].iov_base = const_cast<char*>((*it)->data()) + offset;
+			buffers[buffersCount].iov_len = (*it)->size() - offset;
+		}
+		// sendmsg is writev with flags: never block, and never raise SIGPIPE
+		msghdr message;
+		std::memset(&message, 0, sizeof(message));
+		message.msg_iov = buffers;
+		message.msg_iovlen = buffersCount;
+		const ssize_t sent{sendmsg(getHandle(), &message, MSG_DONTWAIT | MSG_NOSIGNAL)};
+		if(sent < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			if(errno == EAGAIN or errno == EWOULDBLOCK)
+				return sf::Socket::Partial;
+			if(errno == EPIPE or errno == ECONNRESET or errno == ENOTCONN)
+				return sf::Socket::Disconnected;
+			return sf::Socket::Error;
+		}
+		consume(static_cast<std::size_t>(sent));
+	}
+	return sf::Socket::Done;
+#else
+	// No portable gathering write: send the frames one by one (blocking)
+	while(not _sendQueue.empty())
+	{
+		std::size_t sent{0};
+		const std::vector<char>& frame(*_sendQueue.front());
+		const sf::Socket::Status status{send(frame.data() + _frontOffset, frame.size() - _frontOffset, sent)};
+		consume(sent);
+		if(status != sf::Socket::Done and status != sf::Socket::Partial)
+			return status;
+	}
+	return sf::Socket::Done;
+#endif
+}
+
+sf::Socket::Status TcpConnection::flushAll(sf::Time timeout)
+{
+	// the peer that did not read what was sent before will not read this either
+	if(isOverloaded())
+		return sf::Socket::Error;
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(timeout.asMicroseconds());
+	sf::Socket::Status status;
+	while((status = flush()) == sf::Socket::Partial)
+	{
+		const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		if(remaining.count() <= 0)
+			return sf::Socket::Error;
+#ifdef __linux__
+		// wait until the peer read enough data
+		static constexpr int pollTimeoutMilliseconds{100};
+		pollfd descriptor;
+		descriptor.fd = getHandle();
+		descriptor.events = POLLOUT;
+		descriptor.revents = 0;
+		poll(&descriptor, 1, static_cast<int>(std::min<std::chrono::milliseconds::rep>(pollTimeoutMilliseconds, remaining.count())));
+#else
+		sf::sleep(sf::milliseconds(1));
+#endif
+	}
+	return status;
+}
+
+void TcpConnection::clearQueue()
+{
+	_sendQueue.clear();
+	_frontOffset = 0;
+	_pendingBytes = 0;
+}
+
+bool TcpConnection::hasPendingData() const
+{
+	return _pendingBytes > 0;
+}
+
+bool TcpConnection::isOverloaded() const
+{
+	return _pendingBytes > _sendQueueLimit;
+}
+
+void TcpConnection::consume(std::size_t sent)
+{
+	_pendingBytes -= sent;
+	while(sent > 0)
+	{
+		const std::size_t frontRemaining{_sendQueue.front()->size() - _frontOffset};
+		if(sent < frontRemaining)
+		{
+			_frontOffset += sent;
+			return;
+		}
+		sent -= frontRemaining;
+		_sendQueue.pop_front();
+		_frontOffset = 0;
+	}
+}
@@ -0,0 +1,190 @@
+/**
+	tests of Constraints: the timed values are stored inline up to a capacity,
+	a Constraints that holds more of them must keep them all. The memoized
+	results must follow the VALUE_GET_* options and the states of the casters.
+	Run from the bin directory, for the database of the server.
+**/
+
+// WizardPoker headers
+#include "server/Constraints.hpp"
+#include "server/GameSimulation.hpp"
+#include "server/ServerDatabase.hpp"
+#include "server/ServerCardData.hpp"
+#include "server/CardArena.hpp"
+#include "server/Creature.hpp"
+#include "server/Player.hpp"
+#include "server/PostGameData.hpp"
+// std-C++ headers
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdlib>
+
+static int failures{0};
+
+/// Reports a failure if \a actual is not \a expected
+static void check(const std::string& what, int actual, int expected)
+{
+	if(actual == expected)
+		return;
+	std::cerr << "FAILED: " << what << ": " << actual << " instead of " << expected << "\n";
+	++failures;
+}
+
+/// No value is dropped when there are more values than the inline capacity
+static void testTimedValuesSurviveOverflow()
+{
+	Constraints::CasterVersion casterVersion{0};
+	Constraints constraints(playerDefaultConstraints, casterVersion);
+	const int count{2 * static_cast<int>(Constraints::capacity)};
+	constraints.setConstraint(PC_TEMP_CARD_USE_LIMIT, 3, 0);
+	for(int i{0}; i < count; ++i)
+		constraints.setConstraint(PC_TURN_ENERGY_CHANGE, 1, 5);
+	constraints.setConstraint(PC_TURN_HEALTH_CHANGE, 1, 2);
+	check("energy change after an overflow", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), count);
+	check("permanent value after an overflow", constraints.getConstraint(PC_TEMP_CARD_USE_LIMIT), 3);
+	check("expiring value after an overflow", constraints.getConstraint(PC_TURN_HEALTH_CHANGE), 1);
+
+	// the values still time out in their order
+	constraints.timeOutConstraints();
+	check("expiring value after a turn", constraints.getConstraint(PC_TURN_HEALTH_CHANGE), 1);
+	constraints.timeOutConstraints();
+	check("expiring value after it expired", constraints.getConstraint(PC_TURN_HEALTH_CHANGE), 0);
+	check("energy change before it expired", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), count);
+	for(int turn{0}; turn < 3; ++turn)
+		constraints.timeOutConstraints();
+	check("energy change after it expired", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), 0);
+	check("permanent value after the timed ones", constraints.getConstraint(PC_TEMP_CARD_USE_LIMIT), 3);
+}
+
+/// A new value is set even if all the values are permanent
+static void testPermanentValuesOverflow()
+{
+	Constraints::CasterVersion casterVersion{0};
+	Constraints constraints(playerDefaultConstraints, casterVersion);
+	const int count{2 * static_cast<int>(Constraints::capacity)};
+	for(int i{0}; i < count; ++i)
+		constraints.setConstraint(PC_TURN_ENERGY_CHANGE, 1, 0);
+	constraints.setConstraint(PC_TEMP_CARD_USE_LIMIT, 3, 2);
+	check("permanent values after an overflow", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), count);
+	check("value set after permanent values", constraints.getConstraint(PC_TEMP_CARD_USE_LIMIT), 3);
+}
+
+/// A snapshot holds the values up to the inline capacity only, the values
+/// are saved again once they fit
+static void testSnapshotAfterOverflow()
+{
+	Constraints::CasterVersion casterVersion{0};
+	Constraints constraints(playerDefaultConstraints, casterVersion);
+	const std::vector<const Creature*> casters;
+	Constraints::Snapshot snapshot;
+	for(std::size_t i{0}; i < Constraints::capacity; ++i)
+		constraints.setConstraint(PC_TURN_ENERGY_CHANGE, 1, 1);
+	constraints.setConstraint(PC_TURN_HEALTH_CHANGE, 2, 3);
+	bool isRefused{false};
+	try
+	{
+		constraints.save(snapshot, casters);
+	}
+	catch(const std::runtime_error&)
+	{
+		isRefused = true;
+	}
+	check("snapshot of too many values refused", isRefused, true);
+
+	constraints.timeOutConstraints();
+	constraints.save(snapshot, casters);
+	Constraints loaded(playerDefaultConstraints, casterVersion);
+	loaded.load(snapshot, casters);
+	check("loaded energy change", loaded.getConstraint(PC_TURN_ENERGY_CHANGE), 0);
+	check("loaded health change", loaded.getConstraint(PC_TURN_HEALTH_CHANGE), 2);
+	loaded.timeOutConstraints();
+	loaded.timeOutConstraints();
+	check("loaded health change after it expired", loaded.getConstraint(PC_TURN_HEALTH_CHANGE), 0);
+}
+
+/// A value with a VALUE_GET_* option changes at each read, it is never memoized
+static void testGetDecrementNotMemoized()
+{
+	Constraints::CasterVersion casterVersion{0};
+	Constraints constraints(creatureDefaultConstraints, casterVersion);
+	constraints.setConstraint(CC_TEMP_FORCE_ATTACKS, 2, 0);
+	constraints.setConstraint(CC_TURN_ATTACK_CHANGE, 1, 0);
+	check("first forced attack", constraints.getConstraint(CC_TEMP_FORCE_ATTACKS), 2);
+	// a memoized read in between does not freeze the decremented value
+	check("memoized attack change", constraints.getConstraint(CC_TURN_ATTACK_CHANGE), 1);
+	check("second forced attack", constraints.getConstraint(CC_TEMP_FORCE_ATTACKS), 1);
+	check("memoized attack change again", constraints.getConstraint(CC_TURN_ATTACK_CHANGE), 1);
+	check("third forced attack", constraints.getConstraint(CC_TEMP_FORCE_ATTACKS), 0);
+}
+
+/// Two players out of any game, to own the caster
+struct TestPlayers
+{
+	PostGameData postGameData1;
+	PostGameData postGameData2;
+	CardArena cards;
+	Player player1;
+	Player player2;
+
+	TestPlayers(GameContext& game, ServerDatabase& database):
+		postGameData1(),
+		postGameData2(),
+		cards(1),
+		player1(game, database, cards, 1, player2, postGameData1),
+		player2(game, database, cards, 2, player1, postGameData2)
+	{
+	}
+};
+
+/// A value casted by a creature is active while its caster is on the board
+/// or not paralyzed, the memoized value follows the caster
+static void testCasterParalysis(ServerDatabase& database)
+{
+	GameSimulation game(database, 0);
+	TestPlayers players(game, database);
+	const ServerCreatureData data(1, 0, {}, 1, 1, 0, 0);
+	Creature* caster{players.cards.createCreature(data, players.player1)};
+	Constraints constraints(playerDefaultConstraints, game.getCasterVersion());
+	const CardEffects paralysis(0, true, {{CREATURE_SELF_THIS, CE_SET_CONSTRAINT, CC_TEMP_IS_PARALYZED, 1, 1, NO_CASTER_NEEDED}});
+
+	caster->moveToBoard(players.player1);
+	constraints.setConstraint(PC_TURN_ENERGY_CHANGE, 3, 0, caster);
+	check("value of a caster on the board", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), 3);
+	caster->removeFromBoard();
+	check("value of an active caster out of the board", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), 3);
+	for(const CardEffect& effect : paralysis)
+		caster->applyEffectToSelf(effect);
+	check("value of a paralyzed caster out of the board", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), 0);
+	// the paralysis lasts one turn
+	caster->leaveTurn();
+	check("value of a caster whose paralysis expired", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), 3);
+	for(const CardEffect& effect : paralysis)
+		caster->applyEffectToSelf(effect);
+	check("value of a paralyzed caster again", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), 0);
+	caster->moveToBoard(players.player1);
+	check("value of a paralyzed caster back on the board", constraints.getConstraint(PC_TURN_ENERGY_CHANGE), 3);
+}
+
+int main()
+{
+	testTimedValuesSurviveOverflow();
+	testPermanentValuesOverflow();
+	testSnapshotAfterOverflow();
+	testGetDecrementNotMemoized();
+	try
+	{
+		ServerDatabase database;
+		testCasterParalysis(database);
+	}
+	catch(const std::runtime_error& e)
+	{
+		std::cerr << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+	if(failures > 0)
+		return EXIT_FAILURE;
+	std::cout << "Constraints: all tests passed\n";
+	return EXIT_SUCCESS;
+}